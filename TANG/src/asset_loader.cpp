@@ -1,8 +1,14 @@
 
 #include "asset_loader.h"
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <limits>
 
 // Silence stb_image warnings:
 // warning C4244: 'argument': conversion from 'int' to 'short', possible loss of data
@@ -14,10 +20,20 @@
 
 #pragma warning(pop)
 
+#include <glm/packing.hpp>
+
 #include "assimp/scene.h"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
+#include "asset_serializer.h"
+#include "async_asset_loader.h"
 #include "config.h"
+#include "default_material.h"
+#include "device_cache.h"
+#include "mesh_utils.h"
+#include "texture_compression.h"
+#include "texture_registry.h"
+#include "utils/file_utils.h"
 #include "utils/logger.h"
 #include "utils/sanity_check.h"
 
@@ -59,6 +75,73 @@ namespace TANG
 		}
 	}
 
+	// Octahedral encoding of a unit vector into the [-1, 1] square, see "A Survey of Efficient Representations for Independent Unit Vectors" (Cigolle et al.)
+	static glm::vec2 EncodeOctahedral(glm::vec3 v)
+	{
+		v /= (fabs(v.x) + fabs(v.y) + fabs(v.z));
+
+		glm::vec2 encoded(v.x, v.y);
+		if (v.z < 0.0f)
+		{
+			encoded.x = (1.0f - fabs(v.y)) * (v.x >= 0.0f ? 1.0f : -1.0f);
+			encoded.y = (1.0f - fabs(v.x)) * (v.y >= 0.0f ? 1.0f : -1.0f);
+		}
+
+		return encoded;
+	}
+
+	static int16_t QuantizeSnorm16(float value)
+	{
+		return static_cast<int16_t>(roundf(glm::clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	static uint32_t PackSnorm16x2(int16_t x, int16_t y)
+	{
+		return static_cast<uint32_t>(static_cast<uint16_t>(x)) | (static_cast<uint32_t>(static_cast<uint16_t>(y)) << 16);
+	}
+
+	// PACKED PBR VERTEX
+	template<>
+	void LoadMeshVertices<TANG::PackedPBRVertex>(const aiMesh* importedMesh, TANG::Mesh<TANG::PackedPBRVertex>* mesh)
+	{
+		uint32_t vertexCount = importedMesh->mNumVertices;
+
+		for (uint32_t j = 0; j < vertexCount; j++)
+		{
+			const aiVector3D& importedPos = importedMesh->mVertices[j];
+			const aiVector3D& importedNormal = importedMesh->mNormals[j];
+			const aiVector3D& importedTangent = importedMesh->mTangents[j];
+			const aiVector3D& importedBitangent = importedMesh->mBitangents[j];
+			const aiVector3D& importedUVs = importedMesh->HasTextureCoords(0) ? importedMesh->mTextureCoords[0][j] : aiVector3D(0, 0, 0);
+
+			glm::vec3 normal(importedNormal.x, importedNormal.y, importedNormal.z);
+			glm::vec3 tangent(importedTangent.x, importedTangent.y, importedTangent.z);
+			glm::vec3 bitangent(importedBitangent.x, importedBitangent.y, importedBitangent.z);
+
+			// Degenerate vectors can't be encoded, so we fall back to an arbitrary (but valid) direction
+			if (glm::dot(normal, normal) == 0.0f) normal = glm::vec3(0.0f, 0.0f, 1.0f);
+			if (glm::dot(tangent, tangent) == 0.0f) tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+
+			float bitangentSign = glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+
+			glm::vec2 encodedNormal = EncodeOctahedral(normal);
+			glm::vec2 encodedTangent = EncodeOctahedral(tangent);
+
+			// Remap the tangent's Y to (0, 1] so the sign of the bitangent can be stored in it without being lost at zero
+			int16_t tangentY = QuantizeSnorm16(encodedTangent.y * 0.5f + 0.5f);
+			if (tangentY < 1) tangentY = 1;
+			tangentY = static_cast<int16_t>(tangentY * static_cast<int16_t>(bitangentSign));
+
+			TANG::PackedPBRVertex vertex{};
+			vertex.pos = { importedPos.x, importedPos.y, importedPos.z };
+			vertex.normal = PackSnorm16x2(QuantizeSnorm16(encodedNormal.x), QuantizeSnorm16(encodedNormal.y));
+			vertex.tangent = PackSnorm16x2(QuantizeSnorm16(encodedTangent.x), tangentY);
+			vertex.uv = glm::packHalf2x16(glm::vec2(importedUVs.x, importedUVs.y));
+
+			mesh->vertices[j] = vertex;
+		}
+	}
+
 	// CUBEMAP VERTEX
 	template<> 
 	void LoadMeshVertices<TANG::CubemapVertex>(const aiMesh* importedMesh, TANG::Mesh<TANG::CubemapVertex>* mesh)
@@ -94,14 +177,14 @@ namespace TANG
 		}
 	}
 
+	// Loads a single imported mesh, and merges it's duplicate vertices
 	template<typename T>
-	void LoadMesh(const aiMesh* importedMesh, TANG::AssetDisk* asset)
+	void LoadSubmesh(const aiMesh* importedMesh, TANG::Mesh<T>* mesh)
 	{
 		uint32_t faceCount = importedMesh->mNumFaces;
 
-		TANG::Mesh<T>* mesh = new TANG::Mesh<T>();
 		mesh->vertices.resize(importedMesh->mNumVertices);
-		mesh->indices.resize(faceCount * 3);
+		mesh->indices.reserve(faceCount * 3);
 
 		// VERTICES
 		LoadMeshVertices<T>(importedMesh, mesh);
@@ -109,14 +192,69 @@ namespace TANG
 		// INDICES
 		for (uint32_t j = 0; j < faceCount; j++)
 		{
-			uint32_t indexCount = j * 3;
 			const aiFace& importedFace = importedMesh->mFaces[j];
 
-			mesh->indices[indexCount    ] = importedFace.mIndices[0];
-			mesh->indices[indexCount + 1] = importedFace.mIndices[1];
-			mesh->indices[indexCount + 2] = importedFace.mIndices[2];
+			// Triangulation leaves point and line primitives untouched, and we can't draw those
+			if (importedFace.mNumIndices != 3)
+			{
+				continue;
+			}
+
+			mesh->indices.push_back(importedFace.mIndices[0]);
+			mesh->indices.push_back(importedFace.mIndices[1]);
+			mesh->indices.push_back(importedFace.mIndices[2]);
+		}
+
+		// The imported meshes are effectively unindexed (assimp's JoinIdenticalVertices step is disabled), so we merge the duplicate vertices ourselves
+		uint32_t originalVertexCount = static_cast<uint32_t>(mesh->vertices.size());
+		uint32_t weldedVertexCount = MeshUtils::WeldVertices(mesh, CONFIG::VertexWeldEpsilon);
+		if (weldedVertexCount > 0)
+		{
+			LogInfo("Welded %u of %u vertices (%u remaining)", weldedVertexCount, originalVertexCount, originalVertexCount - weldedVertexCount);
+		}
+
+		// Reorder the triangles and vertices for the post-transform cache and vertex fetch. The result is stored in the TASSET
+		// file, so this is only ever done once per asset
+		if (CONFIG::OptimizeMeshesOnImport)
+		{
+			MeshUtils::OptimizeMesh(mesh, CONFIG::VertexCacheSize);
+		}
+	}
+
+	// Loads every mesh in the scene as a submesh of a single mesh, so the whole asset shares one vertex and index allocation.
+	// The scene must be imported with aiProcess_PreTransformVertices, so the node transforms are already baked into the meshes and
+	// meshes referenced by several nodes have been duplicated
+	template<typename T>
+	void LoadMesh(const aiScene* scene, TANG::AssetDisk* asset)
+	{
+		TANG::Mesh<T>* mesh = new TANG::Mesh<T>();
+
+		for (uint32_t i = 0; i < scene->mNumMeshes; i++)
+		{
+			const aiMesh* importedMesh = scene->mMeshes[i];
+			if ((importedMesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE) == 0)
+			{
+				LogWarning("Skipping mesh '%s' in asset '%s', it has no triangles!", importedMesh->mName.C_Str(), asset->name.c_str());
+				continue;
+			}
+
+			TANG::Mesh<T> submeshData;
+			LoadSubmesh(importedMesh, &submeshData);
+
+			TANG::Submesh submesh;
+			submesh.firstIndex = static_cast<uint32_t>(mesh->indices.size());
+			submesh.indexCount = static_cast<uint32_t>(submeshData.indices.size());
+			submesh.vertexOffset = static_cast<int32_t>(mesh->vertices.size());
+			submesh.materialIndex = importedMesh->mMaterialIndex;
+
+			mesh->vertices.insert(mesh->vertices.end(), submeshData.vertices.begin(), submeshData.vertices.end());
+			mesh->indices.insert(mesh->indices.end(), submeshData.indices.begin(), submeshData.indices.end());
+			mesh->submeshes.push_back(submesh);
 		}
 
+		// The bounds are stored in the TASSET file, so they're only ever calculated once per asset
+		mesh->bounds = MeshUtils::CalculateBounds(mesh);
+
 		// Store the mesh pointer in the asset
 		asset->mesh = mesh;
 	}
@@ -193,171 +331,849 @@ namespace TANG
 		return container.begin()->second;
 	}
 
+	void AssetContainer::ForEachAsset(const std::function<void(const AssetDisk*)>& func) const
+	{
+		for (const auto& iter : container)
+		{
+			func(iter.second);
+		}
+	}
+
 	//////////////////////////////////////////////////////////////////
 	//
 	//	LOADER UTILS
 	//
 	//////////////////////////////////////////////////////////////////
 
-	namespace LoaderUtils
+	// Copies the compressed image into the texture, which takes ownership of the copy
+	static void SetTextureData(Texture* tex, const CompressedImage& image)
 	{
-		AssetDisk* Load(std::string_view filePath)
+		char* data = new char[image.data.size()];
+		memcpy(data, image.data.data(), image.data.size());
+
+		tex->data = data;
+		tex->dataSize = image.data.size();
+		tex->size = { image.width, image.height };
+		tex->bytesPerPixel = 0;
+		tex->format = image.format;
+		tex->mipOffsets = image.mipOffsets;
+	}
+
+	// Decodes the image at the provided path using stb_image. The data is always expanded to RGBA8
+	static bool DecodeImage(const std::string& filePath, std::vector<uint8_t>& outPixels, uint32_t& outWidth, uint32_t& outHeight)
+	{
+		int width, height, channels;
+		stbi_uc* pixels = stbi_load(filePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (pixels == nullptr)
 		{
-			LogInfo("Starting asset load for '%s'", filePath.data());
+			return false;
+		}
 
-			Assimp::Importer importer;
-#if defined(FAST_IMPORT)
-			uint32_t importFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
-#else
-			uint32_t importFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_FixInfacingNormals | aiProcess_FindInvalidData;
-#endif
-			const aiScene* scene = importer.ReadFile(filePath.data(), importFlags);
+		outPixels.assign(pixels, pixels + static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * 4);
+		outWidth = static_cast<uint32_t>(width);
+		outHeight = static_cast<uint32_t>(height);
 
-			if (scene == nullptr || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) == 1 || scene->mRootNode == nullptr)
+		stbi_image_free(pixels);
+		return true;
+	}
+
+	// Converts the RGBA8 pixels into the provided format. Block-compressed formats are encoded including their full mip chain, and
+	// the result is written to the TTEX cache (using the texture's content hash) so the encoding only ever happens once. Non-compressed
+	// formats only keep as many channels as the format has, without any mips. The texture's content hash must already be set
+	static bool SetTextureFromPixels(Texture* tex, const uint8_t* pixels, uint32_t width, uint32_t height, VkFormat format, const std::string& cacheName)
+	{
+		if (TextureCompression::IsBlockCompressed(format))
+		{
+			CompressedImage image;
+			if (!TextureCompression::CompressImage(pixels, width, height, format, true, image, &AsyncAssetLoader::GetInstance().GetThreadPool()))
 			{
-				LogWarning(importer.GetErrorString());
-				return nullptr;
+				return false;
 			}
 
-			uint32_t numMeshes = scene->mNumMeshes;
-			uint32_t numTextures = scene->mNumTextures;
-			uint32_t numMaterials = scene->mNumMaterials;
+			SetTextureData(tex, image);
 
-			// Check that we have at least one mesh, and warn if we have have more than one mesh
-			if (numMeshes < 1)
+			if (!SerializerUtils::SerializeTexture(tex, cacheName))
 			{
-				LogError("Failed to load asset from file '%s'! At least one mesh is required", filePath.data());
-				return nullptr;
+				LogWarning("Failed to write texture cache for '%s', the texture will be compressed again next time", cacheName.c_str());
 			}
-			else if (numMeshes > 1)
+
+			return true;
+		}
+
+		uint32_t channelCount = TextureCompression::GetChannelCount(format);
+		uint64_t texelCount = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+		uint64_t numBytes = texelCount * channelCount;
+
+		char* data = new char[numBytes];
+		for (uint64_t i = 0; i < texelCount; i++)
+		{
+			memcpy(data + i * channelCount, pixels + i * 4, channelCount);
+		}
+
+		tex->data = data;
+		tex->dataSize = numBytes;
+		tex->size = { width, height }; // NOTE - We don't support 3D textures!
+		tex->bytesPerPixel = channelCount;
+		tex->format = format;
+		tex->mipOffsets = { 0 };
+
+		return true;
+	}
+
+	// Decodes the HDR image at the provided path and encodes it to BC6H. Just like SetTextureFromPixels(), the result is written to the TTEX cache
+	static bool SetTextureFromHDRFile(Texture* tex, const std::string& filePath)
+	{
+		int width, height, channels;
+		float* pixels = stbi_loadf(filePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (pixels == nullptr)
+		{
+			return false;
+		}
+
+		CompressedImage image;
+		bool compressed = TextureCompression::CompressHDRImage(pixels, width, height, false, image, &AsyncAssetLoader::GetInstance().GetThreadPool());
+		stbi_image_free(pixels);
+
+		if (!compressed)
+		{
+			return false;
+		}
+
+		SetTextureData(tex, image);
+
+		if (!SerializerUtils::SerializeTexture(tex, filePath))
+		{
+			LogWarning("Failed to write texture cache for '%s', the texture will be compressed again next time", filePath.c_str());
+		}
+
+		return true;
+	}
+
+	// Loads the image at the provided path in the provided format, either from it's TTEX cache or by decoding (and possibly
+	// compressing) the source image. Images are identified by their contents, so if the same image was already loaded in the
+	// same format (possibly from a different file path) we simply take another reference to it through the texture registry
+	static Texture* LoadTextureFromFile(const std::string& filePath, VkFormat format)
+	{
+		uint64_t contentHash = FileContentHash(filePath);
+		if (contentHash == 0)
+		{
+			LogError("Failed to load texture! '%s'", filePath.c_str());
+			return nullptr;
+		}
+
+		TextureRegistry& registry = TextureRegistry::GetInstance();
+
+		Texture* existing = registry.AcquireTexture(contentHash, format);
+		if (existing != nullptr)
+		{
+			LogInfo("Reusing previously decoded texture '%s' for '%s'", existing->fileName.c_str(), filePath.c_str());
+			return existing;
+		}
+
+		Texture* tex = new Texture();
+		tex->fileName = filePath;
+		tex->contentHash = contentHash;
+
+		bool loaded = false;
+		if (TextureCompression::IsBlockCompressed(format) && SerializerUtils::DeserializeTexture(filePath, format, contentHash, tex))
+		{
+			loaded = true;
+		}
+		else if (format == VK_FORMAT_BC6H_UFLOAT_BLOCK)
+		{
+			loaded = SetTextureFromHDRFile(tex, filePath);
+		}
+		else
+		{
+			std::vector<uint8_t> pixels;
+			uint32_t width, height;
+			loaded = DecodeImage(filePath, pixels, width, height) && SetTextureFromPixels(tex, pixels.data(), width, height, format, filePath);
+		}
+
+		if (!loaded)
+		{
+			LogError("Failed to load texture! '%s'", filePath.c_str());
+			delete tex;
+			return nullptr;
+		}
+
+		return registry.InsertTexture(tex);
+	}
+
+	// Source images of a packed ORM texture, indexed by the channel they end up in. Every channel is read from the same channel of
+	// it's source image, which works both for grayscale images and for images that are already packed (such as glTF metallic-roughness
+	// maps, which store roughness in G and metallic in B). Channels without a source use the default material's value instead
+	struct ORMSources
+	{
+		std::array<std::string, 3> paths;	// Occlusion, roughness and metallic
+	};
+
+	static uint64_t HashCombine(uint64_t seed, uint64_t value)
+	{
+		return seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+	}
+
+	// Packs the source images into a single RGBA8 image, the size of the largest source. Smaller sources are sampled with nearest filtering
+	static bool PackORMImage(const ORMSources& sources, std::vector<uint8_t>& outPixels, uint32_t& outWidth, uint32_t& outHeight)
+	{
+		struct SourceImage
+		{
+			std::vector<uint8_t> pixels;
+			uint32_t width = 0;
+			uint32_t height = 0;
+		};
+
+		const uint32_t defaultValue = DEFAULT_MATERIAL.at(Material::TEXTURE_TYPE::ORM);
+
+		// Sources are commonly shared between channels, so every unique source is only decoded once
+		std::array<SourceImage, 3> images;
+		std::array<int32_t, 3> channelImages = { -1, -1, -1 };
+
+		outWidth = 1;
+		outHeight = 1;
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			const std::string& path = sources.paths[c];
+			if (path.empty()) continue;
+
+			for (uint32_t prev = 0; prev < c; prev++)
 			{
-				LogWarning("Multiple meshes detected for asset '%s', but multiple meshes are not supported!", filePath.data());
+				if (sources.paths[prev] == path)
+				{
+					channelImages[c] = channelImages[prev];
+					break;
+				}
 			}
 
-			// Now we can create the Asset instance
-			AssetDisk* asset = new AssetDisk();
-			asset->textures.resize(numTextures);
-			asset->materials.resize(numMaterials);
+			if (channelImages[c] >= 0) continue;
+
+			SourceImage& image = images[c];
+			if (!DecodeImage(path, image.pixels, image.width, image.height))
+			{
+				LogError("Failed to load packed texture source! '%s'", path.c_str());
+				return false;
+			}
 
-			// Load the mesh
-			// NOTE - Only one mesh per asset is supported currently
-			aiMesh* importedMesh = scene->mMeshes[0];
+			channelImages[c] = static_cast<int32_t>(c);
+			outWidth = std::max(outWidth, image.width);
+			outHeight = std::max(outHeight, image.height);
+		}
 
-			// Determine the mesh type
-			// TODO - Find a better way to do this
-			if (filePath == CONFIG::SkyboxCubeMeshFilePath)
+		outPixels.resize(static_cast<uint64_t>(outWidth) * outHeight * 4);
+		for (uint32_t y = 0; y < outHeight; y++)
+		{
+			for (uint32_t x = 0; x < outWidth; x++)
 			{
-				LoadMesh<CubemapVertex>(importedMesh, asset);
-				LogInfo("Loaded mesh using CubemapVertex for asset '%s'", filePath.data());
+				uint8_t* texel = outPixels.data() + (static_cast<uint64_t>(y) * outWidth + x) * 4;
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					if (channelImages[c] < 0)
+					{
+						texel[c] = static_cast<uint8_t>((defaultValue >> (c * 8)) & 0xFF);
+						continue;
+					}
+
+					const SourceImage& image = images[channelImages[c]];
+					uint64_t sourceX = static_cast<uint64_t>(x) * image.width / outWidth;
+					uint64_t sourceY = static_cast<uint64_t>(y) * image.height / outHeight;
+					texel[c] = image.pixels[(sourceY * image.width + sourceX) * 4 + c];
+				}
+
+				texel[3] = 0xFF;
 			}
-			else if (filePath == CONFIG::FullscreenQuadMeshFilePath)
+		}
+
+		return true;
+	}
+
+	// Loads the packed ORM texture built from the provided sources in the provided format. If all three channels come from the same
+	// image it's already packed, so it's loaded like any other texture. Otherwise the content hash is derived from the contents of every
+	// source, so packed textures are shared and cached just like regular ones
+	static Texture* LoadPackedORMTexture(const ORMSources& sources, VkFormat format)
+	{
+		if (!sources.paths[0].empty() && sources.paths[0] == sources.paths[1] && sources.paths[0] == sources.paths[2])
+		{
+			return LoadTextureFromFile(sources.paths[0], format);
+		}
+
+		uint64_t contentHash = 0;
+		std::string cacheName;
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			const std::string& path = sources.paths[c];
+
+			uint64_t channelHash = 0;
+			if (!path.empty())
 			{
-				LoadMesh<UVVertex>(importedMesh, asset);
-				LogInfo("Loaded mesh using UVVertex for asset '%s'", filePath.data());
+				channelHash = FileContentHash(path);
+				if (channelHash == 0)
+				{
+					LogError("Failed to load packed texture source! '%s'", path.c_str());
+					return nullptr;
+				}
+
+				if (cacheName.empty()) cacheName = path + ".orm";
 			}
-			else
+
+			contentHash = HashCombine(contentHash, HashCombine(channelHash, c));
+		}
+
+		TNG_ASSERT_MSG(!cacheName.empty(), "Attempting to load packed ORM texture without any sources!");
+
+		TextureRegistry& registry = TextureRegistry::GetInstance();
+
+		Texture* existing = registry.AcquireTexture(contentHash, format);
+		if (existing != nullptr)
+		{
+			return existing;
+		}
+
+		Texture* tex = new Texture();
+		tex->fileName = cacheName;
+		tex->contentHash = contentHash;
+
+		bool loaded = false;
+		if (TextureCompression::IsBlockCompressed(format) && SerializerUtils::DeserializeTexture(cacheName, format, contentHash, tex))
+		{
+			loaded = true;
+		}
+		else
+		{
+			std::vector<uint8_t> pixels;
+			uint32_t width, height;
+			loaded = PackORMImage(sources, pixels, width, height) && SetTextureFromPixels(tex, pixels.data(), width, height, format, cacheName);
+		}
+
+		if (!loaded)
+		{
+			LogError("Failed to build packed texture '%s'!", cacheName.c_str());
+			delete tex;
+			return nullptr;
+		}
+
+		return registry.InsertTexture(tex);
+	}
+
+	// Returns whether the image is already packed as occlusion/roughness/metallic, based on the naming convention most texture libraries
+	// use (for example "brass_vase_03_arm_4k.jpg"), where the name contains an "arm" or "orm" segment
+	static bool IsPackedORMFileName(const std::filesystem::path& filePath)
+	{
+		std::string stem = filePath.stem().string();
+		std::transform(stem.begin(), stem.end(), stem.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		size_t start = 0;
+		while (start <= stem.size())
+		{
+			size_t end = stem.find_first_of("_-. ", start);
+			if (end == std::string::npos) end = stem.size();
+
+			std::string_view segment(stem.data() + start, end - start);
+			if (segment == "arm" || segment == "orm")
 			{
-				LoadMesh<PBRVertex>(importedMesh, asset);
-				LogInfo("Loaded mesh using PBRVertex for asset '%s'", filePath.data());
+				return true;
+			}
 
-				// Load the standalone texture(s)
-				for (uint32_t i = 0; i < numTextures; i++)
+			start = end + 1;
+		}
+
+		return false;
+	}
+
+	// Describes a single texture that must be decoded for a material slot. The jobs are decoded in parallel, but the results
+	// are always attached to their materials in the order the jobs were created so the outcome doesn't depend on thread timing.
+	// Packed ORM textures have no file path, they're built from their ORM sources instead
+	struct TextureDecodeJob
+	{
+		uint32_t materialIndex;
+		Material::TEXTURE_TYPE type;
+		std::string filePath;
+		ORMSources ormSources;
+		Texture* result;
+	};
+
+	// Creates the decode jobs for all the textures of the provided material descriptions. The occlusion, roughness and metallic
+	// textures are never decoded on their own, they're packed into a single ORM texture instead
+	static std::vector<TextureDecodeJob> CreateDecodeJobs(const std::vector<TAssetMaterial>& materials)
+	{
+		std::vector<TextureDecodeJob> jobs;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(materials.size()); i++)
+		{
+			const TAssetMaterial& material = materials[i];
+
+			for (uint32_t j = 0; j < static_cast<uint32_t>(Material::TEXTURE_TYPE::_COUNT); j++)
+			{
+				Material::TEXTURE_TYPE type = static_cast<Material::TEXTURE_TYPE>(j);
+				if (type == Material::TEXTURE_TYPE::AMBIENT_OCCLUSION || type == Material::TEXTURE_TYPE::ROUGHNESS || type == Material::TEXTURE_TYPE::METALLIC)
 				{
-					aiTexture* importedTexture = scene->mTextures[i];
-
-					Texture& texture = asset->textures[i];
-					texture.size = { importedTexture->mWidth, importedTexture->mHeight };
-
-					// Populate the texture data. Note from the assimp implementation:
-					// The format of the data from the imported texture is always ARGB8888, meaning it's 32-bit aligned
-					uint32_t texelSize = static_cast<uint32_t>(texture.size.x) * static_cast<uint32_t>(texture.size.y);
-					uint64_t numBytes = texelSize * 4;
-					char* data = new char[numBytes];
-					memcpy(data, importedTexture->pcData, numBytes);
-					texture.data = data;
+					continue;
 				}
 
-				// Load the materials
-				for (uint32_t i = 0; i < numMaterials; i++)
+				const std::string& texturePath = material.texturePaths[j];
+				if (type == Material::TEXTURE_TYPE::ORM && texturePath.empty())
 				{
-					Material& currentMaterial = asset->materials[i];
+					ORMSources sources;
+					sources.paths[0] = material.texturePaths[static_cast<uint32_t>(Material::TEXTURE_TYPE::AMBIENT_OCCLUSION)];
+					sources.paths[1] = material.texturePaths[static_cast<uint32_t>(Material::TEXTURE_TYPE::ROUGHNESS)];
+					sources.paths[2] = material.texturePaths[static_cast<uint32_t>(Material::TEXTURE_TYPE::METALLIC)];
+
+					if (!sources.paths[0].empty() || !sources.paths[1].empty() || !sources.paths[2].empty())
+					{
+						jobs.push_back({ i, type, std::string(), sources, nullptr });
+					}
+
+					continue;
+				}
+
+				if (texturePath.empty()) continue;
+
+				jobs.push_back({ i, type, texturePath, ORMSources(), nullptr });
+			}
+		}
+
+		return jobs;
+	}
+
+	// Per-asset timing breakdown, logged once the asset finishes loading
+	struct LoadTimings
+	{
+		double meshMs = 0.0;
+		double textureMs = 0.0;
+		uint32_t textureCount = 0;
+	};
+
+	static double GetElapsedMs(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	// Decodes all the textures on the asset loader thread pool, and attaches them to their material slots
+	static void DecodeMaterialTextures(std::vector<TextureDecodeJob>& jobs, std::vector<Material>& materials, LoadTimings& timings)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		ThreadPool& threadPool = AsyncAssetLoader::GetInstance().GetThreadPool();
+		ThreadPool::JobGroup jobGroup = threadPool.CreateJobGroup();
 
-					aiMaterial* currentAIMaterial = scene->mMaterials[i];
-					aiString matName = currentAIMaterial->GetName();
+		std::vector<std::future<void>> futures;
+		futures.reserve(jobs.size());
+		for (TextureDecodeJob& job : jobs)
+		{
+			futures.push_back(threadPool.Submit([&job]()
+			{
+				VkFormat format = LoaderUtils::GetMaterialTextureFormat(job.type);
+				job.result = job.filePath.empty() ? LoadPackedORMTexture(job.ormSources, format) : LoadTextureFromFile(job.filePath, format);
+			}, jobGroup));
+		}
 
-					currentMaterial.SetName(std::string(matName.C_Str()));
+		for (std::future<void>& future : futures)
+		{
+			threadPool.Wait(future, jobGroup);
+		}
+
+		for (TextureDecodeJob& job : jobs)
+		{
+			if (job.result == nullptr) continue;
 
-					// Get all the supported textures
-					for (const auto& aiType : SupportedTextureTypes)
+			materials[job.materialIndex].AddTextureOfType(job.type, job.result);
+
+			LogInfo("\tMaterial %u: Loaded %s texture '%s' from disk",
+				job.materialIndex,
+				TextureTypeToString.at(job.type).c_str(),
+				job.result->fileName.c_str()
+			);
+
+			timings.textureCount++;
+		}
+
+		timings.textureMs = GetElapsedMs(start);
+	}
+
+	// Determine the mesh type
+	// TODO - Find a better way to do this
+	static TAssetVertexType GetVertexTypeFromFilePath(std::string_view filePath)
+	{
+		if (filePath == CONFIG::SkyboxCubeMeshFilePath)
+		{
+			return TAssetVertexType::CUBEMAP;
+		}
+		else if (filePath == CONFIG::FullscreenQuadMeshFilePath)
+		{
+			return TAssetVertexType::UV;
+		}
+
+		// The PBR pipeline consumes the packed vertex format
+		return TAssetVertexType::PACKED_PBR;
+	}
+
+	// Loads the asset from it's TASSET file, if one exists and is up-to-date. Returns nullptr otherwise
+	static AssetDisk* LoadFromCache(std::string_view filePath, TAssetVertexType& outVertexType, LoadTimings& timings)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		AssetDisk* asset = new AssetDisk();
+
+		std::vector<TAssetMaterial> cachedMaterials;
+		if (!SerializerUtils::Deserialize(filePath, asset, outVertexType, cachedMaterials))
+		{
+			delete asset;
+			return nullptr;
+		}
+
+		timings.meshMs = GetElapsedMs(start);
+
+		// Only the material texture paths are cached, so we still have to decode the images. Embedded textures are stored in the TASSET file
+		asset->materials.resize(cachedMaterials.size());
+		for (uint32_t i = 0; i < static_cast<uint32_t>(cachedMaterials.size()); i++)
+		{
+			asset->materials[i].SetName(cachedMaterials[i].name);
+		}
+
+		std::vector<TextureDecodeJob> decodeJobs = CreateDecodeJobs(cachedMaterials);
+		DecodeMaterialTextures(decodeJobs, asset->materials, timings);
+
+		return asset;
+	}
+
+	// Imports the asset from the source file using assimp. The material descriptions are returned so they can be written to the TASSET file
+	static AssetDisk* ImportFromFile(std::string_view filePath, TAssetVertexType vertexType, std::vector<TAssetMaterial>& outMaterials, LoadTimings& timings)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		Assimp::Importer importer;
+		// The node hierarchy is flattened into the meshes, since every submesh is drawn with the asset's transform
+#if defined(FAST_IMPORT)
+		uint32_t importFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_PreTransformVertices;
+#else
+		uint32_t importFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_PreTransformVertices | aiProcess_FixInfacingNormals | aiProcess_FindInvalidData;
+#endif
+		const aiScene* scene = importer.ReadFile(filePath.data(), importFlags);
+
+		if (scene == nullptr || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) == 1 || scene->mRootNode == nullptr)
+		{
+			LogWarning(importer.GetErrorString());
+			return nullptr;
+		}
+
+		uint32_t numMeshes = scene->mNumMeshes;
+		uint32_t numTextures = scene->mNumTextures;
+		uint32_t numMaterials = scene->mNumMaterials;
+
+		// Check that we have at least one mesh
+		if (numMeshes < 1)
+		{
+			LogError("Failed to load asset from file '%s'! At least one mesh is required", filePath.data());
+			return nullptr;
+		}
+
+		// Now we can create the Asset instance
+		AssetDisk* asset = new AssetDisk();
+		asset->name = filePath;
+		asset->textures.resize(numTextures);
+		asset->materials.resize(numMaterials);
+
+		outMaterials.resize(numMaterials);
+		for (uint32_t i = 0; i < numMaterials; i++)
+		{
+			outMaterials[i].name = std::string(scene->mMaterials[i]->GetName().C_Str());
+			asset->materials[i].SetName(outMaterials[i].name);
+		}
+
+		// Load the meshes
+		if (vertexType == TAssetVertexType::CUBEMAP)
+		{
+			LoadMesh<CubemapVertex>(scene, asset);
+			LogInfo("Loaded mesh using CubemapVertex for asset '%s'", filePath.data());
+		}
+		else if (vertexType == TAssetVertexType::UV)
+		{
+			LoadMesh<UVVertex>(scene, asset);
+			LogInfo("Loaded mesh using UVVertex for asset '%s'", filePath.data());
+		}
+		else if (vertexType == TAssetVertexType::PBR)
+		{
+			LoadMesh<PBRVertex>(scene, asset);
+			LogInfo("Loaded mesh using PBRVertex for asset '%s'", filePath.data());
+		}
+		else
+		{
+			LoadMesh<PackedPBRVertex>(scene, asset);
+			LogInfo("Loaded mesh using PackedPBRVertex for asset '%s'", filePath.data());
+		}
+
+		std::vector<Submesh>& submeshes = asset->mesh->submeshes;
+		if (submeshes.empty())
+		{
+			LogError("Failed to load asset from file '%s'! None of the meshes contain triangles", filePath.data());
+			delete asset->mesh;
+			delete asset;
+			return nullptr;
+		}
+
+		LogInfo("Loaded %u submeshes for asset '%s'", static_cast<uint32_t>(submeshes.size()), filePath.data());
+
+		timings.meshMs = GetElapsedMs(start);
+
+		// Only PBR assets make use of textures
+		if (vertexType == TAssetVertexType::PBR || vertexType == TAssetVertexType::PACKED_PBR)
+		{
+			// Load the standalone texture(s)
+			for (uint32_t i = 0; i < numTextures; i++)
+			{
+				aiTexture* importedTexture = scene->mTextures[i];
+
+				Texture& texture = asset->textures[i];
+				texture.size = { importedTexture->mWidth, importedTexture->mHeight };
+				texture.bytesPerPixel = 4;
+				texture.format = VK_FORMAT_R8G8B8A8_UNORM;
+				texture.mipOffsets = { 0 };
+
+				// Populate the texture data. Note from the assimp implementation:
+				// The format of the data from the imported texture is always ARGB8888, meaning it's 32-bit aligned
+				uint32_t texelSize = static_cast<uint32_t>(texture.size.x) * static_cast<uint32_t>(texture.size.y);
+				uint64_t numBytes = texelSize * 4;
+				char* data = new char[numBytes];
+				memcpy(data, importedTexture->pcData, numBytes);
+				texture.data = data;
+				texture.dataSize = numBytes;
+			}
+
+			// Materials that no submesh references are dropped, so we don't decode their textures at all
+			std::vector<bool> isMaterialReferenced(numMaterials, false);
+			for (const Submesh& submesh : submeshes)
+			{
+				if (submesh.materialIndex < numMaterials)
+				{
+					isMaterialReferenced[submesh.materialIndex] = true;
+				}
+			}
+
+			// Gather all the material texture paths, they're decoded in parallel below
+			for (uint32_t i = 0; i < numMaterials; i++)
+			{
+				if (!isMaterialReferenced[i]) continue;
+
+				TAssetMaterial& currentMaterial = outMaterials[i];
+
+				aiMaterial* currentAIMaterial = scene->mMaterials[i];
+				aiString matName = currentAIMaterial->GetName();
+
+				// Get all the supported textures
+				for (const auto& aiType : SupportedTextureTypes)
+				{
+					uint32_t textureCount = currentAIMaterial->GetTextureCount(aiType);
+					if (textureCount > 0)
 					{
-						uint32_t textureCount = currentAIMaterial->GetTextureCount(aiType);
-						if (textureCount > 0)
+						// Warn if we have more than one diffuse texture, we don't currently support multiple texture of a given type
+						if (textureCount > 1)
+						{
+							LogWarning("More than one texture type (%u) detected for material %s! This is not currently supported", static_cast<uint32_t>(aiType), matName.C_Str());
+						}
+
+						aiString texturePath;
+						if (currentAIMaterial->GetTexture(aiType, 0, &texturePath) == AI_SUCCESS)
 						{
-							// Warn if we have more than one diffuse texture, we don't currently support multiple texture of a given type
-							if (textureCount > 1)
+							auto texTypeIter = AITextureToInternal.find(aiType);
+							if (texTypeIter == AITextureToInternal.end())
 							{
-								LogWarning("More than one texture type (%u) detected for material %s! This is not currently supported", static_cast<uint32_t>(aiType), matName.C_Str());
+								LogError("Failed to convert from aiTexture to the internal texture format! AiTexture type '%u'", static_cast<uint32_t>(aiType));
+								continue;
 							}
 
-							aiString texturePath;
-							if (currentAIMaterial->GetTexture(aiType, 0, &texturePath) == AI_SUCCESS)
+							// We're only interested in the filenames, since we store the textures in a very specific directory
+							std::filesystem::path textureFilePath = std::filesystem::path(texturePath.data);
+							std::filesystem::path textureName = textureFilePath.filename();
+							std::filesystem::path assetDirectoryName = std::filesystem::path(filePath).parent_path().filename();
+							std::filesystem::path textureSourceFilePath = std::filesystem::path(CONFIG::MaterialTexturesFilePath);
+
+							textureSourceFilePath += assetDirectoryName;
+							textureSourceFilePath /= textureName;
+
+							// Images that are already packed go straight into the ORM slot, regardless of which of the packed
+							// slots the exporter assigned them to
+							Material::TEXTURE_TYPE texType = texTypeIter->second;
+							bool isPackableType = texType == Material::TEXTURE_TYPE::AMBIENT_OCCLUSION || texType == Material::TEXTURE_TYPE::ROUGHNESS || texType == Material::TEXTURE_TYPE::METALLIC;
+							if (isPackableType && IsPackedORMFileName(textureName))
 							{
-								// We're only interested in the filenames, since we store the textures in a very specific directory
-								std::filesystem::path textureFilePath = std::filesystem::path(texturePath.data);
-								std::filesystem::path textureName = textureFilePath.filename();
-								std::filesystem::path assetDirectoryName = std::filesystem::path(filePath).parent_path().filename();
-								std::filesystem::path textureSourceFilePath = std::filesystem::path(CONFIG::MaterialTexturesFilePath);
-
-								textureSourceFilePath += assetDirectoryName;
-								textureSourceFilePath /= textureName;
-
-								// Load the image using stb_image
-								std::string textureSourceFilePathStr = textureSourceFilePath.string();
-								int width, height, channels;
-								stbi_uc* pixels = stbi_load(textureSourceFilePathStr.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-								if (pixels == nullptr)
-								{
-									LogError("Failed to load texture! '%s'", textureSourceFilePathStr.c_str());
-									continue;
-								}
-
-								// Create a new texture and add it to the material
-								Texture* tex = new Texture();
-								tex->data = pixels;
-								tex->size = { width, height }; // NOTE - We don't support 3D textures!
-								tex->bytesPerPixel = 32;
-								tex->fileName = textureSourceFilePathStr;
-
-								auto texTypeIter = AITextureToInternal.find(aiType);
-								if (texTypeIter == AITextureToInternal.end())
-								{
-									LogError("Failed to convert from aiTexture to the internal texture format! AiTexture type '%s'", static_cast<uint32_t>(aiType));
-									continue;
-								}
-
-								currentMaterial.AddTextureOfType(texTypeIter->second, tex);
-
-								LogInfo("\tMaterial %u: Loaded %s texture '%s' from disk", 
-									i, 
-									TextureTypeToString.at(AITextureToInternal.at(aiType)).c_str(), 
-									textureName.string().c_str()
-								);
+								texType = Material::TEXTURE_TYPE::ORM;
 							}
+
+							currentMaterial.texturePaths[static_cast<uint32_t>(texType)] = textureSourceFilePath.string();
 						}
 					}
+				}
+			}
 
-					// Remove any materials which have no textures, either because we don't support them only textures it has or
-					// it was exported incorrectly
-					if (currentMaterial.GetTextureCount() == 0)
-					{
-						LogWarning("Material '%s' in asset '%s' has no supported textures! Deleting empty material...", currentMaterial.GetName().data(), filePath.data());
-						asset->materials.erase(asset->materials.begin() + i);
-					}
+			std::vector<TextureDecodeJob> decodeJobs = CreateDecodeJobs(outMaterials);
+			DecodeMaterialTextures(decodeJobs, asset->materials, timings);
+
+			// Remove the unreferenced materials and remap the submesh material indices to match. Materials which have no textures, either
+			// because we don't support any of the textures it has or it was exported incorrectly, are kept since submeshes are still using
+			// them. The renderer falls back to the default textures for them
+			std::vector<uint32_t> materialRemap(numMaterials, 0);
+			uint32_t keptMaterialCount = 0;
+			for (uint32_t i = 0; i < numMaterials; i++)
+			{
+				if (!isMaterialReferenced[i]) continue;
+
+				if (asset->materials[i].GetTextureCount() == 0)
+				{
+					LogWarning("Material '%s' in asset '%s' has no supported textures! Using default textures...", asset->materials[i].GetName().data(), filePath.data());
+				}
+
+				materialRemap[i] = keptMaterialCount;
+				if (keptMaterialCount != i)
+				{
+					asset->materials[keptMaterialCount] = std::move(asset->materials[i]);
+					outMaterials[keptMaterialCount] = std::move(outMaterials[i]);
+				}
+
+				keptMaterialCount++;
+			}
+
+			asset->materials.resize(keptMaterialCount);
+			outMaterials.resize(keptMaterialCount);
+
+			for (Submesh& submesh : submeshes)
+			{
+				submesh.materialIndex = (submesh.materialIndex < numMaterials) ? materialRemap[submesh.materialIndex] : 0;
+			}
+
+			// The LODs copy the submesh materials, so they must be generated after the remap. The simplified indices are appended to
+			// the mesh's indices, and the result is stored in the TASSET file so this is only ever done once per asset
+			if (CONFIG::GenerateMeshLODs)
+			{
+				if (vertexType == TAssetVertexType::PBR)
+				{
+					MeshUtils::GenerateLODs(static_cast<Mesh<PBRVertex>*>(asset->mesh), CONFIG::MaxMeshLODs, CONFIG::MeshLODReduction, CONFIG::MeshLODMaxError, CONFIG::VertexCacheSize);
+				}
+				else
+				{
+					MeshUtils::GenerateLODs(static_cast<Mesh<PackedPBRVertex>*>(asset->mesh), CONFIG::MaxMeshLODs, CONFIG::MeshLODReduction, CONFIG::MeshLODMaxError, CONFIG::VertexCacheSize);
+				}
+			}
+		}
+		return asset;
+	}
+
+	template<typename T>
+	static void CalculateMeshMetadata(const Mesh<T>* mesh, AssetMetadata& metadata)
+	{
+		metadata.vertexCount = mesh->vertices.size();
+		metadata.vertexSize = static_cast<uint32_t>(sizeof(T));
+		metadata.boundsMin = mesh->bounds.min;
+		metadata.boundsMax = mesh->bounds.max;
+	}
+
+	// Fills out the metadata that is kept around after the CPU-side data of the asset is released
+	static void CalculateMetadata(AssetDisk* asset, TAssetVertexType vertexType)
+	{
+		AssetMetadata& metadata = asset->metadata;
+		const BaseMesh* mesh = asset->mesh;
+
+		switch (vertexType)
+		{
+		case TAssetVertexType::PBR:			CalculateMeshMetadata(static_cast<const Mesh<PBRVertex>*>(mesh), metadata); break;
+		case TAssetVertexType::CUBEMAP:		CalculateMeshMetadata(static_cast<const Mesh<CubemapVertex>*>(mesh), metadata); break;
+		case TAssetVertexType::UV:			CalculateMeshMetadata(static_cast<const Mesh<UVVertex>*>(mesh), metadata); break;
+		case TAssetVertexType::PACKED_PBR:	CalculateMeshMetadata(static_cast<const Mesh<PackedPBRVertex>*>(mesh), metadata); break;
+		default: TNG_ASSERT_MSG(false, "Unknown vertex type!"); break;
+		}
+
+		metadata.indexCount = mesh->indices.size();
+		metadata.indexSize = (mesh->indexType == VK_INDEX_TYPE_UINT16) ? sizeof(uint16_t) : sizeof(uint32_t);
+		metadata.submeshCount = static_cast<uint32_t>(mesh->submeshes.size());
+		metadata.lodCount = static_cast<uint32_t>(mesh->lods.size());
+	}
+
+	static uint64_t CalculateMeshBytes(const AssetMetadata& metadata)
+	{
+		return metadata.vertexCount * metadata.vertexSize + metadata.indexCount * metadata.indexSize;
+	}
+
+	// Drops the asset's references to it's material textures, while keeping the material names around
+	static void ReleaseMaterialTextures(AssetDisk* asset)
+	{
+		// Textures are shared between assets, so we only drop our references to them
+		TextureRegistry& registry = TextureRegistry::GetInstance();
+		for (Material& material : asset->materials)
+		{
+			for (uint32_t i = 0; i < static_cast<uint32_t>(Material::TEXTURE_TYPE::_COUNT); i++)
+			{
+				registry.ReleaseTexture(material.GetTextureOfType(static_cast<Material::TEXTURE_TYPE>(i)));
+			}
+
+			material.ClearTextures();
+		}
+	}
+
+	namespace LoaderUtils
+	{
+		AssetDisk* Load(std::string_view filePath)
+		{
+			AssetDisk* asset = LoadFromDisk(filePath);
+			if (asset == nullptr)
+			{
+				return nullptr;
+			}
+
+			Register(asset);
+
+			// We're good to go!
+			return asset;
+		}
+
+		AssetDisk* LoadFromDisk(std::string_view filePath)
+		{
+			LogInfo("Starting asset load for '%s'", filePath.data());
+
+			auto start = std::chrono::high_resolution_clock::now();
+			LoadTimings timings;
+			double serializeMs = 0.0;
+
+			// Try the TASSET file first, and fall back to a full import if there's no valid cache
+			TAssetVertexType vertexType;
+			AssetDisk* asset = LoadFromCache(filePath, vertexType, timings);
+			bool wasCached = (asset != nullptr);
+			if (!wasCached)
+			{
+				vertexType = GetVertexTypeFromFilePath(filePath);
+
+				std::vector<TAssetMaterial> materials;
+				asset = ImportFromFile(filePath, vertexType, materials, timings);
+				if (asset == nullptr)
+				{
+					return nullptr;
 				}
+
+				// A failure to write the cache isn't fatal, we'll simply import the asset again next time
+				auto serializeStart = std::chrono::high_resolution_clock::now();
+				SerializerUtils::Serialize(asset, vertexType, materials, filePath);
+				serializeMs = GetElapsedMs(serializeStart);
 			}
 
-			LogInfo("Finished loading asset with %u materials!", asset->materials.size());
+			asset->uuid = INVALID_UUID;
+			asset->name = filePath;
+
+			// The index type isn't part of the TASSET file, since it only depends on the final indices
+			asset->mesh->indexType = MeshUtils::SelectIndexType(asset->mesh->indices);
+
+			CalculateMetadata(asset, vertexType);
+
+			LogInfo("Finished loading asset with %u materials in %.2fms! [%s: %.2fms | %u textures: %.2fms | TASSET write: %.2fms]",
+				static_cast<uint32_t>(asset->materials.size()),
+				GetElapsedMs(start),
+				wasCached ? "TASSET read" : "import",
+				timings.meshMs,
+				timings.textureCount,
+				timings.textureMs,
+				serializeMs
+			);
 
+			return asset;
+		}
+
+		void Register(AssetDisk* asset)
+		{
 			AssetContainer& container = AssetContainer::GetInstance();
 
 			// Calculate UUID, and keep generating UUIDs in case of collision
@@ -368,12 +1184,21 @@ namespace TANG
 			}
 
 			asset->uuid = uuid;
-			asset->name = filePath;
 
 			container.InsertAsset(asset);
+		}
 
-			// We're good to go!
-			return asset;
+		void Discard(AssetDisk* asset)
+		{
+			if (asset == nullptr)
+			{
+				return;
+			}
+
+			ReleaseMaterialTextures(asset);
+
+			delete asset->mesh;
+			delete asset;
 		}
 
 		bool Unload(UUID uuid)
@@ -387,11 +1212,7 @@ namespace TANG
 
 			// Delete the Asset*
 			AssetDisk* asset = container.RemoveAsset(uuid);
-			if (asset != nullptr)
-			{
-				delete asset->mesh;
-				delete asset;
-			}
+			Discard(asset);
 
 			return true;
 		}
@@ -406,6 +1227,119 @@ namespace TANG
 				asset = container.GetFirst();
 			}
 		}
+
+		bool ReleaseCPUData(UUID uuid)
+		{
+			AssetDisk* asset = AssetContainer::GetInstance().GetAsset(uuid);
+			if (asset == nullptr)
+			{
+				LogWarning("Failed to release CPU data of asset with UUID %llu, the asset does not exist!", uuid);
+				return false;
+			}
+
+			if (asset->mesh == nullptr)
+			{
+				return true;
+			}
+
+			ReleaseMaterialTextures(asset);
+
+			delete asset->mesh;
+			asset->mesh = nullptr;
+
+			asset->textures.clear();
+			asset->textures.shrink_to_fit();
+
+			return true;
+		}
+
+		bool RestoreCPUData(UUID uuid)
+		{
+			AssetDisk* asset = AssetContainer::GetInstance().GetAsset(uuid);
+			if (asset == nullptr)
+			{
+				LogWarning("Failed to restore CPU data of asset with UUID %llu, the asset does not exist!", uuid);
+				return false;
+			}
+
+			if (asset->mesh != nullptr)
+			{
+				return true;
+			}
+
+			AssetDisk* reloaded = LoadFromDisk(asset->name);
+			if (reloaded == nullptr)
+			{
+				LogError("Failed to restore CPU data of asset '%s'!", asset->name.c_str());
+				return false;
+			}
+
+			// The reloaded asset was never registered, so we move it's data over and keep the existing UUID. The references to the material
+			// textures are moved along with the materials
+			asset->mesh = reloaded->mesh;
+			asset->textures = std::move(reloaded->textures);
+			asset->materials = std::move(reloaded->materials);
+			asset->metadata = reloaded->metadata;
+
+			delete reloaded;
+
+			return true;
+		}
+
+		bool IsCPUDataResident(UUID uuid)
+		{
+			AssetDisk* asset = AssetContainer::GetInstance().GetAsset(uuid);
+			return asset != nullptr && asset->mesh != nullptr;
+		}
+
+		AssetMemoryStatistics GetMemoryStatistics()
+		{
+			AssetMemoryStatistics stats;
+
+			AssetContainer::GetInstance().ForEachAsset([&stats](const AssetDisk* asset)
+				{
+					stats.assetCount++;
+
+					uint64_t meshBytes = CalculateMeshBytes(asset->metadata);
+					if (asset->mesh != nullptr)
+					{
+						stats.residentAssetCount++;
+						stats.meshBytes += meshBytes;
+					}
+					else
+					{
+						stats.releasedMeshBytes += meshBytes;
+					}
+				});
+
+			TextureRegistry& registry = TextureRegistry::GetInstance();
+			stats.textureCount = registry.GetTextureCount();
+			stats.textureBytes = registry.GetTextureBytes();
+
+			return stats;
+		}
+
+		Texture* LoadTexture(std::string_view filePath, VkFormat format)
+		{
+			return LoadTextureFromFile(std::string(filePath), format);
+		}
+
+		VkFormat GetMaterialTextureFormat(Material::TEXTURE_TYPE type)
+		{
+			bool useCompression = CONFIG::CompressMaterialTextures && DeviceCache::Get().GetPhysicalDeviceFeatures().textureCompressionBC;
+
+			// The only supported texture (currently) that stores actual colors is the diffuse map,
+			// so we need to set it's format to sRGB instead of UNORM. Normal maps only need X and Y,
+			// since Z is reconstructed in the shader
+			switch (type)
+			{
+			case Material::TEXTURE_TYPE::DIFFUSE:	return useCompression ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_R8G8B8A8_SRGB;
+			case Material::TEXTURE_TYPE::NORMAL:	return useCompression ? VK_FORMAT_BC5_UNORM_BLOCK : VK_FORMAT_R8G8_UNORM;
+			default: break;
+			}
+
+			return useCompression ? VK_FORMAT_BC7_UNORM_BLOCK : VK_FORMAT_R8G8B8A8_UNORM;
+		}
 	}
 
 }
\ No newline at end of file
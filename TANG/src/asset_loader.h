@@ -1,6 +1,7 @@
 #ifndef ASSET_LOADER_H
 #define ASSET_LOADER_H
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -44,6 +45,7 @@ namespace TANG
 		{ Material::TEXTURE_TYPE::METALLIC				, "metallic"			},
 		{ Material::TEXTURE_TYPE::ROUGHNESS				, "roughness"			},
 		{ Material::TEXTURE_TYPE::LIGHTMAP				, "lightmap"			},
+		{ Material::TEXTURE_TYPE::ORM					, "occlusion/roughness/metallic"	},
 		{ Material::TEXTURE_TYPE::_COUNT				, "invalid"				},
 	};
 
@@ -87,12 +89,25 @@ namespace TANG
 		// Returns a pointer to the first asset in the container. This is used when cleaning up
 		AssetDisk* GetFirst() const;
 
+		// Calls the provided function for every asset in the container. The container must not be modified from inside the function
+		void ForEachAsset(const std::function<void(const AssetDisk*)>& func) const;
+
 	private:
 
 		std::unordered_map<UUID, AssetDisk*> container;
 
 	};
 
+	struct AssetMemoryStatistics
+	{
+		uint32_t assetCount = 0;
+		uint32_t residentAssetCount = 0;	// Assets whose CPU-side mesh and texture data is loaded
+		uint64_t meshBytes = 0;				// Vertex and index data of the resident assets
+		uint64_t releasedMeshBytes = 0;		// Vertex and index data that was released after it was uploaded to the GPU
+		uint32_t textureCount = 0;			// Decoded textures held by the TextureRegistry. These are shared between assets
+		uint64_t textureBytes = 0;
+	};
+
 	// Defines utilities for loading assets from file.
 	// Uses assimp for FBX loading, there is currently no plan for supporting multiple
 	// asset-loading libraries which is why the library code is not abstracted away
@@ -103,9 +118,42 @@ namespace TANG
 		// AssetContainer, so it may also be retrieved again later through it's filePath
 		AssetDisk* Load(std::string_view filePath);
 
+		// Loads the asset from disk (either from the TASSET file or by importing the source file) without
+		// registering it in the AssetContainer. Unlike Load(), this is safe to call from any thread
+		AssetDisk* LoadFromDisk(std::string_view filePath);
+
+		// Assigns a UUID to an asset returned by LoadFromDisk() and inserts it into the AssetContainer.
+		// This must be called from the main thread
+		void Register(AssetDisk* asset);
+
+		// Deletes an asset that was never registered, for example when an asynchronous load is cancelled
+		void Discard(AssetDisk* asset);
+
 		bool Unload(UUID uuid);
 
 		void UnloadAll();
+
+		// Drops the CPU-side mesh and texture data of a registered asset, keeping only it's metadata and material names. This is meant to be
+		// called once the renderer resources of the asset have been created (see CONFIG::ReleaseCPUAssetDataAfterUpload). Returns false if the
+		// asset doesn't exist
+		bool ReleaseCPUData(UUID uuid);
+
+		// Reads the CPU-side data of an asset back from it's TASSET file after it was released through ReleaseCPUData(), re-importing it if the
+		// cache is gone. Does nothing if the data is still loaded. This must be called from the main thread
+		bool RestoreCPUData(UUID uuid);
+
+		bool IsCPUDataResident(UUID uuid);
+
+		AssetMemoryStatistics GetMemoryStatistics();
+
+		// Loads a standalone texture in the provided format, which must be RGBA8 (UNORM or SRGB) or one of the formats supported by
+		// TextureCompression. HDR images must use BC6H. The texture is owned by the TextureRegistry, so it must be released through
+		// TextureRegistry::ReleaseTexture() once it's no longer needed
+		Texture* LoadTexture(std::string_view filePath, VkFormat format);
+
+		// Returns the format material textures of the provided type are uploaded as. This depends on whether texture compression is
+		// enabled and supported by the physical device, so it must only be called after the renderer has picked the physical device
+		VkFormat GetMaterialTextureFormat(Material::TEXTURE_TYPE type);
 	};
 }
 
@@ -0,0 +1,691 @@
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include "asset_serializer.h"
+#include "utils/logger.h"
+#include "utils/mapped_file.h"
+#include "utils/sanity_check.h"
+
+namespace TANG
+{
+	// "TASS" in little-endian
+	static constexpr uint32_t TASSET_MAGIC = 0x53534154;
+
+	// Bump this whenever the layout of the file, or of any of the vertex types, changes. It must also be bumped when
+	// the import processing changes, so existing caches are regenerated with the new processing
+	//   2 - Vertex welding
+	//   3 - Vertex cache and vertex fetch optimization
+	//   4 - Packed PBR vertices
+	//   5 - Submeshes
+	//   6 - ORM material slot
+	//   7 - Mesh LODs
+	//   8 - Mesh bounds
+	//   9 - Node transforms baked into the meshes
+	//  10 - Embedded textures
+	static constexpr uint32_t TASSET_VERSION = 10;
+
+	// Alignment of the vertex, index and submesh blocks within the file. Mapped views are page-aligned, so this
+	// guarantees the blocks are suitably aligned for any of our vertex types
+	static constexpr uint64_t TASSET_BLOCK_ALIGNMENT = 16;
+
+	static const char* TASSET_EXTENSION = ".tasset";
+
+	// "TTEX" in little-endian
+	static constexpr uint32_t TTEX_MAGIC = 0x58455454;
+
+	// Bump this whenever the layout of the file or the texture encoders change
+	//   2 - Content hash instead of source file stamp
+	static constexpr uint32_t TTEX_VERSION = 2;
+
+	static const char* TTEX_EXTENSION = ".ttex";
+
+	struct TAssetHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sourceFileSize;
+		int64_t sourceFileTime;
+		uint32_t vertexType;
+		uint32_t vertexSize;
+		uint32_t indexSize;
+		uint32_t materialCount;
+		uint32_t submeshCount;
+		uint32_t lodCount;
+		uint32_t textureCount;				// Embedded textures, stored right after the material block
+		uint64_t vertexCount;
+		uint64_t indexCount;
+		uint64_t vertexBlockOffset;
+		uint64_t indexBlockOffset;
+		uint64_t submeshBlockOffset;
+		uint64_t lodBlockOffset;			// Every LOD is stored as it's error followed by submeshCount submeshes
+		uint64_t materialBlockOffset;
+		MeshBounds bounds;
+	};
+
+	struct TTexHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t contentHash;
+		uint32_t format;
+		uint32_t width;
+		uint32_t height;
+		uint32_t mipLevels;
+	};
+
+	// Mirrors the level index of KTX2 files
+	struct TTexLevel
+	{
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	static uint64_t AlignOffset(uint64_t offset)
+	{
+		return (offset + TASSET_BLOCK_ALIGNMENT - 1) & ~(TASSET_BLOCK_ALIGNMENT - 1);
+	}
+
+	static uint32_t GetVertexSize(TAssetVertexType vertexType)
+	{
+		switch (vertexType)
+		{
+		case TAssetVertexType::PBR:		return static_cast<uint32_t>(sizeof(PBRVertex));
+		case TAssetVertexType::CUBEMAP:	return static_cast<uint32_t>(sizeof(CubemapVertex));
+		case TAssetVertexType::UV:		return static_cast<uint32_t>(sizeof(UVVertex));
+		case TAssetVertexType::PACKED_PBR:	return static_cast<uint32_t>(sizeof(PackedPBRVertex));
+		default: break;
+		}
+
+		return 0;
+	}
+
+	// Returns the raw vertex block of the mesh, as well as the vertex count
+	static const void* GetVertexData(const BaseMesh* mesh, TAssetVertexType vertexType, uint64_t& outVertexCount)
+	{
+		switch (vertexType)
+		{
+		case TAssetVertexType::PBR:
+		{
+			auto typedMesh = static_cast<const Mesh<PBRVertex>*>(mesh);
+			outVertexCount = typedMesh->vertices.size();
+			return typedMesh->vertices.data();
+		}
+		case TAssetVertexType::CUBEMAP:
+		{
+			auto typedMesh = static_cast<const Mesh<CubemapVertex>*>(mesh);
+			outVertexCount = typedMesh->vertices.size();
+			return typedMesh->vertices.data();
+		}
+		case TAssetVertexType::UV:
+		{
+			auto typedMesh = static_cast<const Mesh<UVVertex>*>(mesh);
+			outVertexCount = typedMesh->vertices.size();
+			return typedMesh->vertices.data();
+		}
+		case TAssetVertexType::PACKED_PBR:
+		{
+			auto typedMesh = static_cast<const Mesh<PackedPBRVertex>*>(mesh);
+			outVertexCount = typedMesh->vertices.size();
+			return typedMesh->vertices.data();
+		}
+		default: break;
+		}
+
+		outVertexCount = 0;
+		return nullptr;
+	}
+
+	template<typename T>
+	static BaseMesh* CreateMeshFromBlocks(const char* vertexBlock, uint64_t vertexCount, const char* indexBlock, uint64_t indexCount)
+	{
+		Mesh<T>* mesh = new Mesh<T>();
+
+		// Both blocks share the in-memory layout of their respective vectors, so a single bulk copy is all we need
+		mesh->vertices.resize(vertexCount);
+		memcpy(static_cast<void*>(mesh->vertices.data()), vertexBlock, vertexCount * sizeof(T));
+
+		mesh->indices.resize(indexCount);
+		memcpy(mesh->indices.data(), indexBlock, indexCount * sizeof(IndexType));
+
+		return mesh;
+	}
+
+	static bool GetSourceFileStamp(std::string_view sourceFilePath, uint64_t& outSize, int64_t& outTime)
+	{
+		std::error_code err;
+		std::filesystem::path sourcePath(sourceFilePath);
+
+		outSize = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, err));
+		if (err) return false;
+
+		outTime = static_cast<int64_t>(std::filesystem::last_write_time(sourcePath, err).time_since_epoch().count());
+		if (err) return false;
+
+		return true;
+	}
+
+	static void WriteString(std::ofstream& file, const std::string& str)
+	{
+		uint32_t length = static_cast<uint32_t>(str.size());
+		file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+		file.write(str.data(), length);
+	}
+
+	// Reads a length-prefixed string from the mapped file and advances the offset. Returns false if we would read past the end of the file
+	static bool ReadString(const MappedFile& file, uint64_t& offset, std::string& outStr)
+	{
+		uint32_t length = 0;
+		if (offset + sizeof(length) > file.GetSize()) return false;
+
+		memcpy(&length, file.GetData() + offset, sizeof(length));
+		offset += sizeof(length);
+
+		if (offset + length > file.GetSize()) return false;
+
+		outStr.assign(file.GetData() + offset, length);
+		offset += length;
+
+		return true;
+	}
+
+	// Returns whether count elements of the provided size, starting at the provided offset, fit within the file. Written so that a corrupt
+	// header can't overflow the calculation
+	static bool IsBlockInFile(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize)
+	{
+		return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+	}
+
+	// Every submesh must stay within the index buffer and reference a valid material, otherwise we'd draw garbage
+	static bool IsSubmeshValid(const Submesh& submesh, const TAssetHeader& header)
+	{
+		return static_cast<uint64_t>(submesh.firstIndex) + submesh.indexCount <= header.indexCount &&
+			submesh.vertexOffset >= 0 && static_cast<uint64_t>(submesh.vertexOffset) <= header.vertexCount &&
+			(header.materialCount == 0 || submesh.materialIndex < header.materialCount);
+	}
+
+	static void WritePadding(std::ofstream& file, uint64_t currentOffset, uint64_t targetOffset)
+	{
+		static const char zeroes[TASSET_BLOCK_ALIGNMENT] = {};
+		TNG_ASSERT_MSG(targetOffset - currentOffset <= TASSET_BLOCK_ALIGNMENT, "Invalid TASSET padding!");
+
+		file.write(zeroes, static_cast<std::streamsize>(targetOffset - currentOffset));
+	}
+
+	namespace SerializerUtils
+	{
+		std::string GetCacheFilePath(std::string_view sourceFilePath)
+		{
+			std::filesystem::path cachePath(sourceFilePath);
+			cachePath.replace_extension(TASSET_EXTENSION);
+			return cachePath.string();
+		}
+
+		bool Serialize(const AssetDisk* asset, TAssetVertexType vertexType, const std::vector<TAssetMaterial>& materials, std::string_view sourceFilePath)
+		{
+			if (asset == nullptr || asset->mesh == nullptr)
+			{
+				LogError("Failed to serialize asset '%s'! Asset or mesh is null", sourceFilePath.data());
+				return false;
+			}
+
+			if (materials.size() != asset->materials.size())
+			{
+				LogError("Failed to serialize asset '%s'! Mismatched number of material descriptions", sourceFilePath.data());
+				return false;
+			}
+
+			TAssetHeader header{};
+			header.magic = TASSET_MAGIC;
+			header.version = TASSET_VERSION;
+			if (!GetSourceFileStamp(sourceFilePath, header.sourceFileSize, header.sourceFileTime))
+			{
+				LogError("Failed to serialize asset '%s'! Could not query the source file", sourceFilePath.data());
+				return false;
+			}
+
+			const void* vertexData = GetVertexData(asset->mesh, vertexType, header.vertexCount);
+			if (vertexData == nullptr)
+			{
+				LogError("Failed to serialize asset '%s'! Unsupported vertex type %u", sourceFilePath.data(), static_cast<uint32_t>(vertexType));
+				return false;
+			}
+
+			header.vertexType = static_cast<uint32_t>(vertexType);
+			header.vertexSize = GetVertexSize(vertexType);
+			header.indexSize = static_cast<uint32_t>(sizeof(IndexType));
+			header.indexCount = asset->mesh->indices.size();
+			header.materialCount = static_cast<uint32_t>(asset->materials.size());
+			header.submeshCount = static_cast<uint32_t>(asset->mesh->submeshes.size());
+			header.lodCount = static_cast<uint32_t>(asset->mesh->lods.size());
+			header.textureCount = static_cast<uint32_t>(asset->textures.size());
+			header.bounds = asset->mesh->bounds;
+
+			for (const MeshLOD& lod : asset->mesh->lods)
+			{
+				if (lod.submeshes.size() != header.submeshCount)
+				{
+					LogError("Failed to serialize asset '%s'! Every mesh LOD must have the same number of submeshes as the base mesh", sourceFilePath.data());
+					return false;
+				}
+			}
+
+			uint64_t vertexBlockSize = header.vertexCount * header.vertexSize;
+			uint64_t indexBlockSize = header.indexCount * header.indexSize;
+			uint64_t submeshBlockSize = header.submeshCount * sizeof(Submesh);
+			uint64_t lodBlockSize = header.lodCount * (sizeof(float) + submeshBlockSize);
+
+			header.vertexBlockOffset = AlignOffset(sizeof(TAssetHeader));
+			header.indexBlockOffset = AlignOffset(header.vertexBlockOffset + vertexBlockSize);
+			header.submeshBlockOffset = AlignOffset(header.indexBlockOffset + indexBlockSize);
+			header.lodBlockOffset = header.submeshBlockOffset + submeshBlockSize;
+			header.materialBlockOffset = header.lodBlockOffset + lodBlockSize;
+
+			std::string cacheFilePath = GetCacheFilePath(sourceFilePath);
+			std::ofstream file(cacheFilePath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				LogError("Failed to open TASSET file '%s' for writing!", cacheFilePath.c_str());
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(TAssetHeader));
+
+			WritePadding(file, sizeof(TAssetHeader), header.vertexBlockOffset);
+			file.write(static_cast<const char*>(vertexData), static_cast<std::streamsize>(vertexBlockSize));
+
+			WritePadding(file, header.vertexBlockOffset + vertexBlockSize, header.indexBlockOffset);
+			file.write(reinterpret_cast<const char*>(asset->mesh->indices.data()), static_cast<std::streamsize>(indexBlockSize));
+
+			WritePadding(file, header.indexBlockOffset + indexBlockSize, header.submeshBlockOffset);
+			file.write(reinterpret_cast<const char*>(asset->mesh->submeshes.data()), static_cast<std::streamsize>(submeshBlockSize));
+
+			for (const MeshLOD& lod : asset->mesh->lods)
+			{
+				file.write(reinterpret_cast<const char*>(&lod.error), sizeof(float));
+				file.write(reinterpret_cast<const char*>(lod.submeshes.data()), static_cast<std::streamsize>(submeshBlockSize));
+			}
+
+			for (const TAssetMaterial& material : materials)
+			{
+				WriteString(file, material.name);
+
+				for (const std::string& texturePath : material.texturePaths)
+				{
+					WriteString(file, texturePath);
+				}
+			}
+
+			for (const Texture& texture : asset->textures)
+			{
+				uint32_t width = static_cast<uint32_t>(texture.size.x);
+				uint32_t height = static_cast<uint32_t>(texture.size.y);
+				uint32_t format = static_cast<uint32_t>(texture.format);
+				uint64_t dataSize = texture.data == nullptr ? 0 : texture.dataSize;
+				file.write(reinterpret_cast<const char*>(&width), sizeof(width));
+				file.write(reinterpret_cast<const char*>(&height), sizeof(height));
+				file.write(reinterpret_cast<const char*>(&texture.bytesPerPixel), sizeof(texture.bytesPerPixel));
+				file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+				file.write(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
+				file.write(static_cast<const char*>(texture.data), static_cast<std::streamsize>(dataSize));
+			}
+
+			if (!file.good())
+			{
+				LogError("Failed to write TASSET file '%s'!", cacheFilePath.c_str());
+				file.close();
+
+				// Don't leave a truncated cache behind, otherwise we'd fail to read it every subsequent launch
+				std::error_code err;
+				std::filesystem::remove(cacheFilePath, err);
+				return false;
+			}
+
+			file.close();
+
+			LogInfo("Serialized TASSET file '%s' (%llu vertices, %llu indices, %u submeshes, %u LODs, %u materials, %u textures)", cacheFilePath.c_str(), header.vertexCount, header.indexCount, header.submeshCount, header.lodCount, header.materialCount, header.textureCount);
+			return true;
+		}
+
+		bool Deserialize(std::string_view sourceFilePath, AssetDisk* outAsset, TAssetVertexType& outVertexType, std::vector<TAssetMaterial>& outMaterials)
+		{
+			std::string cacheFilePath = GetCacheFilePath(sourceFilePath);
+
+			MappedFile file;
+			if (!file.Open(cacheFilePath))
+			{
+				// No cache yet, this is expected on the first import
+				return false;
+			}
+
+			if (file.GetSize() < sizeof(TAssetHeader))
+			{
+				LogWarning("TASSET file '%s' is truncated! Re-importing asset", cacheFilePath.c_str());
+				return false;
+			}
+
+			TAssetHeader header;
+			memcpy(&header, file.GetData(), sizeof(TAssetHeader));
+
+			if (header.magic != TASSET_MAGIC || header.version != TASSET_VERSION)
+			{
+				LogInfo("TASSET file '%s' is from a different format version (%u, expected %u). Re-importing asset", cacheFilePath.c_str(), header.version, TASSET_VERSION);
+				return false;
+			}
+
+			uint64_t sourceFileSize = 0;
+			int64_t sourceFileTime = 0;
+			if (GetSourceFileStamp(sourceFilePath, sourceFileSize, sourceFileTime) &&
+				(sourceFileSize != header.sourceFileSize || sourceFileTime != header.sourceFileTime))
+			{
+				LogInfo("TASSET file '%s' is out of date. Re-importing asset", cacheFilePath.c_str());
+				return false;
+			}
+
+			if (header.vertexType >= static_cast<uint32_t>(TAssetVertexType::_COUNT) ||
+				header.vertexSize != GetVertexSize(static_cast<TAssetVertexType>(header.vertexType)) ||
+				header.indexSize != sizeof(IndexType))
+			{
+				LogWarning("TASSET file '%s' has a mismatched vertex or index layout! Re-importing asset", cacheFilePath.c_str());
+				return false;
+			}
+
+			uint64_t submeshBlockSize = header.submeshCount * sizeof(Submesh);
+			if (!IsBlockInFile(header.vertexBlockOffset, header.vertexCount, header.vertexSize, file.GetSize()) ||
+				!IsBlockInFile(header.indexBlockOffset, header.indexCount, header.indexSize, file.GetSize()) ||
+				!IsBlockInFile(header.submeshBlockOffset, header.submeshCount, sizeof(Submesh), file.GetSize()) ||
+				!IsBlockInFile(header.lodBlockOffset, header.lodCount, sizeof(float) + submeshBlockSize, file.GetSize()) ||
+				header.materialBlockOffset > file.GetSize())
+			{
+				LogWarning("TASSET file '%s' is truncated! Re-importing asset", cacheFilePath.c_str());
+				return false;
+			}
+
+			std::vector<Submesh> submeshes(header.submeshCount);
+			memcpy(submeshes.data(), file.GetData() + header.submeshBlockOffset, submeshBlockSize);
+			for (const Submesh& submesh : submeshes)
+			{
+				if (!IsSubmeshValid(submesh, header))
+				{
+					LogWarning("TASSET file '%s' has a corrupt submesh block! Re-importing asset", cacheFilePath.c_str());
+					return false;
+				}
+			}
+
+			std::vector<MeshLOD> lods(header.lodCount);
+			uint64_t lodOffset = header.lodBlockOffset;
+			for (MeshLOD& lod : lods)
+			{
+				memcpy(&lod.error, file.GetData() + lodOffset, sizeof(float));
+				lodOffset += sizeof(float);
+
+				lod.submeshes.resize(header.submeshCount);
+				memcpy(lod.submeshes.data(), file.GetData() + lodOffset, submeshBlockSize);
+				lodOffset += submeshBlockSize;
+
+				for (const Submesh& submesh : lod.submeshes)
+				{
+					if (!IsSubmeshValid(submesh, header))
+					{
+						LogWarning("TASSET file '%s' has a corrupt LOD block! Re-importing asset", cacheFilePath.c_str());
+						return false;
+					}
+				}
+			}
+
+			if (submeshes.empty())
+			{
+				LogWarning("TASSET file '%s' has no submeshes! Re-importing asset", cacheFilePath.c_str());
+				return false;
+			}
+
+			// Read the material block first, so we don't allocate the mesh if the file turns out to be invalid
+			std::vector<TAssetMaterial> materials(header.materialCount);
+			uint64_t offset = header.materialBlockOffset;
+			for (TAssetMaterial& material : materials)
+			{
+				bool success = ReadString(file, offset, material.name);
+				for (std::string& texturePath : material.texturePaths)
+				{
+					success = success && ReadString(file, offset, texturePath);
+				}
+
+				if (!success)
+				{
+					LogWarning("TASSET file '%s' has a corrupt material block! Re-importing asset", cacheFilePath.c_str());
+					return false;
+				}
+			}
+
+			// The embedded texture block directly follows the variable-length material block
+			std::vector<Texture> textures(header.textureCount);
+			for (Texture& texture : textures)
+			{
+				uint32_t width = 0;
+				uint32_t height = 0;
+				uint32_t format = 0;
+				uint64_t dataSize = 0;
+				uint64_t descriptionSize = sizeof(width) + sizeof(height) + sizeof(texture.bytesPerPixel) + sizeof(format) + sizeof(dataSize);
+				if (!IsBlockInFile(offset, 1, descriptionSize, file.GetSize()))
+				{
+					LogWarning("TASSET file '%s' has a corrupt texture block! Re-importing asset", cacheFilePath.c_str());
+					return false;
+				}
+
+				const char* description = file.GetData() + offset;
+				memcpy(&width, description, sizeof(width));
+				memcpy(&height, description + 4, sizeof(height));
+				memcpy(&texture.bytesPerPixel, description + 8, sizeof(texture.bytesPerPixel));
+				memcpy(&format, description + 12, sizeof(format));
+				memcpy(&dataSize, description + 16, sizeof(dataSize));
+				offset += descriptionSize;
+
+				if (!IsBlockInFile(offset, dataSize, 1, file.GetSize()))
+				{
+					LogWarning("TASSET file '%s' has a corrupt texture block! Re-importing asset", cacheFilePath.c_str());
+					return false;
+				}
+
+				texture.size = { width, height };
+				texture.format = static_cast<VkFormat>(format);
+				texture.mipOffsets = { 0 };
+				if (dataSize > 0)
+				{
+					char* data = new char[dataSize];
+					memcpy(data, file.GetData() + offset, dataSize);
+					texture.data = data;
+					texture.dataSize = dataSize;
+				}
+
+				offset += dataSize;
+			}
+
+			const char* vertexBlock = file.GetData() + header.vertexBlockOffset;
+			const char* indexBlock = file.GetData() + header.indexBlockOffset;
+
+			outVertexType = static_cast<TAssetVertexType>(header.vertexType);
+			switch (outVertexType)
+			{
+			case TAssetVertexType::PBR:
+				outAsset->mesh = CreateMeshFromBlocks<PBRVertex>(vertexBlock, header.vertexCount, indexBlock, header.indexCount);
+				break;
+			case TAssetVertexType::CUBEMAP:
+				outAsset->mesh = CreateMeshFromBlocks<CubemapVertex>(vertexBlock, header.vertexCount, indexBlock, header.indexCount);
+				break;
+			case TAssetVertexType::UV:
+				outAsset->mesh = CreateMeshFromBlocks<UVVertex>(vertexBlock, header.vertexCount, indexBlock, header.indexCount);
+				break;
+			case TAssetVertexType::PACKED_PBR:
+				outAsset->mesh = CreateMeshFromBlocks<PackedPBRVertex>(vertexBlock, header.vertexCount, indexBlock, header.indexCount);
+				break;
+			default:
+				return false;
+			}
+
+			outAsset->mesh->submeshes = std::move(submeshes);
+			outAsset->mesh->lods = std::move(lods);
+			outAsset->mesh->bounds = header.bounds;
+			outAsset->textures = std::move(textures);
+			outMaterials = std::move(materials);
+
+			LogInfo("Loaded TASSET file '%s' (%llu vertices, %llu indices, %u submeshes, %u LODs, %u materials, %u textures)", cacheFilePath.c_str(), header.vertexCount, header.indexCount, header.submeshCount, header.lodCount, header.materialCount, header.textureCount);
+			return true;
+		}
+
+		std::string GetTextureCacheFilePath(std::string_view cacheName, VkFormat format)
+		{
+			// The source extension is kept, so images that only differ by extension don't share a cache file
+			std::string cacheFilePath(cacheName);
+			cacheFilePath += "." + std::to_string(static_cast<uint32_t>(format));
+			cacheFilePath += TTEX_EXTENSION;
+			return cacheFilePath;
+		}
+
+		bool SerializeTexture(const Texture* texture, std::string_view cacheName)
+		{
+			if (texture == nullptr || texture->data == nullptr || texture->mipOffsets.empty())
+			{
+				LogError("Failed to serialize texture '%s'! Texture has no data", cacheName.data());
+				return false;
+			}
+
+			TTexHeader header{};
+			header.magic = TTEX_MAGIC;
+			header.version = TTEX_VERSION;
+			header.contentHash = texture->contentHash;
+
+			header.format = static_cast<uint32_t>(texture->format);
+			header.width = static_cast<uint32_t>(texture->size.x);
+			header.height = static_cast<uint32_t>(texture->size.y);
+			header.mipLevels = texture->GetMipLevels();
+
+			// Lay out the mip levels after the level index, each one aligned
+			std::vector<TTexLevel> levels(header.mipLevels);
+			uint64_t offset = sizeof(TTexHeader) + sizeof(TTexLevel) * header.mipLevels;
+			for (uint32_t i = 0; i < header.mipLevels; i++)
+			{
+				uint64_t mipEnd = (i + 1 < header.mipLevels) ? texture->mipOffsets[i + 1] : texture->dataSize;
+
+				levels[i].offset = AlignOffset(offset);
+				levels[i].size = mipEnd - texture->mipOffsets[i];
+				offset = levels[i].offset + levels[i].size;
+			}
+
+			std::string cacheFilePath = GetTextureCacheFilePath(cacheName, texture->format);
+			std::ofstream file(cacheFilePath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				LogError("Failed to open TTEX file '%s' for writing!", cacheFilePath.c_str());
+				return false;
+			}
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(TTexHeader));
+			file.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(sizeof(TTexLevel) * levels.size()));
+
+			offset = sizeof(TTexHeader) + sizeof(TTexLevel) * header.mipLevels;
+			for (uint32_t i = 0; i < header.mipLevels; i++)
+			{
+				WritePadding(file, offset, levels[i].offset);
+				file.write(static_cast<const char*>(texture->data) + texture->mipOffsets[i], static_cast<std::streamsize>(levels[i].size));
+				offset = levels[i].offset + levels[i].size;
+			}
+
+			if (!file.good())
+			{
+				LogError("Failed to write TTEX file '%s'!", cacheFilePath.c_str());
+				file.close();
+
+				std::error_code err;
+				std::filesystem::remove(cacheFilePath, err);
+				return false;
+			}
+
+			file.close();
+
+			LogInfo("Serialized TTEX file '%s' (%ux%u, %u mips, %llu bytes)", cacheFilePath.c_str(), header.width, header.height, header.mipLevels, texture->dataSize);
+			return true;
+		}
+
+		bool DeserializeTexture(std::string_view cacheName, VkFormat format, uint64_t contentHash, Texture* outTexture, uint32_t firstMip)
+		{
+			std::string cacheFilePath = GetTextureCacheFilePath(cacheName, format);
+
+			MappedFile file;
+			if (!file.Open(cacheFilePath))
+			{
+				// No cache yet, this is expected the first time the texture is used
+				return false;
+			}
+
+			if (file.GetSize() < sizeof(TTexHeader))
+			{
+				LogWarning("TTEX file '%s' is truncated! Re-encoding texture", cacheFilePath.c_str());
+				return false;
+			}
+
+			TTexHeader header;
+			memcpy(&header, file.GetData(), sizeof(TTexHeader));
+
+			if (header.magic != TTEX_MAGIC || header.version != TTEX_VERSION || header.format != static_cast<uint32_t>(format))
+			{
+				LogInfo("TTEX file '%s' is from a different format version (%u, expected %u). Re-encoding texture", cacheFilePath.c_str(), header.version, TTEX_VERSION);
+				return false;
+			}
+
+			if (header.contentHash != contentHash)
+			{
+				LogInfo("TTEX file '%s' is out of date. Re-encoding texture", cacheFilePath.c_str());
+				return false;
+			}
+
+			uint64_t levelIndexEnd = sizeof(TTexHeader) + sizeof(TTexLevel) * static_cast<uint64_t>(header.mipLevels);
+			if (header.mipLevels == 0 || header.width == 0 || header.height == 0 || levelIndexEnd > file.GetSize())
+			{
+				LogWarning("TTEX file '%s' has an invalid header! Re-encoding texture", cacheFilePath.c_str());
+				return false;
+			}
+
+			if (firstMip >= header.mipLevels)
+			{
+				LogWarning("Attempting to read mip %u from TTEX file '%s', which only has %u mips!", firstMip, cacheFilePath.c_str(), header.mipLevels);
+				return false;
+			}
+
+			std::vector<TTexLevel> levels(header.mipLevels);
+			memcpy(levels.data(), file.GetData() + sizeof(TTexHeader), sizeof(TTexLevel) * header.mipLevels);
+
+			uint64_t totalSize = 0;
+			for (uint32_t i = firstMip; i < header.mipLevels; i++)
+			{
+				const TTexLevel& level = levels[i];
+				if (!IsBlockInFile(level.offset, level.size, 1, file.GetSize()))
+				{
+					LogWarning("TTEX file '%s' is truncated! Re-encoding texture", cacheFilePath.c_str());
+					return false;
+				}
+
+				totalSize += level.size;
+			}
+
+			char* data = new char[totalSize];
+			outTexture->mipOffsets.resize(header.mipLevels - firstMip);
+
+			uint64_t offset = 0;
+			for (uint32_t i = firstMip; i < header.mipLevels; i++)
+			{
+				memcpy(data + offset, file.GetData() + levels[i].offset, levels[i].size);
+				outTexture->mipOffsets[i - firstMip] = offset;
+				offset += levels[i].size;
+			}
+
+			outTexture->data = data;
+			outTexture->dataSize = totalSize;
+			outTexture->size = { std::max(header.width >> firstMip, 1u), std::max(header.height >> firstMip, 1u) };
+			outTexture->format = format;
+			outTexture->bytesPerPixel = 0;
+
+			return true;
+		}
+	}
+}
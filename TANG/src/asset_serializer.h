@@ -0,0 +1,81 @@
+#ifndef ASSET_SERIALIZER_H
+#define ASSET_SERIALIZER_H
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "asset_types.h"
+
+namespace TANG
+{
+	// Identifies which vertex type the mesh inside a TASSET file was stored with. The numbering is part of the
+	// file format, so new entries must only ever be appended
+	enum class TAssetVertexType : uint32_t
+	{
+		PBR = 0,
+		CUBEMAP,
+		UV,
+		PACKED_PBR,
+		_COUNT      // DO NOT USE. THIS MUST COME LAST
+	};
+
+	// Material description as stored in the TASSET file. We only store the source file path for every texture
+	// slot, the texture data itself is decoded when the asset is loaded. The occlusion, roughness and metallic paths
+	// are kept separately even though they're packed into a single ORM texture, so the packing can change without
+	// re-importing the asset. The ORM path is only set when the source image is already packed
+	struct TAssetMaterial
+	{
+		std::string name;
+		std::array<std::string, static_cast<size_t>(Material::TEXTURE_TYPE::_COUNT)> texturePaths;
+	};
+
+	// The TASSET format is our own binary representation of an asset. The file is laid out as follows:
+	//
+	//		[ TAssetHeader ][ Vertex block ][ Index block ][ Submesh block ][ Material block ][ Texture block ]
+	//
+	// The vertex, index and submesh blocks are laid out exactly like Mesh<T>::vertices, BaseMesh::indices and BaseMesh::submeshes
+	// in memory, so loading them is a single copy out of the memory-mapped file with no per-vertex conversion. The texture block
+	// holds the textures embedded in the source file, since those can't be decoded again from a path. The header
+	// stores the size and write time of the source file, and the cache is discarded if either changes or if the
+	// file was written by a different format version
+	namespace SerializerUtils
+	{
+		// Returns the path to the TASSET file that corresponds to the provided source asset file
+		std::string GetCacheFilePath(std::string_view sourceFilePath);
+
+		// Writes the TASSET file for the provided asset, using the provided material descriptions (one per asset material). Returns true on success
+		bool Serialize(const AssetDisk* asset, TAssetVertexType vertexType, const std::vector<TAssetMaterial>& materials, std::string_view sourceFilePath);
+
+		// Reads the TASSET file that corresponds to the provided source file, if it exists and is up-to-date. On success, the mesh is
+		// allocated and stored inside outAsset, and the material descriptions are returned so the caller can decode the textures.
+		// Returns false if there is no valid cache, in which case the asset must be imported from the source file
+		bool Deserialize(std::string_view sourceFilePath, AssetDisk* outAsset, TAssetVertexType& outVertexType, std::vector<TAssetMaterial>& outMaterials);
+	}
+
+	// The TTEX format caches the block-compressed mip chain of a single texture, so the (slow) encoding only ever happens once
+	// per source image and format. It's modelled after KTX2, but without the data format descriptor and supercompression:
+	//
+	//		[ TTexHeader ][ Level index ][ Mip 0 ][ Mip 1 ] ... [ Mip N ]
+	//
+	// The level index stores the offset and size of every mip level, and every mip level is aligned to 16 bytes. Unlike TASSET
+	// files, the header stores the content hash of the texture instead of a source file stamp, since packed textures are built
+	// from several source images. The cache is discarded if the content hash changes or if it was written by a different format version
+	namespace SerializerUtils
+	{
+		// Returns the path to the TTEX file that corresponds to the provided cache name and format. The cache name is usually the
+		// path to the source image, and the format is part of the file name since the same image may be compressed into different formats
+		std::string GetTextureCacheFilePath(std::string_view cacheName, VkFormat format);
+
+		// Writes the TTEX file for the provided texture, stamped with it's content hash. Returns true on success
+		bool SerializeTexture(const Texture* texture, std::string_view cacheName);
+
+		// Reads the TTEX file that corresponds to the provided cache name and format, if it exists and matches the provided content hash.
+		// On success the mip chain, size and format of outTexture are filled out. Only the mips from firstMip onwards are read, in which case
+		// the size of outTexture is the size of firstMip. Returns false if there is no valid cache
+		bool DeserializeTexture(std::string_view cacheName, VkFormat format, uint64_t contentHash, Texture* outTexture, uint32_t firstMip = 0);
+	}
+}
+
+#endif
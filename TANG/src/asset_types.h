@@ -14,8 +14,7 @@
 #include "utils/uuid.h"
 #include "vertex_types.h"
 
-#include "data_buffer/vertex_buffer.h"
-#include "data_buffer/index_buffer.h"
+#include "geometry_arena.h"
 #include "texture_resource.h"
 
 typedef uint32_t IndexType;
@@ -65,42 +64,51 @@ namespace TANG
 		glm::vec3 scale;
 	};
 
-	// TODO - Create a texture registry which holds all the texture data. The interface will only expose the texture UUIDs
-	//        that refer to the internal registry. This implies that anything outside the registry MUST NOT hold any type of
-	//        pointer to a Texture instance, but will rather store a UUID. It is much safer to do it this way because we cannot
-	//        have dangling pointers, but the drawback is that we must query the texture registry for the texture data potentially
-	//        very often, so best-case scenario is that it has a look-up complexity closest to O(1)
+	// Decoded texture data. Textures are owned by the TextureRegistry (see texture_registry.h) and are shared between
+	// all the materials that reference the same image contents, so materials must never delete them directly.
+	// The contentHash uniquely identifies the image contents, and is also used to share the GPU-side TextureResource.
+	// The data holds the whole mip chain in the texture's format, which is either RGBA8 or one of the block-compressed
+	// formats produced by the importer (see texture_compression.h)
 	struct Texture
 	{
-		Texture() : data(nullptr), size(0, 0), bytesPerPixel(0), fileName("")
+		Texture() : data(nullptr), dataSize(0), size(0, 0), bytesPerPixel(0), format(VK_FORMAT_UNDEFINED), fileName(""), contentHash(0)
 		{
 		}
 
 		~Texture() 
 		{
-			delete[] data;
+			delete[] static_cast<char*>(data);
+			dataSize = 0;
 			size = { 0, 0 };
 			bytesPerPixel = 0;
+			format = VK_FORMAT_UNDEFINED;
+			mipOffsets.clear();
 			fileName = "";
+			contentHash = 0;
 		}
 
 		Texture(const Texture& other) : 
-			size(other.size), bytesPerPixel(other.bytesPerPixel), fileName(other.fileName)
+			dataSize(other.dataSize), size(other.size), bytesPerPixel(other.bytesPerPixel), format(other.format), mipOffsets(other.mipOffsets),
+			fileName(other.fileName), contentHash(other.contentHash)
 		{
 			// Temporary debug :)
 			LogWarning("Deep-copying texture!");
 
-			data = new char[static_cast<uint32_t>(other.size.x) * static_cast<uint32_t>(other.size.y) * bytesPerPixel];
+			data = new char[dataSize];
+			memcpy(data, other.data, dataSize);
 		}
 
 		Texture(Texture&& other) : 
-			data(std::move(other.data)), size(std::move(other.size)), bytesPerPixel(std::move(other.bytesPerPixel)),
-			fileName(std::move(other.fileName))
+			data(std::move(other.data)), dataSize(other.dataSize), size(std::move(other.size)), bytesPerPixel(std::move(other.bytesPerPixel)),
+			format(other.format), mipOffsets(std::move(other.mipOffsets)), fileName(std::move(other.fileName)), contentHash(other.contentHash)
 		{
 			other.data = nullptr;
+			other.dataSize = 0;
 			other.size = { 0, 0 };
 			other.bytesPerPixel = 0;
+			other.format = VK_FORMAT_UNDEFINED;
 			other.fileName = "";
+			other.contentHash = 0;
 		}
 
 		Texture& operator=(const Texture& other)
@@ -111,16 +119,34 @@ namespace TANG
 				return *this;
 			}
 
-			data = new char[static_cast<uint32_t>(other.size.x) * static_cast<uint32_t>(other.size.y) * bytesPerPixel];
+			delete[] static_cast<char*>(data);
+			data = new char[other.dataSize];
+			memcpy(data, other.data, other.dataSize);
+
+			dataSize = other.dataSize;
 			size = other.size;
 			bytesPerPixel = other.bytesPerPixel;
+			format = other.format;
+			mipOffsets = other.mipOffsets;
 			fileName = other.fileName;
+			contentHash = other.contentHash;
+
+			return *this;
+		}
+
+		uint32_t GetMipLevels() const
+		{
+			return static_cast<uint32_t>(mipOffsets.size());
 		}
 
-		void* data;
-		glm::vec2 size;
-		uint32_t bytesPerPixel; // Guaranteed to be 4 by assimp loader
+		void* data;							// Must be allocated with new char[]
+		uint64_t dataSize;
+		glm::vec2 size;						// Size of the first mip level
+		uint32_t bytesPerPixel;				// Zero for block-compressed formats
+		VkFormat format;
+		std::vector<uint64_t> mipOffsets;	// Offset of every mip level into data, there's always at least one
 		std::string fileName;
+		uint64_t contentHash;
 	};
 
 	class Material
@@ -137,6 +163,7 @@ namespace TANG
 			METALLIC,
 			ROUGHNESS,
 			LIGHTMAP,
+			ORM,        // Occlusion (R), roughness (G) and metallic (B) packed into a single texture. Built by the asset loader from the three slots above
 			_COUNT      // DO NOT USE. THIS MUST COME LAST
 		};
 
@@ -200,14 +227,14 @@ namespace TANG
 			textureCount++;
 		}
 
-		bool HasTextureOfType(const TEXTURE_TYPE type)
+		bool HasTextureOfType(const TEXTURE_TYPE type) const
 		{
 			if (type == TEXTURE_TYPE::_COUNT) return false;
 
 			return textures[static_cast<uint32_t>(type)] != nullptr;
 		}
 
-		Texture* GetTextureOfType(const TEXTURE_TYPE type)
+		Texture* GetTextureOfType(const TEXTURE_TYPE type) const
 		{
 			return textures[static_cast<size_t>(type)];
 		}
@@ -227,6 +254,13 @@ namespace TANG
 			return textureCount;
 		}
 
+		// Empties every texture slot. The textures are owned by the TextureRegistry, so the caller must release them first
+		void ClearTextures()
+		{
+			std::fill(textures.begin(), textures.end(), nullptr);
+			textureCount = 0;
+		}
+
 	private:
 
 		std::string name;
@@ -234,9 +268,51 @@ namespace TANG
 		uint32_t textureCount;
 	};
 
+	// Range of a mesh that is drawn with a single material. Every submesh is imported, welded and optimized separately, so it's
+	// indices are relative to it's first vertex. This keeps the indices small enough for 16-bit index buffers in most cases
+	struct Submesh
+	{
+		uint32_t firstIndex = 0;		// Offset into the mesh's indices
+		uint32_t indexCount = 0;
+		int32_t vertexOffset = 0;		// Offset into the mesh's vertices, added to every index of the submesh
+		uint32_t materialIndex = 0;		// Index into the asset's materials
+	};
+
+	// Object-space bounds of a mesh, calculated once at import time and stored in the TASSET file. The LODs only reference the mesh's
+	// vertices, so the bounds cover them as well
+	struct MeshBounds
+	{
+		glm::vec3 min = glm::vec3(0.0f);
+		glm::vec3 max = glm::vec3(0.0f);
+		glm::vec3 sphereCenter = glm::vec3(0.0f);	// Center of the AABB
+		float sphereRadius = 0.0f;					// Distance to the vertex furthest away from the center, which is tighter than the AABB's half diagonal
+	};
+
+	// Simplified version of a mesh. It's indices are appended after the base mesh's indices and reference the same vertices,
+	// so every LOD shares the mesh's vertex allocation and only needs a different set of draw ranges
+	struct MeshLOD
+	{
+		std::vector<Submesh> submeshes;		// Always the same number of submeshes as the base mesh, with the same vertex offsets and materials
+		float error = 0.0f;					// Largest simplification error of the submeshes, relative to the size of the mesh
+	};
+
 	struct BaseMesh
 	{
+		// Meshes are deleted through BaseMesh pointers, so we need the derived vertex vectors to be cleaned up too
+		virtual ~BaseMesh() { }
+
+		// The indices are always stored as IndexType on the CPU so all the import processing works on a single type. The indexType is
+		// the format of the GPU index buffer, and the indices are narrowed down when they're uploaded if it's VK_INDEX_TYPE_UINT16
 		std::vector<IndexType> indices;
+		VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+
+		// Every mesh has at least one submesh, and together they cover all the indices of the base mesh
+		std::vector<Submesh> submeshes;
+
+		// Ordered from most to least detailed, the base mesh is not part of this vector. Can be empty
+		std::vector<MeshLOD> lods;
+
+		MeshBounds bounds;
 	};
 
 	template<typename T>
@@ -245,6 +321,19 @@ namespace TANG
 		std::vector<T> vertices;
 	};
 
+	// Describes the asset's mesh, so it can still be queried after the CPU-side data is released
+	struct AssetMetadata
+	{
+		glm::vec3 boundsMin = glm::vec3(0.0f);		// Object-space AABB of the mesh
+		glm::vec3 boundsMax = glm::vec3(0.0f);
+		uint64_t vertexCount = 0;
+		uint64_t indexCount = 0;					// Includes the indices of the LODs
+		uint32_t vertexSize = 0;
+		uint32_t indexSize = 0;						// Of the index type the mesh is drawn with, see BaseMesh::indexType
+		uint32_t submeshCount = 0;
+		uint32_t lodCount = 0;
+	};
+
 	// The asset pipeline can be represented as follows: 
 	// 
 	//		Disk       ->       Core       ->       Renderer Resources
@@ -254,7 +343,8 @@ namespace TANG
 	// regardless of whether we're importing the asset (loading from pre-defined format such as .OBJ or .FBX) or
 	// reading the binary directly from our own file format (.TASSET).
 	// [AssetResources] is the representation of the asset that the renderer can use. The resources are created directly 
-	// from an AssetDisk instance, at which point we may (TODO) unload the AssetDisk instance.
+	// from an AssetDisk instance, at which point the CPU-side mesh and texture data may be released (see LoaderUtils::ReleaseCPUData()).
+	// Only the metadata and the material names stay around, and the data can be read back from the TASSET and TTEX caches on demand.
 	//
 	// Note that both AssetDisk and AssetResource instances share a UUID. This is used so that we know where the AssetResources
 	// came from, since the UUID from an AssetResource instance is guaranteed to be equivalent to the UUID from the AssetDisk instance
@@ -263,9 +353,15 @@ namespace TANG
 	{
 		UUID uuid;
 		std::string name;
-		BaseMesh* mesh;
+		BaseMesh* mesh;								// Null once the CPU-side data has been released
 		std::vector<Texture> textures;
-		std::vector<Material> materials;
+		std::vector<Material> materials;			// The material names are kept after the CPU-side data is released, but their textures are not
+		AssetMetadata metadata;
+	};
+
+	struct MaterialResources
+	{
+		std::vector<TextureResource*> textures;		// Every entry in this vector corresponds to a type of texture, specifically from Material::TEXTURE_TYPE. The resources are shared through the TextureRegistry
 	};
 
 	// TODO - Convert AssetResources into a structure of arrays, rather than an array of structs.
@@ -273,11 +369,21 @@ namespace TANG
 	struct AssetResources
 	{
 		UUID uuid;
-		VertexBuffer vertexBuffer;
-		uint32_t offset;							// Describes the offsets into a single combined buffer of vertex buffers, and the length of the offsets vector must match that of the vertex buffer vector!
-		IndexBuffer indexBuffer;
+		GeometryAllocation vertexAllocation;		// Sub-allocated from the GeometryArena, the vertex and index buffers are shared with other assets
+		GeometryAllocation indexAllocation;
+		int32_t vertexOffset = 0;					// Index of the first vertex within the vertex allocation's block, used when calling vkCmdDrawIndexed
+		uint32_t firstIndex = 0;					// Index of the first index within the index allocation's block, used when calling vkCmdDrawIndexed
 		uint64_t indexCount = 0;					// Used when calling vkCmdDrawIndexed
-		std::vector<TextureResource> material;		// Every entry in this vector corresponds to a type of texture, specifically from Material::TEXTURE_TYPE
+		VkIndexType indexType = VK_INDEX_TYPE_UINT32;	// Used when calling vkCmdBindIndexBuffer, it must match the format the index buffer was created with
+		std::vector<Submesh> submeshes;				// Same as the mesh's submeshes, except firstIndex and vertexOffset are relative to the start of the allocations' blocks
+		std::vector<MeshLOD> lods;					// Same as the mesh's LODs, with their submeshes offset the same way as above
+		uint32_t currentLOD = 0;					// Zero draws the base submeshes, anything else draws lods[currentLOD - 1]. Selected every frame from the screen size
+		std::vector<MaterialResources> materials;	// Indexed by Submesh::materialIndex, there is always at least one material
+		glm::vec3 boundsCenter = glm::vec3(0.0f);	// Bounding sphere of the mesh in object space (see MeshBounds), used for frustum culling and to estimate how large the asset is on screen
+		float boundsRadius = 0.0f;
+		uint64_t uploadValue = 0;					// Timeline value of the submission that uploads the asset's GPU resources, see UploadContext
+		UUID sharedUUID = INVALID_UUID;				// Copies of the same asset share their geometry, textures, descriptor sets and secondary command buffers under this key, and are drawn with a single instanced draw
+		uint32_t recordingGroup = 0;				// The asset's secondary command buffers are allocated from this group's recording pools, see CommandPoolRegistry::CreateRecordingPools()
 
 		// NOTE - The API user must update and keep track of the transform data for the assets,
 		//        and pass it to the renderer every frame for drawing. The design decision behind
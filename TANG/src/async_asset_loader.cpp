@@ -0,0 +1,220 @@
+
+#include "asset_loader.h"
+#include "async_asset_loader.h"
+#include "utils/logger.h"
+
+namespace TANG
+{
+	AsyncAssetLoader::AsyncAssetLoader() : nextHandle(INVALID_ASSET_LOAD_HANDLE + 1)
+	{
+	}
+
+	AsyncAssetLoader::~AsyncAssetLoader()
+	{
+		// Shutdown() is expected to be called explicitly before the program exits, but we
+		// must make sure the worker threads are joined regardless
+		threadPool.Destroy();
+	}
+
+	void AsyncAssetLoader::Initialize(uint32_t threadCount)
+	{
+		threadPool.Create(threadCount);
+		LogInfo("Created asset loader thread pool with %u threads", threadPool.GetThreadCount());
+	}
+
+	void AsyncAssetLoader::Shutdown()
+	{
+		// Joining the workers drops any queued loads, and waits for the ones in progress to finish
+		threadPool.Destroy();
+
+		std::lock_guard<std::mutex> lock(requestsMutex);
+
+		for (auto& request : completedRequests)
+		{
+			LoaderUtils::Discard(request->asset);
+			request->asset = nullptr;
+		}
+
+		for (auto& iter : requests)
+		{
+			AssetLoadState state = iter.second->state.load();
+			if (state != AssetLoadState::READY && state != AssetLoadState::FAILED)
+			{
+				iter.second->state = AssetLoadState::CANCELLED;
+			}
+		}
+
+		completedRequests.clear();
+		requests.clear();
+	}
+
+	AssetLoadHandle AsyncAssetLoader::Submit(std::string_view filePath)
+	{
+		std::shared_ptr<LoadRequest> request = std::make_shared<LoadRequest>();
+		request->filePath = filePath;
+		request->state = AssetLoadState::QUEUED;
+		request->cancelRequested = false;
+		request->asset = nullptr;
+		request->uuid = INVALID_UUID;
+
+		AssetLoadHandle handle;
+		{
+			std::lock_guard<std::mutex> lock(requestsMutex);
+			handle = nextHandle++;
+			requests.insert({ handle, request });
+		}
+
+		threadPool.Submit([this, request]() { ExecuteLoad(request); });
+
+		return handle;
+	}
+
+	bool AsyncAssetLoader::Cancel(AssetLoadHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(requestsMutex);
+
+		auto iter = requests.find(handle);
+		if (iter == requests.end())
+		{
+			LogWarning("Attempting to cancel an asset load with an invalid handle!");
+			return false;
+		}
+
+		LoadRequest* request = iter->second.get();
+
+		// If no worker has picked up the load yet we can cancel it right away
+		AssetLoadState expected = AssetLoadState::QUEUED;
+		if (request->state.compare_exchange_strong(expected, AssetLoadState::CANCELLED))
+		{
+			return true;
+		}
+
+		if (expected == AssetLoadState::LOADING || expected == AssetLoadState::PENDING_UPLOAD)
+		{
+			request->cancelRequested = true;
+			return true;
+		}
+
+		return false;
+	}
+
+	AssetLoadState AsyncAssetLoader::GetState(AssetLoadHandle handle) const
+	{
+		std::lock_guard<std::mutex> lock(requestsMutex);
+
+		auto iter = requests.find(handle);
+		if (iter == requests.end())
+		{
+			return AssetLoadState::INVALID;
+		}
+
+		// Report cancellation as soon as it's requested, even if a worker is still busy with the asset
+		const LoadRequest* request = iter->second.get();
+		if (request->cancelRequested)
+		{
+			return AssetLoadState::CANCELLED;
+		}
+
+		return request->state;
+	}
+
+	UUID AsyncAssetLoader::GetUUID(AssetLoadHandle handle) const
+	{
+		std::lock_guard<std::mutex> lock(requestsMutex);
+
+		auto iter = requests.find(handle);
+		if (iter == requests.end() || iter->second->state != AssetLoadState::READY)
+		{
+			return INVALID_UUID;
+		}
+
+		return iter->second->uuid;
+	}
+
+	void AsyncAssetLoader::Release(AssetLoadHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(requestsMutex);
+
+		auto iter = requests.find(handle);
+		if (iter == requests.end())
+		{
+			return;
+		}
+
+		// Any worker or completed-queue entry still holds a reference to the request, and will discard the asset
+		LoadRequest* request = iter->second.get();
+		AssetLoadState expected = AssetLoadState::QUEUED;
+		if (!request->state.compare_exchange_strong(expected, AssetLoadState::CANCELLED))
+		{
+			request->cancelRequested = true;
+		}
+
+		requests.erase(iter);
+	}
+
+	void AsyncAssetLoader::ProcessCompletedLoads(const FinalizeCallback& finalize, uint32_t maxCount)
+	{
+		std::deque<std::shared_ptr<LoadRequest>> toFinalize;
+		{
+			std::lock_guard<std::mutex> lock(requestsMutex);
+			while (!completedRequests.empty() && toFinalize.size() < maxCount)
+			{
+				toFinalize.push_back(std::move(completedRequests.front()));
+				completedRequests.pop_front();
+			}
+		}
+
+		for (auto& request : toFinalize)
+		{
+			if (request->cancelRequested)
+			{
+				LoaderUtils::Discard(request->asset);
+				request->asset = nullptr;
+				request->state = AssetLoadState::CANCELLED;
+				continue;
+			}
+
+			UUID uuid = finalize(request->asset);
+
+			// The asset is owned by the AssetContainer (or discarded by the callback) from here on
+			request->asset = nullptr;
+			request->uuid = uuid;
+			request->state = (uuid == INVALID_UUID) ? AssetLoadState::FAILED : AssetLoadState::READY;
+		}
+	}
+
+	ThreadPool& AsyncAssetLoader::GetThreadPool()
+	{
+		return threadPool;
+	}
+
+	void AsyncAssetLoader::ExecuteLoad(std::shared_ptr<LoadRequest> request)
+	{
+		// The load may have been cancelled while it was still queued
+		AssetLoadState expected = AssetLoadState::QUEUED;
+		if (!request->state.compare_exchange_strong(expected, AssetLoadState::LOADING))
+		{
+			return;
+		}
+
+		AssetDisk* asset = LoaderUtils::LoadFromDisk(request->filePath);
+		if (asset == nullptr)
+		{
+			LogError("Failed to asynchronously load asset '%s'", request->filePath.c_str());
+			request->state = AssetLoadState::FAILED;
+			return;
+		}
+
+		if (request->cancelRequested)
+		{
+			LoaderUtils::Discard(asset);
+			request->state = AssetLoadState::CANCELLED;
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(requestsMutex);
+		request->asset = asset;
+		request->state = AssetLoadState::PENDING_UPLOAD;
+		completedRequests.push_back(request);
+	}
+}
@@ -0,0 +1,112 @@
+#ifndef ASYNC_ASSET_LOADER_H
+#define ASYNC_ASSET_LOADER_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "utils/thread_pool.h"
+#include "utils/uuid.h"
+
+namespace TANG
+{
+	struct AssetDisk;
+
+	// Handle to an asynchronous asset load. It's only used to query or cancel the load, once the
+	// load is READY the asset is referred to by it's UUID like any other asset
+	typedef uint64_t AssetLoadHandle;
+
+	static constexpr AssetLoadHandle INVALID_ASSET_LOAD_HANDLE = 0;
+
+	enum class AssetLoadState
+	{
+		INVALID = -1,
+		QUEUED,				// Waiting for a worker thread to pick up the load
+		LOADING,			// Importing and decoding the asset on a worker thread
+		PENDING_UPLOAD,		// Loaded from disk, waiting for the render thread to create the GPU resources
+		READY,				// Fully loaded, the asset UUID may now be used
+		FAILED,
+		CANCELLED
+	};
+
+	// Loads assets from disk on a pool of worker threads. Only the disk-side work (import, TASSET reads and
+	// texture decoding) happens on the workers. Creating the renderer resources must happen on the render
+	// thread, so completed loads are handed back through ProcessCompletedLoads() which must be called once per frame
+	class AsyncAssetLoader
+	{
+	private:
+
+		AsyncAssetLoader();
+		~AsyncAssetLoader();
+
+	public:
+
+		// Called on the render thread for every asset that finished loading from disk. The callback is expected to register the
+		// asset and create it's renderer resources, and must return the asset UUID. On failure it must free the asset and return INVALID_UUID
+		using FinalizeCallback = std::function<UUID(AssetDisk*)>;
+
+		// Singletons should not be assignable nor copyable
+		AsyncAssetLoader(const AsyncAssetLoader& other) = delete;
+		void operator=(const AsyncAssetLoader& other) = delete;
+
+		static AsyncAssetLoader& GetInstance()
+		{
+			static AsyncAssetLoader instance;
+			return instance;
+		}
+
+		// A thread count of zero will use one thread per hardware thread, minus one
+		void Initialize(uint32_t threadCount);
+
+		// Cancels all in-flight loads and joins the worker threads. Assets that were already finalized are not affected
+		void Shutdown();
+
+		// Queues the asset at the provided path for loading and returns immediately
+		AssetLoadHandle Submit(std::string_view filePath);
+
+		// Requests that the load is cancelled. Loads that are queued are dropped immediately, while loads that are in progress
+		// are discarded as soon as the worker finishes with them. Returns false if the load had already finished or doesn't exist
+		bool Cancel(AssetLoadHandle handle);
+
+		AssetLoadState GetState(AssetLoadHandle handle) const;
+
+		// Returns the UUID of the loaded asset. This is INVALID_UUID unless the load is READY
+		UUID GetUUID(AssetLoadHandle handle) const;
+
+		// Forgets about a load. The handle becomes invalid, but the loaded asset (if any) remains alive. In-flight loads are cancelled
+		void Release(AssetLoadHandle handle);
+
+		// Calls the finalize callback for up to maxCount loads that are PENDING_UPLOAD. Must be called on the render thread
+		void ProcessCompletedLoads(const FinalizeCallback& finalize, uint32_t maxCount);
+
+		// Returns the thread pool used for asset loading, so that the loader can split up work further
+		ThreadPool& GetThreadPool();
+
+	private:
+
+		struct LoadRequest
+		{
+			std::string filePath;
+			std::atomic<AssetLoadState> state;
+			std::atomic<bool> cancelRequested;
+			AssetDisk* asset;
+			UUID uuid;
+		};
+
+		void ExecuteLoad(std::shared_ptr<LoadRequest> request);
+
+		std::unordered_map<AssetLoadHandle, std::shared_ptr<LoadRequest>> requests;
+		std::deque<std::shared_ptr<LoadRequest>> completedRequests;
+		mutable std::mutex requestsMutex;
+
+		ThreadPool threadPool;
+		AssetLoadHandle nextHandle;
+	};
+}
+
+#endif
@@ -1,6 +1,5 @@
 
 #include "../asset_types.h" // AssetResources
-#include "../data_buffer/index_buffer.h" // GetIndexType()
 #include "../device_cache.h"
 #include "../pipelines/base_pipeline.h" // BasePipeline
 #include "../utils/logger.h"
@@ -129,11 +128,12 @@ namespace TANG
 			return;
 		}
 
-		VkBuffer vertexBuffer = resources->vertexBuffer.GetBuffer();
-		VkDeviceSize offset = resources->offset;
+		// The arena blocks are always bound at offset zero, the draw call addresses the mesh through it's firstIndex and vertexOffset
+		VkBuffer vertexBuffer = resources->vertexAllocation.buffer;
+		VkDeviceSize offset = 0;
 
 		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
-		vkCmdBindIndexBuffer(commandBuffer, resources->indexBuffer.GetBuffer(), 0, resources->indexBuffer.GetIndexType());
+		vkCmdBindIndexBuffer(commandBuffer, resources->indexAllocation.buffer, 0, resources->indexType);
 	}
 
 	void CommandBuffer::CMD_BindDescriptorSets(const BasePipeline* pipeline, uint32_t descriptorSetCount, VkDescriptorSet* descriptorSets)
@@ -212,7 +212,7 @@ namespace TANG
 		vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
 	}
 
-	void CommandBuffer::CMD_DrawIndexed(uint64_t indexCount)
+	void CommandBuffer::CMD_DrawIndexed(uint64_t indexCount, uint32_t firstIndex, int32_t vertexOffset)
 	{
 		if (!IsCommandBufferValid() || !IsRecording())
 		{
@@ -225,10 +225,10 @@ namespace TANG
 			LogError("Index count in draw indexed call exceeds uint32_t::max allowed by Vulkan API call! Only a portion of the mesh will be rendered");
 		}
 
-		vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indexCount), 1, 0, 0, 0);
+		vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indexCount), 1, firstIndex, vertexOffset, 0);
 	}
 
-	void CommandBuffer::CMD_DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount)
+	void CommandBuffer::CMD_DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
 	{
 		if (!IsCommandBufferValid() || !IsRecording())
 		{
@@ -236,7 +236,18 @@ namespace TANG
 			return;
 		}
 
-		vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, 0, 0, 0);
+		vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+	}
+
+	void CommandBuffer::CMD_DrawIndexedIndirect(VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount)
+	{
+		if (!IsCommandBufferValid() || !IsRecording())
+		{
+			LogWarning("Failed to bind draw indexed indirect command! Command buffer is not recording");
+			return;
+		}
+
+		vkCmdDrawIndexedIndirect(commandBuffer, buffer, offset, drawCount, sizeof(VkDrawIndexedIndirectCommand));
 	}
 
 	void CommandBuffer::CMD_Dispatch(uint32_t x, uint32_t y, uint32_t z)
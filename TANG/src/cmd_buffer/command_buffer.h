@@ -50,8 +50,11 @@ namespace TANG
 		void CMD_SetScissor(VkOffset2D scissorOffset, VkExtent2D scissorExtent);
 
 		void CMD_Draw(uint32_t vertexCount);
-		void CMD_DrawIndexed(uint64_t indexCount);
-		void CMD_DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount);
+		void CMD_DrawIndexed(uint64_t indexCount, uint32_t firstIndex = 0, int32_t vertexOffset = 0);
+		void CMD_DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t firstInstance = 0);
+
+		// Draws with the VkDrawIndexedIndirectCommands that are tightly packed in the buffer, starting at the offset
+		void CMD_DrawIndexedIndirect(VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount = 1);
 
 		// Dispatch a command buffer to a compute shader
 		void CMD_Dispatch(uint32_t x, uint32_t y, uint32_t z);
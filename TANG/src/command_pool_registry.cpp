@@ -6,7 +6,7 @@
 
 namespace TANG
 {
-	CommandPoolRegistry::CommandPoolRegistry() : pools()
+	CommandPoolRegistry::CommandPoolRegistry() : pools(), recordingPools(), recordingGroupCount(0)
 	{
 	}
 
@@ -34,6 +34,53 @@ namespace TANG
 			vkDestroyCommandPool(logicalDevice, iter.second, nullptr);
 		}
 		pools.clear();
+
+		for (VkCommandPool pool : recordingPools)
+		{
+			vkDestroyCommandPool(logicalDevice, pool, nullptr);
+		}
+		recordingPools.clear();
+		recordingGroupCount = 0;
+	}
+
+	void CommandPoolRegistry::CreateRecordingPools(uint32_t groupCount, uint32_t frameCount)
+	{
+		TNG_ASSERT_MSG(groupCount > 0 && frameCount > 0, "Recording pool group and frame counts must be greater than zero!");
+
+		if (!recordingPools.empty())
+		{
+			LogWarning("Attempting to create recording command pools more than once!");
+			return;
+		}
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		poolInfo.queueFamilyIndex = DeviceCache::Get().GetQueueFamilyIndex(QueueType::GRAPHICS);
+
+		recordingPools.resize(static_cast<size_t>(groupCount) * frameCount, VK_NULL_HANDLE);
+		recordingGroupCount = groupCount;
+
+		for (VkCommandPool& pool : recordingPools)
+		{
+			if (vkCreateCommandPool(GetLogicalDevice(), &poolInfo, nullptr, &pool) != VK_SUCCESS)
+			{
+				LogError("Failed to create recording command pool!");
+			}
+		}
+	}
+
+	VkCommandPool CommandPoolRegistry::GetRecordingPool(uint32_t group, uint32_t frame) const
+	{
+		size_t index = static_cast<size_t>(frame) * recordingGroupCount + group;
+		if (group >= recordingGroupCount || index >= recordingPools.size()) return VK_NULL_HANDLE;
+
+		return recordingPools[index];
+	}
+
+	uint32_t CommandPoolRegistry::GetRecordingGroupCount() const
+	{
+		return recordingGroupCount;
 	}
 
 	VkCommandPool CommandPoolRegistry::GetCommandPool(QueueType type) const
@@ -48,7 +95,7 @@ namespace TANG
 
 	void CommandPoolRegistry::CreatePool_Helper(const QueueFamilyIndices& queueFamilyIndices, QueueType type, VkCommandPoolCreateFlags flags)
 	{
-		if (queueFamilyIndices.IsValid(static_cast<QueueFamilyIndices::QueueFamilyIndexType>(type)))
+		if (queueFamilyIndices.IsValid(queueFamilyIndices.GetIndex(type)))
 		{
 			// Allocate the pool object in the map
 			pools[type] = VkCommandPool();
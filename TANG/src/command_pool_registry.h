@@ -2,6 +2,7 @@
 #define COMMAND_POOL_REGISTRY_H
 
 #include <unordered_map>
+#include <vector>
 
 #include "queue_family_indices.h"
 #include "queue_types.h"
@@ -30,11 +31,21 @@ namespace TANG
 
 		VkCommandPool GetCommandPool(QueueType type) const;
 
+		// Creates one graphics pool per recording group and frame in flight, so secondary command buffers can be recorded from several
+		// threads at once. Command pools are externally synchronized, so every group's pool must only be used by one thread at a time.
+		// The pools are destroyed along with the rest in DestroyPools()
+		void CreateRecordingPools(uint32_t groupCount, uint32_t frameCount);
+
+		VkCommandPool GetRecordingPool(uint32_t group, uint32_t frame) const;
+		uint32_t GetRecordingGroupCount() const;
+
 	private:
 
 		void CreatePool_Helper(const QueueFamilyIndices& queueFamilyIndices, QueueType type, VkCommandPoolCreateFlags flags);
 
 		std::unordered_map<QueueType, VkCommandPool> pools;
+		std::vector<VkCommandPool> recordingPools;		// Indexed by (frame * recordingGroupCount + group)
+		uint32_t recordingGroupCount;
 
 	};
 
@@ -1,6 +1,7 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <array>
 #include <string>
 
 namespace TANG
@@ -24,9 +25,51 @@ namespace TANG
 		static const float BloomFilterRadius = 0.005f;
 
 		static const uint32_t MaxFramesInFlight = 2;
-		static const uint32_t MaxAssetCount = 100;
+		static const uint32_t MaxAssetCount = 100;					// Unique assets, copies of an asset share their descriptor sets
+		static const uint32_t MaxMaterialsPerAsset = 16;			// One texture descriptor set each
+		static const uint32_t MaxDrawnAssetsPerFrame = 4096;		// Size of the per-frame instance buffer
+
+		static const bool EnableGPUCulling = true;					// Compute frustum culling with indirect draws
+		static const uint32_t MaxIndirectDrawsPerFrame = 16384;		// One per submesh of every instance group
+
+		static const bool EnableFrustumCulling = true;				// CPU bounding sphere culling
+		static const bool EnableCullingBVH = false;					// Only pays off with tens of thousands of assets
+		static const float CullingBVHMargin = 0.25f;				// Fraction of the asset's radius
+
+		static const uint32_t RecordingThreadCount = 0;				// Zero uses one per hardware thread, minus one
+		static const uint32_t ParallelRecordingMinAssets = 32;
+
+		static const uint32_t AssetLoaderThreadCount = 0;			// Zero uses one per hardware thread, minus one
+		static const uint32_t MaxAsyncAssetFinalizesPerFrame = 2;
+		static const bool ReleaseCPUAssetDataAfterUpload = true;
 
 		static const std::string MaterialTexturesFilePath = "../src/data/textures/";
+		static const bool CompressMaterialTextures = true;	// BC7, BC5 for normal maps
+		static const bool CompressSkyboxTexture = true;		// BC6H
+
+		static const bool EnableTextureStreaming = true;
+		static const uint32_t TextureStreamingResidentMipSize = 128;			// Smaller mips are always resident
+		static const uint64_t TextureStreamingBudget = 1024ull * 1024 * 1024;
+		static const uint64_t TextureStreamingUploadBytesPerFrame = 16ull * 1024 * 1024;
+		static const int32_t TextureStreamingMipBias = 0;						// Positive values stream in less detail
+
+		static const float VertexWeldEpsilon = 1e-6f;		// Zero only merges identical vertices
+		static const bool OptimizeMeshesOnImport = true;
+		static const uint32_t VertexCacheSize = 16;			// In vertices
+
+		static const bool GenerateMeshLODs = true;
+		static const uint32_t MaxMeshLODs = 4;				// Not counting the base mesh
+		static const float MeshLODReduction = 0.5f;			// Fraction of the previous LOD's triangles
+		static const float MeshLODMaxError = 0.02f;			// Relative to the mesh's largest dimension
+		static const std::array<float, MaxMeshLODs> MeshLODScreenSizes = { 0.4f, 0.2f, 0.1f, 0.05f };	// Fractions of the screen height
+		static const float MeshLODHysteresis = 0.15f;
+
+		static const uint64_t GeometryArenaBlockSize = 64ull * 1024 * 1024;
+
+		static const uint64_t DeviceLocalBlockSize = 256ull * 1024 * 1024;
+		static const uint64_t HostVisibleBlockSize = 32ull * 1024 * 1024;
+		static const uint64_t StagingBlockSize = 64ull * 1024 * 1024;
+		static const uint64_t StagingRingSize = 64ull * 1024 * 1024;
 
 		static const std::string FullscreenQuadMeshFilePath = "../src/data/assets/fullscreen_quad.fbx";
 
@@ -1,13 +1,11 @@
 
-#include <limits>
-
 #include "buffer.h"
 #include "../utils/logger.h"
 #include "../device_cache.h"
 
 namespace TANG
 {
-	Buffer::Buffer() : buffer(VK_NULL_HANDLE), bufferMemory(VK_NULL_HANDLE), bufferSize(0), bufferState(BUFFER_STATE::DEFAULT)
+	Buffer::Buffer() : buffer(VK_NULL_HANDLE), allocation(), bufferSize(0), bufferState(BUFFER_STATE::DEFAULT)
 	{
 	}
 
@@ -16,7 +14,7 @@ namespace TANG
 		if (bufferState != BUFFER_STATE::MAPPED)
 		{
 			buffer = VK_NULL_HANDLE;
-			bufferMemory = VK_NULL_HANDLE;
+			allocation = DeviceAllocation();
 			bufferSize = 0;
 		}
 		else
@@ -37,7 +35,7 @@ namespace TANG
 		// Note that after this copy, there are two (or more) handles to the same buffer and it's associated memory
 		// Careful when trying to access the internal buffer, as other handles could delete this memory!
 		buffer = other.buffer;
-		bufferMemory = other.bufferMemory;
+		allocation = other.allocation;
 		bufferSize = other.bufferSize;
 		bufferState = other.bufferState;
 	}
@@ -51,13 +49,13 @@ namespace TANG
 		}
 
 		buffer = other.buffer;
-		bufferMemory = other.bufferMemory;
+		allocation = other.allocation;
 		bufferSize = other.bufferSize;
 		bufferState = other.bufferState;
 
 		// Remove references in other buffer
 		other.buffer = VK_NULL_HANDLE;
-		other.bufferMemory = VK_NULL_HANDLE;
+		other.allocation = DeviceAllocation();
 		other.bufferSize = 0;
 	}
 
@@ -77,7 +75,7 @@ namespace TANG
 		// Note that after this copy, there are two (or more) handles to the same buffer and it's associated memory
 		// Careful when trying to access the internal buffer, as other handles could delete this memory!
 		buffer = other.buffer;
-		bufferMemory = other.bufferMemory;
+		allocation = other.allocation;
 		bufferSize = other.bufferSize;
 		bufferState = other.bufferState;
 
@@ -95,10 +93,9 @@ namespace TANG
 		return buffer;
 	}
 
-	// Returns the member variable "bufferMemory"
-	VkDeviceMemory Buffer::GetBufferMemory()
+	const DeviceAllocation& Buffer::GetAllocation() const
 	{
-		return bufferMemory;
+		return allocation;
 	}
 
 	VkDeviceSize Buffer::GetBufferSize() const
@@ -111,14 +108,16 @@ namespace TANG
 		return bufferState == BUFFER_STATE::DEFAULT || bufferState == BUFFER_STATE::DESTROYED;
 	}
 
-	void Buffer::CopyFromBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+	void Buffer::CopyFromBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset, VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size)
 	{
 		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = srcOffset;
+		copyRegion.dstOffset = dstOffset;
 		copyRegion.size = size;
 		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
 	}
 
-	void Buffer::CreateBase(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+	void Buffer::CreateBase(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, MemoryPool pool)
 	{
 		VkDevice logicalDevice = GetLogicalDevice();
 
@@ -134,40 +133,30 @@ namespace TANG
 			return;
 		}
 
-		VkMemoryRequirements memRequirements;
-		vkGetBufferMemoryRequirements(logicalDevice, buffer, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-		if (vkAllocateMemory(logicalDevice, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
+		if (!DeviceAllocator::GetInstance().AllocateBufferMemory(buffer, pool, properties, allocation))
 		{
 			LogError("Failed to allocate memory for the buffer!");
+			vkDestroyBuffer(logicalDevice, buffer, nullptr);
+			buffer = VK_NULL_HANDLE;
 			return;
 		}
 
-		vkBindBufferMemory(logicalDevice, buffer, bufferMemory, 0);
-
 		bufferSize = size;
 
 		bufferState = BUFFER_STATE::CREATED;
 	}
 
-	uint32_t Buffer::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags memFlags)
+	void Buffer::DestroyBase()
 	{
-		VkPhysicalDeviceMemoryProperties memProperties = DeviceCache::Get().GetPhysicalDeviceMemoryProperties();
-
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+		if (buffer != VK_NULL_HANDLE)
 		{
-			if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & memFlags) == memFlags)
-			{
-				return i;
-			}
+			vkDestroyBuffer(GetLogicalDevice(), buffer, nullptr);
 		}
 
-		LogError("Failed to find suitable memory type!");
-		return std::numeric_limits<uint32_t>::max();
+		DeviceAllocator::GetInstance().Free(allocation);
+
+		buffer = VK_NULL_HANDLE;
+		bufferSize = 0;
+		bufferState = BUFFER_STATE::DESTROYED;
 	}
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include <vulkan/vulkan.h>
 
+#include "../device_allocator.h"
+
 namespace TANG
 {
 	enum class BUFFER_STATE
@@ -26,16 +28,15 @@ namespace TANG
 		// the type of buffer they are.
 		virtual void Create(VkDeviceSize size) = 0;
 
-		// Pure virtual function to destroy internal buffers plus any other buffers that the derived class may have allocated. For example
-		// the VertexBuffer derived class must delete it's internal staging buffer as well.
+		// Pure virtual function to destroy internal buffers plus any other buffers that the derived class may have allocated.
 		virtual void Destroy() = 0;
 
 		// Returns the member variable "buffer"
 		VkBuffer GetBuffer();
 		const VkBuffer GetBuffer() const;
 
-		// Returns the member variable "bufferMemory"
-		VkDeviceMemory GetBufferMemory();
+		// Returns the range of device memory the buffer is bound to. The memory is shared with other resources
+		const DeviceAllocation& GetAllocation() const;
 
 		// Returns the size of the created buffer
 		VkDeviceSize GetBufferSize() const;
@@ -46,20 +47,19 @@ namespace TANG
 	protected:
 
 		// Usually this function is called to copy data from a staging buffer, when copying data from the host (CPU) to device (GPU)
-		void CopyFromBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+		void CopyFromBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset, VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size);
 
-		// Notice the optional _buffer and _bufferMemory parameters. Derived classes may choose to create temporary buffers other
-		// than themselves (for example the vertex buffer creating a staging buffer) by filling out these parameters. If left as
-		// nullptr then the member variables will be filled out instead.
-		void CreateBase(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+		// Creates the buffer and binds it to memory from the provided pool of the DeviceAllocator. Buffers in the host-visible
+		// pools are persistently mapped, see DeviceAllocation::mappedData
+		void CreateBase(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, MemoryPool pool);
 
-		// Finds a suitable index considering the physical device's memory properties
-		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags memFlags);
+		// Destroys the buffer and returns it's memory to the DeviceAllocator
+		void DestroyBase();
 
 	protected:
 
 		VkBuffer buffer;
-		VkDeviceMemory bufferMemory;
+		DeviceAllocation allocation;
 		VkDeviceSize bufferSize;
 		BUFFER_STATE bufferState;
 	};
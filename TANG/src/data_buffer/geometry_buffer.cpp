@@ -0,0 +1,55 @@
+#include <utility> // std::move
+
+#include "../device_cache.h"
+#include "geometry_buffer.h"
+
+namespace TANG
+{
+	GeometryBuffer::GeometryBuffer() : Buffer()
+	{ }
+
+	GeometryBuffer::~GeometryBuffer()
+	{ }
+
+	GeometryBuffer::GeometryBuffer(const GeometryBuffer& other) : Buffer(other)
+	{ }
+
+	GeometryBuffer::GeometryBuffer(GeometryBuffer&& other) noexcept : Buffer(std::move(other))
+	{ }
+
+	GeometryBuffer& GeometryBuffer::operator=(const GeometryBuffer& other)
+	{
+		if (this == &other)
+		{
+			return *this;
+		}
+
+		Buffer::operator=(other);
+
+		return *this;
+	}
+
+	void GeometryBuffer::Create(VkDeviceSize size)
+	{
+		CreateBase(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryPool::DEVICE_LOCAL);
+	}
+
+	void GeometryBuffer::Destroy()
+	{
+		if (IsInvalid())
+		{
+			return;
+		}
+
+		DestroyBase();
+	}
+
+	void GeometryBuffer::CopyFromStagingBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkDeviceSize size)
+	{
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = srcOffset;
+		copyRegion.dstOffset = dstOffset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(commandBuffer, srcBuffer, buffer, 1, &copyRegion);
+	}
+}
@@ -0,0 +1,28 @@
+#ifndef GEOMETRY_BUFFER_H
+#define GEOMETRY_BUFFER_H
+
+#include "buffer.h"
+
+namespace TANG
+{
+	// Device-local buffer that can be bound both as a vertex buffer and as an index buffer. These are the large blocks the
+	// GeometryArena sub-allocates mesh data from. Data is copied in from the staging ring at arbitrary offsets
+	class GeometryBuffer : public Buffer
+	{
+	public:
+
+		GeometryBuffer();
+		~GeometryBuffer();
+		GeometryBuffer(const GeometryBuffer& other);
+		GeometryBuffer(GeometryBuffer&& other) noexcept;
+		GeometryBuffer& operator=(const GeometryBuffer& other);
+
+		void Create(VkDeviceSize size) override;
+		void Destroy() override;
+
+		// Records a copy of size bytes from the source buffer into this buffer
+		void CopyFromStagingBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkDeviceSize size);
+	};
+}
+
+#endif
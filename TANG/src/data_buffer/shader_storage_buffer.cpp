@@ -7,18 +7,19 @@
 namespace TANG
 {
 
-	ShaderStorageBuffer::ShaderStorageBuffer(VkBufferUsageFlags _extraUsage) : Buffer(), extraUsage(_extraUsage)
+	ShaderStorageBuffer::ShaderStorageBuffer(VkBufferUsageFlags _extraUsage, bool _hostVisible) : Buffer(), extraUsage(_extraUsage), hostVisible(_hostVisible)
 	{ }
 
 	ShaderStorageBuffer::~ShaderStorageBuffer()
 	{ }
 
-	ShaderStorageBuffer::ShaderStorageBuffer(const ShaderStorageBuffer& other) : Buffer(other), extraUsage(other.extraUsage)
+	ShaderStorageBuffer::ShaderStorageBuffer(const ShaderStorageBuffer& other) : Buffer(other), extraUsage(other.extraUsage), hostVisible(other.hostVisible)
 	{ }
 
-	ShaderStorageBuffer::ShaderStorageBuffer(ShaderStorageBuffer&& other) noexcept : Buffer(std::move(other)), extraUsage(std::move(other.extraUsage))
+	ShaderStorageBuffer::ShaderStorageBuffer(ShaderStorageBuffer&& other) noexcept : Buffer(std::move(other)), extraUsage(std::move(other.extraUsage)), hostVisible(other.hostVisible)
 	{
-		extraUsage = 0;
+		other.extraUsage = 0;
+		other.hostVisible = false;
 	}
 
 	ShaderStorageBuffer& ShaderStorageBuffer::operator=(const ShaderStorageBuffer& other)
@@ -30,15 +31,22 @@ namespace TANG
 
 		Buffer::operator=(other);
 		extraUsage = other.extraUsage;
+		hostVisible = other.hostVisible;
 
 		return *this;
 	}
 
 	void ShaderStorageBuffer::Create(VkDeviceSize size)
 	{
+		if (hostVisible)
+		{
+			CreateBase(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | extraUsage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, MemoryPool::HOST_VISIBLE);
+			return;
+		}
+
 		// We're creating a device local buffer (meaning local to the GPU). Therefore, we need to ensure it's usage is set to TRANSFER_DST
 		// because we need to transfer data from the host (CPU) to this device local buffer
-		CreateBase(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | extraUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		CreateBase(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | extraUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryPool::DEVICE_LOCAL);
 	}
 
 	void ShaderStorageBuffer::Destroy()
@@ -49,15 +57,11 @@ namespace TANG
 			return;
 		}
 
-		VkDevice logicalDevice = GetLogicalDevice();
-
-		vkUnmapMemory(logicalDevice, bufferMemory);
-		vkDestroyBuffer(logicalDevice, buffer, nullptr);
-		vkFreeMemory(logicalDevice, bufferMemory, nullptr);
+		DestroyBase();
+	}
 
-		buffer = VK_NULL_HANDLE;
-		bufferMemory = VK_NULL_HANDLE;
-		bufferSize = 0;
-		bufferState = BUFFER_STATE::DESTROYED;
+	void* ShaderStorageBuffer::GetMappedData()
+	{
+		return hostVisible ? allocation.mappedData : nullptr;
 	}
 }
\ No newline at end of file
@@ -9,8 +9,9 @@ namespace TANG
 	{
 	public:
 
-		// Defines any usage for this buffer other than the mandatory STORAGE_BUFFER_BIT and TRANSFER_DST_BIT
-		ShaderStorageBuffer(VkBufferUsageFlags extraUsage = 0);
+		// Defines any usage for this buffer other than the mandatory STORAGE_BUFFER_BIT and TRANSFER_DST_BIT. Host-visible buffers are
+		// persistently mapped and written directly by the CPU (see GetMappedData()), which is meant for data that changes every frame
+		ShaderStorageBuffer(VkBufferUsageFlags extraUsage = 0, bool hostVisible = false);
 		~ShaderStorageBuffer();
 		ShaderStorageBuffer(const ShaderStorageBuffer& other);
 		ShaderStorageBuffer(ShaderStorageBuffer&& other) noexcept;
@@ -19,9 +20,13 @@ namespace TANG
 		void Create(VkDeviceSize size) override;
 		void Destroy() override;
 
+		// Returns nullptr unless the buffer is host-visible
+		void* GetMappedData();
+
 	private:
 
 		VkBufferUsageFlags extraUsage;
+		bool hostVisible;
 		
 	};
 }
@@ -32,38 +32,24 @@ namespace TANG
 
 	void StagingBuffer::Create(VkDeviceSize size)
 	{
-		CreateBase(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		CreateBase(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, MemoryPool::STAGING);
 	}
 
 	void StagingBuffer::Destroy()
 	{
-		VkDevice logicalDevice = GetLogicalDevice();
-
-		if(buffer) vkDestroyBuffer(logicalDevice, buffer, nullptr);
-		if(bufferMemory) vkFreeMemory(logicalDevice, bufferMemory, nullptr);
-
-		buffer = VK_NULL_HANDLE;
-		bufferMemory = VK_NULL_HANDLE;
-
-		bufferState = BUFFER_STATE::DESTROYED;
+		DestroyBase();
 	}
 
 	void StagingBuffer::CopyIntoBuffer(void* sourceData, VkDeviceSize size)
 	{
-		VkDevice logicalDevice = GetLogicalDevice();
-
 		if (IsInvalid())
 		{
 			LogWarning("Attempting to copy into invalid staging buffer!");
 			return;
 		}
 
-		void* bufferPtr;
-		VkResult res = vkMapMemory(logicalDevice, bufferMemory, 0, size, 0, &bufferPtr);
-		if (res != VK_SUCCESS)
-		{
-			LogError("Failed to map memory for staging buffer!");
-		}
+		// Staging memory is persistently mapped by the DeviceAllocator
+		void* bufferPtr = allocation.mappedData;
 
 		if (IsMemoryOverlapping(bufferPtr, sourceData, size))
 		{
@@ -76,8 +62,6 @@ namespace TANG
 			// Memory regions DON'T overlap, use memcpy()
 			memcpy_s(bufferPtr, size, sourceData, size);
 		}
-
-		vkUnmapMemory(logicalDevice, bufferMemory);
 	}
 
 }
\ No newline at end of file
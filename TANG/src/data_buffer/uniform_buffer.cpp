@@ -4,6 +4,7 @@
 
 #include "../device_cache.h"
 #include "../utils/logger.h"
+#include "../utils/sanity_check.h"
 #include "uniform_buffer.h"
 
 namespace TANG
@@ -42,40 +43,23 @@ namespace TANG
 			LogWarning("Creating uniform buffer of size %u, which is less than the preferred minimum of %u. Prefer push constants instead!", size, maxPushConstantSize);
 		}
 
-		CreateBase(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		CreateBase(size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, MemoryPool::HOST_VISIBLE);
 		bufferSize = size;
 	}
 
 	void UniformBuffer::Destroy()
 	{
-		VkDevice logicalDevice = GetLogicalDevice();
-
-		if (mappedData != nullptr)
-		{
-			vkUnmapMemory(logicalDevice, bufferMemory);
-		}
-
-		bufferSize = 0;
 		mappedData = nullptr;
 
-		vkDestroyBuffer(logicalDevice, buffer, nullptr);
-		vkFreeMemory(logicalDevice, bufferMemory, nullptr);
-
-		buffer = VK_NULL_HANDLE;
-		bufferMemory = VK_NULL_HANDLE;
-
-		bufferState = BUFFER_STATE::DESTROYED;
+		DestroyBase();
 	}
 
 	void UniformBuffer::MapMemory(VkDeviceSize size)
 	{
-		// If a size of 0 is specified, then we assume the caller wants to map the entirety of the buffer size (as opposed to a portion)
-		if (size == 0)
-		{
-			size = bufferSize;
-		}
+		// The memory is persistently mapped by the DeviceAllocator, so there's no need to map a smaller range
+		UNUSED(size);
 
-		vkMapMemory(GetLogicalDevice(), bufferMemory, 0, size, 0, &mappedData);
+		mappedData = allocation.mappedData;
 		bufferState = BUFFER_STATE::MAPPED;
 	}
 
@@ -87,7 +71,6 @@ namespace TANG
 			return;
 		}
 
-		vkUnmapMemory(GetLogicalDevice(), bufferMemory);
 		bufferState = BUFFER_STATE::CREATED;
 		mappedData = nullptr;
 	}
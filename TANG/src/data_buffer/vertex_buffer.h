@@ -1,10 +1,12 @@
 #ifndef VERTEX_BUFFER_H
 #define VERTEX_BUFFER_H
 
-#include "staging_buffer.h"
+#include "buffer.h"
 
 namespace TANG
 {
+	class UploadContext;
+
 	class VertexBuffer : public Buffer
 	{
 	public:
@@ -19,14 +21,8 @@ namespace TANG
 
 		void Destroy() override;
 
-		void DestroyIntermediateBuffers();
-
-		void CopyIntoBuffer(VkCommandBuffer commandBuffer, void* sourceData, VkDeviceSize size);
-
-	private:
-
-		// Store the staging buffer so that we can delete it properly after ending and submitting the command buffer
-		StagingBuffer stagingBuffer;
+		// Stages the data through the staging ring and records the copy into this buffer. The data is uploaded once the context is submitted
+		bool CopyIntoBuffer(UploadContext& context, const void* sourceData, VkDeviceSize size);
 	};
 }
 
@@ -57,6 +57,7 @@ namespace TANG
 		{ Material::TEXTURE_TYPE::METALLIC,				Color_GrayscaleAsFloat(0.15f, 1.0f) },		// Low metallic
 		{ Material::TEXTURE_TYPE::ROUGHNESS,			Color_GrayscaleAsFloat(0.33f, 1.0f) },		// High roughness
 		{ Material::TEXTURE_TYPE::LIGHTMAP,				Color_GrayscaleAsFloat(1.0f, 1.0f) },		// ???? I don't even know what this is, to be honest
+		{ Material::TEXTURE_TYPE::ORM,					Color_AsFloat(1.0f, 0.33f, 0.15f, 1.0f) },	// Same as the individual occlusion, roughness and metallic values above
 		{ Material::TEXTURE_TYPE::_COUNT,				Color_GrayscaleAsFloat(0.0f, 0.0f) },		// Invalid
 	};
 }
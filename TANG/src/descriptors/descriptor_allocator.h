@@ -33,7 +33,6 @@ namespace TANG
 				{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1.f },
 				{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.f },
 				{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.f },
-				{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.f },
 				{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.f },
 				{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.5f }
 			};
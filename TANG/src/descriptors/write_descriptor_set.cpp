@@ -1,5 +1,6 @@
 
 #include "../utils/logger.h"
+#include "../data_buffer/shader_storage_buffer.h"
 #include "../data_buffer/uniform_buffer.h"
 #include "write_descriptor_set.h"
 
@@ -64,6 +65,34 @@ namespace TANG
 		numBuffers--;
 	}
 
+	void WriteDescriptorSets::AddStorageBuffer(VkDescriptorSet descriptorSet, uint32_t binding, const ShaderStorageBuffer* storageBuffer, VkDeviceSize offset)
+	{
+		if (numBuffers == 0)
+		{
+			LogError("Failed to add storage buffer to WriteDescriptorSet. Exceeded the number of promised buffers!");
+			return;
+		}
+
+		descriptorBufferInfo.push_back(VkDescriptorBufferInfo());
+		VkDescriptorBufferInfo& bufferInfo = descriptorBufferInfo.back();
+		bufferInfo.buffer = storageBuffer->GetBuffer();
+		bufferInfo.offset = offset;
+		bufferInfo.range = storageBuffer->GetBufferSize() - offset;
+
+		VkWriteDescriptorSet writeDescSet{};
+		writeDescSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescSet.dstSet = descriptorSet;
+		writeDescSet.dstBinding = binding;
+		writeDescSet.dstArrayElement = 0;
+		writeDescSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescSet.descriptorCount = 1;
+		writeDescSet.pBufferInfo = &bufferInfo;
+
+		writeDescriptorSets.push_back(writeDescSet);
+
+		numBuffers--;
+	}
+
 	void WriteDescriptorSets::AddImage(VkDescriptorSet descriptorSet, uint32_t binding, const TextureResource* texResource, VkDescriptorType type, uint32_t imageViewIndex)
 	{
 		// We'll return in this case because the internal temporary vectors that hold the buffers and images will be forced to
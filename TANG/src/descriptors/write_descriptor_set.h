@@ -9,6 +9,7 @@
 namespace TANG
 {
 	// Forward declarations
+	class ShaderStorageBuffer;
 	class UniformBuffer;
 
 	// Encapsulates the data and functionality for creating a WriteDescriptorSet
@@ -24,6 +25,9 @@ namespace TANG
 		WriteDescriptorSets& operator=(const WriteDescriptorSets& other) = delete;
 
 		void AddUniformBuffer(VkDescriptorSet descriptorSet, uint32_t binding, const UniformBuffer* uniformBuffer, VkDeviceSize offset = 0);
+
+		// Binds the storage buffer from the offset until it's end. Storage buffers count towards the same bufferCount as uniform buffers
+		void AddStorageBuffer(VkDescriptorSet descriptorSet, uint32_t binding, const ShaderStorageBuffer* storageBuffer, VkDeviceSize offset = 0);
 		void AddImage(VkDescriptorSet descriptorSet, uint32_t binding, const TextureResource* texResource, VkDescriptorType type, uint32_t imageViewIndex);
 
 		uint32_t GetWriteDescriptorSetCount() const;
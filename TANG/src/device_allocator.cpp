@@ -0,0 +1,399 @@
+
+#include <algorithm>
+
+#include "config.h"
+#include "device_allocator.h"
+#include "device_cache.h"
+#include "utils/logger.h"
+#include "utils/sanity_check.h"
+
+namespace TANG
+{
+	static const char* GetPoolName(MemoryPool pool)
+	{
+		switch (pool)
+		{
+		case MemoryPool::DEVICE_LOCAL:	return "device-local";
+		case MemoryPool::HOST_VISIBLE:	return "host-visible";
+		case MemoryPool::STAGING:		return "staging";
+		default: break;
+		}
+
+		return "invalid";
+	}
+
+	DeviceAllocator::DeviceAllocator() : blocks(), memoryProperties(), deviceMemoryCount(0)
+	{
+	}
+
+	DeviceAllocator::~DeviceAllocator()
+	{
+		if (deviceMemoryCount > 0)
+		{
+			LogWarning("Device allocator destroyed with %u blocks still alive!", deviceMemoryCount);
+		}
+	}
+
+	void DeviceAllocator::Create()
+	{
+		memoryProperties = DeviceCache::Get().GetPhysicalDeviceMemoryProperties();
+	}
+
+	void DeviceAllocator::Destroy()
+	{
+		uint32_t allocationCount = 0;
+		for (uint32_t i = 0; i < static_cast<uint32_t>(blocks.size()); i++)
+		{
+			if (blocks[i].memory == VK_NULL_HANDLE) continue;
+
+			allocationCount += blocks[i].allocationCount;
+			DestroyBlock(i);
+		}
+
+		if (allocationCount > 0)
+		{
+			LogWarning("Destroying device allocator with %u allocations still alive!", allocationCount);
+		}
+
+		blocks.clear();
+	}
+
+	bool DeviceAllocator::AllocateBufferMemory(VkBuffer buffer, MemoryPool pool, VkMemoryPropertyFlags properties, DeviceAllocation& outAllocation)
+	{
+		VkDevice logicalDevice = GetLogicalDevice();
+
+		VkMemoryRequirements requirements;
+		vkGetBufferMemoryRequirements(logicalDevice, buffer, &requirements);
+
+		if (!Allocate(requirements, pool, properties, false, outAllocation))
+		{
+			return false;
+		}
+
+		if (vkBindBufferMemory(logicalDevice, buffer, outAllocation.memory, outAllocation.offset) != VK_SUCCESS)
+		{
+			LogError("Failed to bind buffer memory!");
+			Free(outAllocation);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool DeviceAllocator::AllocateImageMemory(VkImage image, MemoryPool pool, VkMemoryPropertyFlags properties, DeviceAllocation& outAllocation)
+	{
+		VkDevice logicalDevice = GetLogicalDevice();
+
+		VkMemoryRequirements requirements;
+		vkGetImageMemoryRequirements(logicalDevice, image, &requirements);
+
+		if (!Allocate(requirements, pool, properties, true, outAllocation))
+		{
+			return false;
+		}
+
+		if (vkBindImageMemory(logicalDevice, image, outAllocation.memory, outAllocation.offset) != VK_SUCCESS)
+		{
+			LogError("Failed to bind image memory!");
+			Free(outAllocation);
+			return false;
+		}
+
+		return true;
+	}
+
+	void DeviceAllocator::Free(DeviceAllocation& allocation)
+	{
+		if (!allocation.IsValid())
+		{
+			return;
+		}
+
+		if (allocation.block >= blocks.size() || blocks[allocation.block].memory != allocation.memory)
+		{
+			LogWarning("Attempting to free device allocation from non-existent block %u!", allocation.block);
+			allocation = DeviceAllocation();
+			return;
+		}
+
+		Block& block = blocks[allocation.block];
+		std::vector<FreeRange>& freeRanges = block.freeRanges;
+
+		// Insert the range in order, and merge it with it's neighbours if they're adjacent
+		auto next = std::lower_bound(freeRanges.begin(), freeRanges.end(), allocation.offset,
+			[](const FreeRange& range, VkDeviceSize offset) { return range.offset < offset; });
+		auto iter = freeRanges.insert(next, { allocation.offset, allocation.size });
+
+		auto following = iter + 1;
+		if (following != freeRanges.end() && iter->offset + iter->size == following->offset)
+		{
+			iter->size += following->size;
+			iter = freeRanges.erase(following) - 1;
+		}
+
+		if (iter != freeRanges.begin())
+		{
+			auto previous = iter - 1;
+			if (previous->offset + previous->size == iter->offset)
+			{
+				previous->size += iter->size;
+				freeRanges.erase(iter);
+			}
+		}
+
+		block.allocationCount--;
+		block.allocatedBytes -= allocation.size;
+
+		if (block.allocationCount == 0 && (block.isDedicated || HasSpareBlock(allocation.block)))
+		{
+			DestroyBlock(allocation.block);
+		}
+
+		allocation = DeviceAllocation();
+	}
+
+	DeviceAllocatorStatistics DeviceAllocator::GetStatistics() const
+	{
+		DeviceAllocatorStatistics stats;
+		for (const Block& block : blocks)
+		{
+			if (block.memory == VK_NULL_HANDLE) continue;
+
+			DeviceMemoryPoolStatistics& poolStats = stats.pools[static_cast<size_t>(block.pool)];
+			poolStats.blockCount++;
+			poolStats.allocationCount += block.allocationCount;
+			poolStats.allocatedBytes += block.allocatedBytes;
+			poolStats.capacityBytes += block.size;
+		}
+
+		stats.deviceMemoryCount = deviceMemoryCount;
+		return stats;
+	}
+
+	bool DeviceAllocator::Allocate(const VkMemoryRequirements& requirements, MemoryPool pool, VkMemoryPropertyFlags properties, bool isImage, DeviceAllocation& outAllocation)
+	{
+		TNG_ASSERT_MSG((pool == MemoryPool::DEVICE_LOCAL || (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)), "Host-visible pools require host-visible memory!");
+
+		if (requirements.size == 0)
+		{
+			LogError("Invalid device allocation of 0 bytes!");
+			return false;
+		}
+
+		uint32_t memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, properties);
+		if (memoryTypeIndex == std::numeric_limits<uint32_t>::max())
+		{
+			return false;
+		}
+
+		VkDeviceSize blockSize = GetBlockSize(pool);
+		bool isDedicated = requirements.size > blockSize / 2;
+
+		if (!isDedicated)
+		{
+			for (uint32_t i = 0; i < static_cast<uint32_t>(blocks.size()); i++)
+			{
+				const Block& block = blocks[i];
+				if (block.memory == VK_NULL_HANDLE || block.isDedicated || block.memoryTypeIndex != memoryTypeIndex || block.pool != pool || block.isImageBlock != isImage)
+				{
+					continue;
+				}
+
+				if (AllocateFromBlock(i, requirements.size, requirements.alignment, outAllocation))
+				{
+					return true;
+				}
+			}
+		}
+
+		// No block has enough space left, so we create a new one. A new block is empty, so the allocation always starts at offset zero
+		uint32_t blockIndex = CreateBlock(isDedicated ? requirements.size : blockSize, memoryTypeIndex, pool, isImage, isDedicated);
+		if (blockIndex == DeviceAllocation::INVALID_BLOCK)
+		{
+			return false;
+		}
+
+		return AllocateFromBlock(blockIndex, requirements.size, requirements.alignment, outAllocation);
+	}
+
+	bool DeviceAllocator::AllocateFromBlock(uint32_t blockIndex, VkDeviceSize size, VkDeviceSize alignment, DeviceAllocation& outAllocation)
+	{
+		Block& block = blocks[blockIndex];
+		std::vector<FreeRange>& freeRanges = block.freeRanges;
+
+		for (auto iter = freeRanges.begin(); iter != freeRanges.end(); iter++)
+		{
+			VkDeviceSize alignedOffset = ((iter->offset + alignment - 1) / alignment) * alignment;
+			VkDeviceSize padding = alignedOffset - iter->offset;
+			if (padding + size > iter->size)
+			{
+				continue;
+			}
+
+			// Split the free range into the (optional) padding before the allocation and the (optional) remainder after it
+			VkDeviceSize rangeEnd = iter->offset + iter->size;
+			VkDeviceSize allocationEnd = alignedOffset + size;
+
+			if (padding > 0)
+			{
+				iter->size = padding;
+				if (allocationEnd < rangeEnd)
+				{
+					freeRanges.insert(iter + 1, { allocationEnd, rangeEnd - allocationEnd });
+				}
+			}
+			else if (allocationEnd < rangeEnd)
+			{
+				iter->offset = allocationEnd;
+				iter->size = rangeEnd - allocationEnd;
+			}
+			else
+			{
+				freeRanges.erase(iter);
+			}
+
+			outAllocation.memory = block.memory;
+			outAllocation.offset = alignedOffset;
+			outAllocation.size = size;
+			outAllocation.mappedData = block.mappedData != nullptr ? static_cast<char*>(block.mappedData) + alignedOffset : nullptr;
+			outAllocation.block = blockIndex;
+
+			block.allocationCount++;
+			block.allocatedBytes += size;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	uint32_t DeviceAllocator::CreateBlock(VkDeviceSize size, uint32_t memoryTypeIndex, MemoryPool pool, bool isImage, bool isDedicated)
+	{
+		VkDevice logicalDevice = GetLogicalDevice();
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		if (vkAllocateMemory(logicalDevice, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+		{
+			LogError("Failed to allocate %llu bytes of %s device memory!", size, GetPoolName(pool));
+			return DeviceAllocation::INVALID_BLOCK;
+		}
+
+		// Host-visible blocks stay mapped for as long as they're alive, since memory can't be mapped more than once at a time and
+		// several resources share the same block
+		void* mappedData = nullptr;
+		if (pool != MemoryPool::DEVICE_LOCAL && vkMapMemory(logicalDevice, memory, 0, VK_WHOLE_SIZE, 0, &mappedData) != VK_SUCCESS)
+		{
+			LogError("Failed to map %s device memory block!", GetPoolName(pool));
+			vkFreeMemory(logicalDevice, memory, nullptr);
+			return DeviceAllocation::INVALID_BLOCK;
+		}
+
+		// Re-use the slot of a destroyed block if there is one, so the block indices of existing allocations stay valid
+		uint32_t blockIndex = 0;
+		while (blockIndex < blocks.size() && blocks[blockIndex].memory != VK_NULL_HANDLE)
+		{
+			blockIndex++;
+		}
+
+		if (blockIndex == blocks.size())
+		{
+			blocks.emplace_back();
+		}
+
+		Block& block = blocks[blockIndex];
+		block.memory = memory;
+		block.size = size;
+		block.mappedData = mappedData;
+		block.memoryTypeIndex = memoryTypeIndex;
+		block.pool = pool;
+		block.isImageBlock = isImage;
+		block.isDedicated = isDedicated;
+		block.freeRanges.clear();
+		block.freeRanges.push_back({ 0, size });
+		block.allocationCount = 0;
+		block.allocatedBytes = 0;
+
+		deviceMemoryCount++;
+
+		if (!isDedicated)
+		{
+			LogInfo("Created %s device memory block %u (%llu bytes, memory type %u)", GetPoolName(pool), blockIndex, size, memoryTypeIndex);
+		}
+
+		return blockIndex;
+	}
+
+	void DeviceAllocator::DestroyBlock(uint32_t blockIndex)
+	{
+		VkDevice logicalDevice = GetLogicalDevice();
+
+		Block& block = blocks[blockIndex];
+		if (block.mappedData != nullptr)
+		{
+			vkUnmapMemory(logicalDevice, block.memory);
+		}
+
+		vkFreeMemory(logicalDevice, block.memory, nullptr);
+
+		block.memory = VK_NULL_HANDLE;
+		block.mappedData = nullptr;
+		block.freeRanges.clear();
+		block.allocationCount = 0;
+		block.allocatedBytes = 0;
+
+		deviceMemoryCount--;
+	}
+
+	bool DeviceAllocator::HasSpareBlock(uint32_t blockIndex) const
+	{
+		const Block& block = blocks[blockIndex];
+		for (uint32_t i = 0; i < static_cast<uint32_t>(blocks.size()); i++)
+		{
+			const Block& other = blocks[i];
+			if (i == blockIndex || other.memory == VK_NULL_HANDLE || other.isDedicated || other.allocationCount > 0)
+			{
+				continue;
+			}
+
+			if (other.memoryTypeIndex == block.memoryTypeIndex && other.pool == block.pool && other.isImageBlock == block.isImageBlock)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	uint32_t DeviceAllocator::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+	{
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+		{
+			if (typeFilter & (1 << i) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+			{
+				return i;
+			}
+		}
+
+		LogError("Failed to find suitable memory type!");
+		return std::numeric_limits<uint32_t>::max();
+	}
+
+	VkDeviceSize DeviceAllocator::GetBlockSize(MemoryPool pool)
+	{
+		switch (pool)
+		{
+		case MemoryPool::DEVICE_LOCAL:	return CONFIG::DeviceLocalBlockSize;
+		case MemoryPool::HOST_VISIBLE:	return CONFIG::HostVisibleBlockSize;
+		case MemoryPool::STAGING:		return CONFIG::StagingBlockSize;
+		default: break;
+		}
+
+		TNG_ASSERT_MSG(false, "Invalid memory pool!");
+		return CONFIG::DeviceLocalBlockSize;
+	}
+}
@@ -0,0 +1,135 @@
+#ifndef DEVICE_ALLOCATOR_H
+#define DEVICE_ALLOCATOR_H
+
+#include <array>
+#include <limits>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace TANG
+{
+	// The pools are kept in separate blocks so resources with very different lifetimes don't fragment each other
+	enum class MemoryPool : uint32_t
+	{
+		DEVICE_LOCAL = 0,	// Resources that are only accessed by the GPU, such as vertex buffers and textures
+		HOST_VISIBLE,		// Long-lived resources written by the CPU, such as uniform buffers
+		STAGING,			// Short-lived buffers used to upload data to device-local resources
+		_COUNT				// DO NOT USE. THIS MUST COME LAST
+	};
+
+	// A range of device memory sub-allocated by the DeviceAllocator. The memory handle is shared with every other allocation in the
+	// same block, so it must never be freed or mapped directly
+	struct DeviceAllocation
+	{
+		static constexpr uint32_t INVALID_BLOCK = std::numeric_limits<uint32_t>::max();
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+		void* mappedData = nullptr;		// Points to the start of the allocation. Only set for the host-visible pools, which are persistently mapped
+		uint32_t block = INVALID_BLOCK;
+
+		bool IsValid() const { return block != INVALID_BLOCK; }
+	};
+
+	struct DeviceMemoryPoolStatistics
+	{
+		uint32_t blockCount = 0;
+		uint32_t allocationCount = 0;
+		VkDeviceSize allocatedBytes = 0;
+		VkDeviceSize capacityBytes = 0;
+	};
+
+	struct DeviceAllocatorStatistics
+	{
+		std::array<DeviceMemoryPoolStatistics, static_cast<size_t>(MemoryPool::_COUNT)> pools;
+		uint32_t deviceMemoryCount = 0;		// Number of live vkAllocateMemory() allocations, which is limited by maxMemoryAllocationCount
+	};
+
+	// Global allocator that backs every Buffer and TextureResource. Instead of calling vkAllocateMemory() per resource, memory is
+	// allocated in large blocks per memory type and pool (see CONFIG::DeviceLocalBlockSize and friends), and resources are bound to
+	// ranges of those blocks. Like the GeometryArena, freed ranges are coalesced and reused using a first-fit free list per block.
+	// Buffers and optimally-tiled images never share a block, so bufferImageGranularity never has to be taken into account. Allocations
+	// larger than half the block size get a dedicated block of their own. Empty blocks are freed, except for one per memory type and pool
+	// so resources that are created and destroyed every now and then don't keep allocating device memory. Must only be used from the render thread
+	class DeviceAllocator
+	{
+	private:
+
+		DeviceAllocator();
+		~DeviceAllocator();
+
+	public:
+
+		// Singletons should not be assignable nor copyable
+		DeviceAllocator(const DeviceAllocator& other) = delete;
+		void operator=(const DeviceAllocator& other) = delete;
+
+		static DeviceAllocator& GetInstance()
+		{
+			static DeviceAllocator instance;
+			return instance;
+		}
+
+		// Caches the memory properties of the physical device. Must be called after the logical device is created
+		void Create();
+
+		// Frees all the blocks, regardless of whether there are allocations still alive. Must be called before the logical device is destroyed
+		void Destroy();
+
+		// Allocates memory that satisfies the requirements of the buffer and binds it. The host-visible and staging pools require
+		// HOST_VISIBLE memory. Returns false if no memory could be allocated, in which case the buffer is left unbound
+		bool AllocateBufferMemory(VkBuffer buffer, MemoryPool pool, VkMemoryPropertyFlags properties, DeviceAllocation& outAllocation);
+
+		// Same as above, for optimally-tiled images
+		bool AllocateImageMemory(VkImage image, MemoryPool pool, VkMemoryPropertyFlags properties, DeviceAllocation& outAllocation);
+
+		// Returns the range to it's block's free list, and resets the allocation. The resource bound to it must be destroyed first
+		void Free(DeviceAllocation& allocation);
+
+		DeviceAllocatorStatistics GetStatistics() const;
+
+	private:
+
+		struct FreeRange
+		{
+			VkDeviceSize offset;
+			VkDeviceSize size;
+		};
+
+		struct Block
+		{
+			VkDeviceMemory memory;				// VK_NULL_HANDLE if the block was freed, in which case the slot is reused by the next block
+			VkDeviceSize size;
+			void* mappedData;
+			uint32_t memoryTypeIndex;
+			MemoryPool pool;
+			bool isImageBlock;
+			bool isDedicated;
+			std::vector<FreeRange> freeRanges;	// Sorted by offset, and never adjacent to each other
+			uint32_t allocationCount;
+			VkDeviceSize allocatedBytes;
+		};
+
+		bool Allocate(const VkMemoryRequirements& requirements, MemoryPool pool, VkMemoryPropertyFlags properties, bool isImage, DeviceAllocation& outAllocation);
+		bool AllocateFromBlock(uint32_t blockIndex, VkDeviceSize size, VkDeviceSize alignment, DeviceAllocation& outAllocation);
+
+		// Returns the index of the new block, or INVALID_BLOCK if the memory could not be allocated
+		uint32_t CreateBlock(VkDeviceSize size, uint32_t memoryTypeIndex, MemoryPool pool, bool isImage, bool isDedicated);
+		void DestroyBlock(uint32_t blockIndex);
+
+		// Returns whether another empty block could serve the same allocations as the provided one
+		bool HasSpareBlock(uint32_t blockIndex) const;
+
+		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+		static VkDeviceSize GetBlockSize(MemoryPool pool);
+
+		std::vector<Block> blocks;
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		uint32_t deviceMemoryCount;
+	};
+}
+
+#endif
@@ -38,6 +38,18 @@ namespace TANG
 		return physicalDeviceMemoryProperties;
 	}
 
+	uint32_t DeviceCache::GetQueueFamilyIndex(QueueType type) const
+	{
+		if (type == QueueType::COUNT) return VK_QUEUE_FAMILY_IGNORED;
+
+		return queueFamilyIndices[static_cast<uint32_t>(type)];
+	}
+
+	bool DeviceCache::HasDedicatedTransferQueue() const
+	{
+		return GetQueueFamilyIndex(QueueType::TRANSFER) != GetQueueFamilyIndex(QueueType::GRAPHICS);
+	}
+
 	void DeviceCache::CacheDevices(VkDevice _logicalDevice, VkPhysicalDevice _physicalDevice)
 	{
 		logicalDevice = _logicalDevice;
@@ -60,6 +72,13 @@ namespace TANG
 		msaaSamples = CalculateMaxMSAA();
 	}
 
+	void DeviceCache::CacheQueueFamilyIndex(QueueType type, uint32_t index)
+	{
+		if (type == QueueType::COUNT) return;
+
+		queueFamilyIndices[static_cast<uint32_t>(type)] = index;
+	}
+
 	void DeviceCache::InvalidateCache()
 	{
 		logicalDevice = VK_NULL_HANDLE;
@@ -68,6 +87,11 @@ namespace TANG
 		physicalDeviceProperties = VkPhysicalDeviceProperties();
 		physicalDeviceFeatures = VkPhysicalDeviceFeatures();
 		physicalDeviceMemoryProperties = VkPhysicalDeviceMemoryProperties();
+
+		for (uint32_t& index : queueFamilyIndices)
+		{
+			index = VK_QUEUE_FAMILY_IGNORED;
+		}
 	}
 
 	VkSampleCountFlagBits DeviceCache::CalculateMaxMSAA()
@@ -1,6 +1,7 @@
 #ifndef DEVICE_CACHE_H
 #define DEVICE_CACHE_H
 
+#include "queue_types.h"
 #include "vulkan/vulkan.h"
 
 namespace TANG
@@ -31,6 +32,11 @@ namespace TANG
 		VkPhysicalDeviceProperties GetPhysicalDeviceProperties() const;
 		VkPhysicalDeviceFeatures GetPhysicalDeviceFeatures() const;
 		VkPhysicalDeviceMemoryProperties GetPhysicalDeviceMemoryProperties() const;
+		uint32_t GetQueueFamilyIndex(QueueType type) const;
+
+		// Returns whether the TRANSFER queue comes from a different family than the GRAPHICS queue, in which case resources written
+		// on the TRANSFER queue must have their ownership transferred before they're used on the GRAPHICS queue
+		bool HasDedicatedTransferQueue() const;
 
 	private:
 
@@ -43,6 +49,7 @@ namespace TANG
 		void CacheDevices(VkDevice logicalDevice, VkPhysicalDevice physicalDevice);
 		void CacheLogicalDevice(VkDevice logicalDevice);
 		void CachePhysicalDevice(VkPhysicalDevice physicalDevice);
+		void CacheQueueFamilyIndex(QueueType type, uint32_t index);
 
 		void InvalidateCache();
 
@@ -56,6 +63,7 @@ namespace TANG
 		VkPhysicalDeviceProperties physicalDeviceProperties;
 		VkPhysicalDeviceFeatures physicalDeviceFeatures;
 		VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
+		uint32_t queueFamilyIndices[static_cast<uint32_t>(QueueType::COUNT)];
 	};
 
 	// Helper function for getting physical/logical devices, since they're needed in a ton of places
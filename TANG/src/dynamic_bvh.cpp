@@ -0,0 +1,470 @@
+
+#include <algorithm>
+
+#include "dynamic_bvh.h"
+#include "frustum_culler.h"
+#include "utils/sanity_check.h"
+
+namespace TANG
+{
+	bool BVHBounds::Contains(const BVHBounds& other) const
+	{
+		return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+	}
+
+	float BVHBounds::SurfaceArea() const
+	{
+		glm::vec3 size = max - min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	BVHBounds BVHBounds::Union(const BVHBounds& a, const BVHBounds& b)
+	{
+		BVHBounds bounds;
+		bounds.min = glm::min(a.min, b.min);
+		bounds.max = glm::max(a.max, b.max);
+		return bounds;
+	}
+
+	DynamicBVH::DynamicBVH() : nodes(), root(NULL_NODE), freeList(NULL_NODE), proxyCount(0)
+	{ }
+
+	DynamicBVH::~DynamicBVH()
+	{ }
+
+	int32_t DynamicBVH::CreateProxy(const BVHBounds& bounds, float margin, uint32_t userData)
+	{
+		int32_t proxyID = AllocateNode();
+
+		Node& node = nodes[proxyID];
+		node.bounds.min = bounds.min - glm::vec3(margin);
+		node.bounds.max = bounds.max + glm::vec3(margin);
+		node.userData = userData;
+		node.height = 0;
+
+		InsertLeaf(proxyID);
+		proxyCount++;
+
+		return proxyID;
+	}
+
+	void DynamicBVH::DestroyProxy(int32_t proxyID)
+	{
+		TNG_ASSERT_MSG(proxyID >= 0 && proxyID < static_cast<int32_t>(nodes.size()) && nodes[proxyID].IsLeaf(), "Attempting to destroy an invalid BVH proxy!");
+
+		RemoveLeaf(proxyID);
+		FreeNode(proxyID);
+		proxyCount--;
+	}
+
+	bool DynamicBVH::MoveProxy(int32_t proxyID, const BVHBounds& bounds, float margin)
+	{
+		TNG_ASSERT_MSG(proxyID >= 0 && proxyID < static_cast<int32_t>(nodes.size()) && nodes[proxyID].IsLeaf(), "Attempting to move an invalid BVH proxy!");
+
+		if (nodes[proxyID].bounds.Contains(bounds))
+		{
+			return false;
+		}
+
+		RemoveLeaf(proxyID);
+
+		nodes[proxyID].bounds.min = bounds.min - glm::vec3(margin);
+		nodes[proxyID].bounds.max = bounds.max + glm::vec3(margin);
+
+		InsertLeaf(proxyID);
+		return true;
+	}
+
+	void DynamicBVH::SetUserData(int32_t proxyID, uint32_t userData)
+	{
+		nodes[proxyID].userData = userData;
+	}
+
+	uint32_t DynamicBVH::GetUserData(int32_t proxyID) const
+	{
+		return nodes[proxyID].userData;
+	}
+
+	uint32_t DynamicBVH::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& outUserData) const
+	{
+		if (root == NULL_NODE)
+		{
+			return 0;
+		}
+
+		// Every entry carries a bit per plane the parent's bounds straddle. Planes the parent was entirely inside of can't cut through
+		// it's children either, so they're skipped. Once no bits are left, the whole subtree is inside the frustum
+		static const uint32_t AllPlanes = (1u << 6) - 1;
+
+		struct StackEntry
+		{
+			int32_t nodeID;
+			uint32_t planeMask;
+		};
+
+		std::vector<StackEntry> stack;
+		stack.reserve(64);
+		stack.push_back({ root, AllPlanes });
+
+		uint32_t visitedCount = 0;
+		while (!stack.empty())
+		{
+			StackEntry entry = stack.back();
+			stack.pop_back();
+
+			const Node& node = nodes[entry.nodeID];
+			visitedCount++;
+
+			uint32_t planeMask = entry.planeMask;
+			bool outside = false;
+			for (uint32_t i = 0; i < 6 && planeMask != 0; i++)
+			{
+				if ((planeMask & (1u << i)) == 0)
+				{
+					continue;
+				}
+
+				// The positive vertex is the corner furthest along the plane's normal, and the negative vertex is the opposite corner.
+				// If the positive vertex is behind the plane the whole box is, and if the negative vertex is in front so is the whole box
+				const glm::vec4& plane = frustum.planes[i];
+				glm::vec3 normal = glm::vec3(plane);
+				glm::vec3 positive = glm::mix(node.bounds.min, node.bounds.max, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+				glm::vec3 negative = glm::mix(node.bounds.max, node.bounds.min, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+
+				if (glm::dot(normal, positive) + plane.w < 0.0f)
+				{
+					outside = true;
+					break;
+				}
+
+				if (glm::dot(normal, negative) + plane.w >= 0.0f)
+				{
+					planeMask &= ~(1u << i);
+				}
+			}
+
+			if (outside)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				outUserData.push_back(node.userData);
+				continue;
+			}
+
+			stack.push_back({ node.child1, planeMask });
+			stack.push_back({ node.child2, planeMask });
+		}
+
+		return visitedCount;
+	}
+
+	uint32_t DynamicBVH::GetProxyCount() const
+	{
+		return proxyCount;
+	}
+
+	void DynamicBVH::Clear()
+	{
+		nodes.clear();
+		root = NULL_NODE;
+		freeList = NULL_NODE;
+		proxyCount = 0;
+	}
+
+	int32_t DynamicBVH::AllocateNode()
+	{
+		if (freeList == NULL_NODE)
+		{
+			nodes.emplace_back();
+			return static_cast<int32_t>(nodes.size() - 1);
+		}
+
+		int32_t nodeID = freeList;
+		freeList = nodes[nodeID].next;
+		nodes[nodeID] = Node();
+
+		return nodeID;
+	}
+
+	void DynamicBVH::FreeNode(int32_t nodeID)
+	{
+		nodes[nodeID].next = freeList;
+		nodes[nodeID].height = -1;
+		freeList = nodeID;
+	}
+
+	void DynamicBVH::InsertLeaf(int32_t leafID)
+	{
+		if (root == NULL_NODE)
+		{
+			root = leafID;
+			nodes[root].parent = NULL_NODE;
+			return;
+		}
+
+		// Find the best sibling for the leaf. Pairing the leaf with a node grows every ancestor of that node, so descending is only worth
+		// it while one of the children is cheaper than creating a new parent right here
+		BVHBounds leafBounds = nodes[leafID].bounds;
+		int32_t index = root;
+		while (!nodes[index].IsLeaf())
+		{
+			const Node& node = nodes[index];
+
+			float area = node.bounds.SurfaceArea();
+			float combinedArea = BVHBounds::Union(node.bounds, leafBounds).SurfaceArea();
+
+			// Cost of creating a new parent for this node and the leaf
+			float cost = 2.0f * combinedArea;
+
+			// Minimum cost of pushing the leaf further down the tree
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			const Node& child1 = nodes[node.child1];
+			float cost1 = BVHBounds::Union(leafBounds, child1.bounds).SurfaceArea() + inheritanceCost;
+			if (!child1.IsLeaf())
+			{
+				cost1 -= child1.bounds.SurfaceArea();
+			}
+
+			const Node& child2 = nodes[node.child2];
+			float cost2 = BVHBounds::Union(leafBounds, child2.bounds).SurfaceArea() + inheritanceCost;
+			if (!child2.IsLeaf())
+			{
+				cost2 -= child2.bounds.SurfaceArea();
+			}
+
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+
+			index = (cost1 < cost2) ? node.child1 : node.child2;
+		}
+
+		int32_t siblingID = index;
+
+		// Allocating may grow the node array, so we hold on to indices instead of references until it's done
+		int32_t oldParentID = nodes[siblingID].parent;
+		int32_t newParentID = AllocateNode();
+
+		Node& newParent = nodes[newParentID];
+		newParent.parent = oldParentID;
+		newParent.bounds = BVHBounds::Union(leafBounds, nodes[siblingID].bounds);
+		newParent.height = nodes[siblingID].height + 1;
+		newParent.child1 = siblingID;
+		newParent.child2 = leafID;
+
+		if (oldParentID != NULL_NODE)
+		{
+			Node& oldParent = nodes[oldParentID];
+			if (oldParent.child1 == siblingID)
+			{
+				oldParent.child1 = newParentID;
+			}
+			else
+			{
+				oldParent.child2 = newParentID;
+			}
+		}
+		else
+		{
+			root = newParentID;
+		}
+
+		nodes[siblingID].parent = newParentID;
+		nodes[leafID].parent = newParentID;
+
+		Refit(nodes[leafID].parent);
+	}
+
+	void DynamicBVH::RemoveLeaf(int32_t leafID)
+	{
+		if (leafID == root)
+		{
+			root = NULL_NODE;
+			return;
+		}
+
+		// The leaf's parent is removed along with it, and the sibling takes the parent's place
+		int32_t parentID = nodes[leafID].parent;
+		int32_t grandParentID = nodes[parentID].parent;
+		int32_t siblingID = (nodes[parentID].child1 == leafID) ? nodes[parentID].child2 : nodes[parentID].child1;
+
+		if (grandParentID != NULL_NODE)
+		{
+			Node& grandParent = nodes[grandParentID];
+			if (grandParent.child1 == parentID)
+			{
+				grandParent.child1 = siblingID;
+			}
+			else
+			{
+				grandParent.child2 = siblingID;
+			}
+
+			nodes[siblingID].parent = grandParentID;
+			FreeNode(parentID);
+
+			Refit(grandParentID);
+		}
+		else
+		{
+			root = siblingID;
+			nodes[siblingID].parent = NULL_NODE;
+			FreeNode(parentID);
+		}
+
+		nodes[leafID].parent = NULL_NODE;
+	}
+
+	void DynamicBVH::Refit(int32_t nodeID)
+	{
+		int32_t index = nodeID;
+		while (index != NULL_NODE)
+		{
+			index = Balance(index);
+
+			Node& node = nodes[index];
+			const Node& child1 = nodes[node.child1];
+			const Node& child2 = nodes[node.child2];
+
+			node.height = 1 + std::max(child1.height, child2.height);
+			node.bounds = BVHBounds::Union(child1.bounds, child2.bounds);
+
+			index = node.parent;
+		}
+	}
+
+	int32_t DynamicBVH::Balance(int32_t nodeID)
+	{
+		Node& a = nodes[nodeID];
+		if (a.IsLeaf() || a.height < 2)
+		{
+			return nodeID;
+		}
+
+		int32_t bID = a.child1;
+		int32_t cID = a.child2;
+		Node& b = nodes[bID];
+		Node& c = nodes[cID];
+
+		int32_t balance = c.height - b.height;
+
+		// Rotate C up
+		if (balance > 1)
+		{
+			int32_t fID = c.child1;
+			int32_t gID = c.child2;
+			Node& f = nodes[fID];
+			Node& g = nodes[gID];
+
+			// A becomes C's child, and C takes A's place under A's old parent
+			c.child1 = nodeID;
+			c.parent = a.parent;
+			a.parent = cID;
+
+			if (c.parent != NULL_NODE)
+			{
+				Node& parent = nodes[c.parent];
+				if (parent.child1 == nodeID)
+				{
+					parent.child1 = cID;
+				}
+				else
+				{
+					parent.child2 = cID;
+				}
+			}
+			else
+			{
+				root = cID;
+			}
+
+			// The taller of C's children stays with C, and the other one is handed to A
+			if (f.height > g.height)
+			{
+				c.child2 = fID;
+				a.child2 = gID;
+				g.parent = nodeID;
+				a.bounds = BVHBounds::Union(b.bounds, g.bounds);
+				c.bounds = BVHBounds::Union(a.bounds, f.bounds);
+
+				a.height = 1 + std::max(b.height, g.height);
+				c.height = 1 + std::max(a.height, f.height);
+			}
+			else
+			{
+				c.child2 = gID;
+				a.child2 = fID;
+				f.parent = nodeID;
+				a.bounds = BVHBounds::Union(b.bounds, f.bounds);
+				c.bounds = BVHBounds::Union(a.bounds, g.bounds);
+
+				a.height = 1 + std::max(b.height, f.height);
+				c.height = 1 + std::max(a.height, g.height);
+			}
+
+			return cID;
+		}
+
+		// Rotate B up
+		if (balance < -1)
+		{
+			int32_t dID = b.child1;
+			int32_t eID = b.child2;
+			Node& d = nodes[dID];
+			Node& e = nodes[eID];
+
+			b.child1 = nodeID;
+			b.parent = a.parent;
+			a.parent = bID;
+
+			if (b.parent != NULL_NODE)
+			{
+				Node& parent = nodes[b.parent];
+				if (parent.child1 == nodeID)
+				{
+					parent.child1 = bID;
+				}
+				else
+				{
+					parent.child2 = bID;
+				}
+			}
+			else
+			{
+				root = bID;
+			}
+
+			if (d.height > e.height)
+			{
+				b.child2 = dID;
+				a.child1 = eID;
+				e.parent = nodeID;
+				a.bounds = BVHBounds::Union(c.bounds, e.bounds);
+				b.bounds = BVHBounds::Union(a.bounds, d.bounds);
+
+				a.height = 1 + std::max(c.height, e.height);
+				b.height = 1 + std::max(a.height, d.height);
+			}
+			else
+			{
+				b.child2 = eID;
+				a.child1 = dID;
+				d.parent = nodeID;
+				a.bounds = BVHBounds::Union(c.bounds, d.bounds);
+				b.bounds = BVHBounds::Union(a.bounds, e.bounds);
+
+				a.height = 1 + std::max(c.height, d.height);
+				b.height = 1 + std::max(a.height, e.height);
+			}
+
+			return bID;
+		}
+
+		return nodeID;
+	}
+}
@@ -0,0 +1,96 @@
+#ifndef DYNAMIC_BVH_H
+#define DYNAMIC_BVH_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace TANG
+{
+	struct Frustum;
+
+	struct BVHBounds
+	{
+		glm::vec3 min = glm::vec3(0.0f);
+		glm::vec3 max = glm::vec3(0.0f);
+
+		bool Contains(const BVHBounds& other) const;
+
+		// Used as the insertion cost, the same way the 2D version of this tree uses the perimeter
+		float SurfaceArea() const;
+
+		static BVHBounds Union(const BVHBounds& a, const BVHBounds& b);
+	};
+
+	// Dynamic AABB tree, modeled after Box2D's b2DynamicTree. Every proxy is a leaf whose bounds are grown by a margin, so objects that
+	// move a little stay inside their leaf and don't need to be reinserted every frame. Leaves are inserted next to the sibling that
+	// grows the tree's surface area the least, and the tree is rebalanced with rotations on the way back up, so it stays balanced no
+	// matter what order the proxies are inserted in. Nodes are stored in a single array and recycled through a free list, so proxy IDs
+	// stay valid until the proxy is destroyed
+	class DynamicBVH
+	{
+	public:
+
+		static constexpr int32_t NULL_NODE = -1;
+
+		DynamicBVH();
+		~DynamicBVH();
+
+		DynamicBVH(const DynamicBVH& other) = delete;
+		DynamicBVH& operator=(const DynamicBVH& other) = delete;
+
+		// Inserts a leaf whose bounds are grown by the margin on every side, and returns it's proxy ID
+		int32_t CreateProxy(const BVHBounds& bounds, float margin, uint32_t userData);
+		void DestroyProxy(int32_t proxyID);
+
+		// Reinserts the proxy with new fat bounds if the bounds are no longer inside it's current ones. Returns whether it was reinserted
+		bool MoveProxy(int32_t proxyID, const BVHBounds& bounds, float margin);
+
+		void SetUserData(int32_t proxyID, uint32_t userData);
+		uint32_t GetUserData(int32_t proxyID) const;
+
+		// Appends the user data of every proxy whose fat bounds are at least partially inside the frustum. Subtrees that are entirely
+		// inside are appended without testing them any further. Returns the number of nodes visited
+		uint32_t QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& outUserData) const;
+
+		uint32_t GetProxyCount() const;
+
+		// Destroys every proxy
+		void Clear();
+
+	private:
+
+		struct Node
+		{
+			BVHBounds bounds;
+			int32_t parent = NULL_NODE;
+			int32_t child1 = NULL_NODE;
+			int32_t child2 = NULL_NODE;
+			int32_t next = NULL_NODE;		// Next node in the free list
+			int32_t height = 0;				// Leaves are zero, free nodes are -1
+			uint32_t userData = 0;
+
+			bool IsLeaf() const { return child1 == NULL_NODE; }
+		};
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t nodeID);
+
+		void InsertLeaf(int32_t leafID);
+		void RemoveLeaf(int32_t leafID);
+
+		// Walks from the node up to the root, rebalancing and refitting every ancestor
+		void Refit(int32_t nodeID);
+
+		// Rotates the subtree if one child is more than one level taller than the other. Returns the subtree's new root
+		int32_t Balance(int32_t nodeID);
+
+		std::vector<Node> nodes;
+		int32_t root;
+		int32_t freeList;
+		uint32_t proxyCount;
+	};
+}
+
+#endif
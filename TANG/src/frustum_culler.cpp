@@ -0,0 +1,179 @@
+
+#include <algorithm>
+
+#include <xmmintrin.h> // SSE
+
+#include "config.h"
+#include "frustum_culler.h"
+
+namespace TANG
+{
+	Frustum Frustum::FromViewProjection(const glm::mat4& viewProjection)
+	{
+		// The depth range is [0, 1], so the near plane is the third row on it's own
+		Frustum frustum;
+		glm::mat4 m = glm::transpose(viewProjection);
+		frustum.planes[0] = m[3] + m[0];	// Left
+		frustum.planes[1] = m[3] - m[0];	// Right
+		frustum.planes[2] = m[3] + m[1];	// Bottom
+		frustum.planes[3] = m[3] - m[1];	// Top
+		frustum.planes[4] = m[2];			// Near
+		frustum.planes[5] = m[3] - m[2];	// Far
+		for (glm::vec4& plane : frustum.planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+
+		return frustum;
+	}
+
+	FrustumCuller::FrustumCuller() : centersX(), centersY(), centersZ(), radii(), keys(), objectCount(0), bvh(), proxies(), queryResults(),
+		frameIndex(0), stats()
+	{ }
+
+	FrustumCuller::~FrustumCuller()
+	{ }
+
+	void FrustumCuller::BeginFrame()
+	{
+		centersX.clear();
+		centersY.clear();
+		centersZ.clear();
+		radii.clear();
+		keys.clear();
+		objectCount = 0;
+
+		frameIndex++;
+	}
+
+	void FrustumCuller::AddObject(UUID key, const glm::vec3& center, float radius)
+	{
+		if (objectCount % 4 == 0)
+		{
+			centersX.resize(objectCount + 4, 0.0f);
+			centersY.resize(objectCount + 4, 0.0f);
+			centersZ.resize(objectCount + 4, 0.0f);
+			radii.resize(objectCount + 4, 0.0f);
+		}
+
+		centersX[objectCount] = center.x;
+		centersY[objectCount] = center.y;
+		centersZ[objectCount] = center.z;
+		radii[objectCount] = radius;
+		keys.push_back(key);
+
+		if (CONFIG::EnableCullingBVH)
+		{
+			BVHBounds bounds;
+			bounds.min = center - glm::vec3(radius);
+			bounds.max = center + glm::vec3(radius);
+
+			auto iter = proxies.find(key);
+			if (iter == proxies.end())
+			{
+				proxies.insert({ key, { bvh.CreateProxy(bounds, radius * CONFIG::CullingBVHMargin, objectCount), frameIndex } });
+			}
+			else
+			{
+				bvh.MoveProxy(iter->second.proxyID, bounds, radius * CONFIG::CullingBVHMargin);
+				bvh.SetUserData(iter->second.proxyID, objectCount);
+				iter->second.lastFrame = frameIndex;
+			}
+		}
+
+		objectCount++;
+	}
+
+	void FrustumCuller::Cull(const Frustum& frustum, std::vector<uint8_t>& outVisible)
+	{
+		outVisible.assign(objectCount, 0);
+
+		stats = CullingStatistics();
+		stats.testedCount = objectCount;
+		stats.usedBVH = CONFIG::EnableCullingBVH;
+
+		if (CONFIG::EnableCullingBVH)
+		{
+			CullBVH(frustum, outVisible);
+		}
+		else
+		{
+			CullLinear(frustum, outVisible);
+		}
+
+		stats.visibleCount = static_cast<uint32_t>(std::count(outVisible.begin(), outVisible.end(), static_cast<uint8_t>(1)));
+		stats.culledCount = stats.testedCount - stats.visibleCount;
+	}
+
+	CullingStatistics FrustumCuller::GetStatistics() const
+	{
+		return stats;
+	}
+
+	void FrustumCuller::CullLinear(const Frustum& frustum, std::vector<uint8_t>& outVisible) const
+	{
+		__m128 planeX[6];
+		__m128 planeY[6];
+		__m128 planeZ[6];
+		__m128 planeW[6];
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			planeX[i] = _mm_set1_ps(frustum.planes[i].x);
+			planeY[i] = _mm_set1_ps(frustum.planes[i].y);
+			planeZ[i] = _mm_set1_ps(frustum.planes[i].z);
+			planeW[i] = _mm_set1_ps(frustum.planes[i].w);
+		}
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 allOnes = _mm_cmpeq_ps(zero, zero);
+
+		// A sphere is outside the frustum if it's entirely behind any of the planes, meaning it's signed distance to the plane is less than
+		// it's negative radius. Four spheres are tested at a time, and the lanes that are in front of every plane are visible
+		for (uint32_t i = 0; i < objectCount; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(&centersX[i]);
+			__m128 y = _mm_loadu_ps(&centersY[i]);
+			__m128 z = _mm_loadu_ps(&centersZ[i]);
+			__m128 negativeRadius = _mm_sub_ps(zero, _mm_loadu_ps(&radii[i]));
+
+			__m128 inside = allOnes;
+			for (uint32_t p = 0; p < 6; p++)
+			{
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)), _mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+			}
+
+			int mask = _mm_movemask_ps(inside);
+			uint32_t laneCount = std::min(objectCount - i, 4u);
+			for (uint32_t lane = 0; lane < laneCount; lane++)
+			{
+				outVisible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+			}
+		}
+	}
+
+	void FrustumCuller::CullBVH(const Frustum& frustum, std::vector<uint8_t>& outVisible)
+	{
+		// Destroy the proxies of objects that weren't submitted this frame, before they show up in the query with stale user data
+		for (auto iter = proxies.begin(); iter != proxies.end();)
+		{
+			if (iter->second.lastFrame != frameIndex)
+			{
+				bvh.DestroyProxy(iter->second.proxyID);
+				iter = proxies.erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
+		}
+
+		queryResults.clear();
+		stats.bvhNodesVisited = bvh.QueryFrustum(frustum, queryResults);
+
+		for (uint32_t objectIndex : queryResults)
+		{
+			outVisible[objectIndex] = 1;
+		}
+	}
+}
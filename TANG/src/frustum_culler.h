@@ -0,0 +1,91 @@
+#ifndef FRUSTUM_CULLER_H
+#define FRUSTUM_CULLER_H
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "dynamic_bvh.h"
+#include "utils/uuid.h"
+
+namespace TANG
+{
+	// Left, right, bottom, top, near and far planes, stored as (normal, distance) with the normals facing into the frustum. A point p is
+	// in front of a plane if dot(normal, p) + distance >= 0
+	struct Frustum
+	{
+		// Extracts the world-space planes from the rows of the view-projection matrix (Gribb & Hartmann), assuming a [0, 1] depth range.
+		// The planes are normalized, so they give the actual distance to a point
+		static Frustum FromViewProjection(const glm::mat4& viewProjection);
+
+		std::array<glm::vec4, 6> planes;
+	};
+
+	struct CullingStatistics
+	{
+		uint32_t testedCount = 0;				// Objects submitted during the last frame
+		uint32_t visibleCount = 0;
+		uint32_t culledCount = 0;
+		uint32_t bvhNodesVisited = 0;			// Only counted if the BVH was used
+		bool usedBVH = false;
+	};
+
+	// Frustum culls world-space bounding spheres on the CPU. The objects are resubmitted every frame, and their spheres are stored as
+	// separate arrays of x, y, z and radius so four spheres can be tested against a plane at a time with SSE.
+	// If CONFIG::EnableCullingBVH is enabled, every object also gets a proxy in a DynamicBVH, which is kept across frames and only
+	// reinserted once the object leaves it's fat bounds (see CONFIG::CullingBVHMargin). Whole subtrees are then culled or accepted at
+	// once, which pays off with tens of thousands of objects. The BVH tests the fat bounds, so it culls slightly less than the linear
+	// tests do. Proxies of objects that weren't submitted during a frame are destroyed at the end of it. Must only be used from the render thread
+	class FrustumCuller
+	{
+	public:
+
+		FrustumCuller();
+		~FrustumCuller();
+
+		FrustumCuller(const FrustumCuller& other) = delete;
+		FrustumCuller& operator=(const FrustumCuller& other) = delete;
+
+		// Drops the objects submitted during the previous frame
+		void BeginFrame();
+
+		// Submits an object's world-space bounding sphere. The key identifies the object across frames, so the object's BVH proxy can be reused.
+		// Objects are indexed in the order they're submitted
+		void AddObject(UUID key, const glm::vec3& center, float radius);
+
+		// Writes whether every object submitted since BeginFrame() is at least partially inside the frustum into outVisible, by object index
+		void Cull(const Frustum& frustum, std::vector<uint8_t>& outVisible);
+
+		CullingStatistics GetStatistics() const;
+
+	private:
+
+		void CullLinear(const Frustum& frustum, std::vector<uint8_t>& outVisible) const;
+		void CullBVH(const Frustum& frustum, std::vector<uint8_t>& outVisible);
+
+		// Padded to a multiple of four so the last spheres can be loaded as a whole SSE register. The padding is never read back
+		std::vector<float> centersX;
+		std::vector<float> centersY;
+		std::vector<float> centersZ;
+		std::vector<float> radii;
+		std::vector<UUID> keys;
+		uint32_t objectCount;
+
+		struct Proxy
+		{
+			int32_t proxyID;
+			uint64_t lastFrame;				// Frame the object was last submitted in
+		};
+
+		DynamicBVH bvh;
+		std::unordered_map<UUID, Proxy> proxies;
+		std::vector<uint32_t> queryResults;
+		uint64_t frameIndex;
+
+		CullingStatistics stats;
+	};
+}
+
+#endif
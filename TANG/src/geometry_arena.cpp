@@ -0,0 +1,218 @@
+
+#include <algorithm>
+
+#include "geometry_arena.h"
+#include "utils/logger.h"
+#include "utils/sanity_check.h"
+
+namespace TANG
+{
+	GeometryArena::GeometryArena() : blocks(), blockSize(0), allocatedBytes(0), allocationCount(0)
+	{
+	}
+
+	GeometryArena::~GeometryArena()
+	{
+		if (!blocks.empty())
+		{
+			LogWarning("Geometry arena destroyed with %u blocks still alive!", static_cast<uint32_t>(blocks.size()));
+		}
+	}
+
+	void GeometryArena::Create(VkDeviceSize _blockSize)
+	{
+		TNG_ASSERT_MSG(_blockSize > 0, "Geometry arena block size must be greater than zero!");
+		blockSize = _blockSize;
+	}
+
+	void GeometryArena::Destroy()
+	{
+		if (allocationCount > 0)
+		{
+			LogWarning("Destroying geometry arena with %u allocations still alive!", allocationCount);
+		}
+
+		for (auto& block : blocks)
+		{
+			block.buffer.Destroy();
+		}
+
+		blocks.clear();
+		allocatedBytes = 0;
+		allocationCount = 0;
+	}
+
+	bool GeometryArena::Allocate(VkDeviceSize size, VkDeviceSize alignment, GeometryAllocation& outAllocation)
+	{
+		if (size == 0 || alignment == 0)
+		{
+			LogError("Invalid geometry allocation of %llu bytes with %llu alignment!", size, alignment);
+			return false;
+		}
+
+		for (uint32_t i = 0; i < static_cast<uint32_t>(blocks.size()); i++)
+		{
+			if (AllocateFromBlock(i, size, alignment, outAllocation))
+			{
+				return true;
+			}
+		}
+
+		// No block has enough space left, so we create a new one. A new block is empty, so the allocation always starts at offset zero
+		if (!CreateBlock(std::max(size, blockSize)))
+		{
+			return false;
+		}
+
+		return AllocateFromBlock(static_cast<uint32_t>(blocks.size() - 1), size, alignment, outAllocation);
+	}
+
+	void GeometryArena::Free(GeometryAllocation& allocation)
+	{
+		if (!allocation.IsValid())
+		{
+			return;
+		}
+
+		if (allocation.block >= blocks.size())
+		{
+			LogWarning("Attempting to free geometry allocation from non-existent block %u!", allocation.block);
+			return;
+		}
+
+		Block& block = blocks[allocation.block];
+		std::vector<FreeRange>& freeRanges = block.freeRanges;
+
+		// Insert the range in order, and merge it with it's neighbours if they're adjacent
+		auto next = std::lower_bound(freeRanges.begin(), freeRanges.end(), allocation.offset,
+			[](const FreeRange& range, VkDeviceSize offset) { return range.offset < offset; });
+		auto iter = freeRanges.insert(next, { allocation.offset, allocation.size });
+
+		auto following = iter + 1;
+		if (following != freeRanges.end() && iter->offset + iter->size == following->offset)
+		{
+			iter->size += following->size;
+			iter = freeRanges.erase(following) - 1;
+		}
+
+		if (iter != freeRanges.begin())
+		{
+			auto previous = iter - 1;
+			if (previous->offset + previous->size == iter->offset)
+			{
+				previous->size += iter->size;
+				freeRanges.erase(iter);
+			}
+		}
+
+		block.allocationCount--;
+		allocatedBytes -= allocation.size;
+		allocationCount--;
+
+		allocation = GeometryAllocation();
+	}
+
+	void GeometryArena::CopyIntoAllocation(VkCommandBuffer commandBuffer, const StagingRegion& region, const GeometryAllocation& allocation, VkDeviceSize offset)
+	{
+		TNG_ASSERT_MSG(allocation.IsValid() && allocation.block < blocks.size(), "Attempting to copy into invalid geometry allocation!");
+		TNG_ASSERT_MSG(offset + region.size <= allocation.size, "Attempting to copy past the end of a geometry allocation!");
+		blocks[allocation.block].buffer.CopyFromStagingBuffer(commandBuffer, region.buffer, region.offset, allocation.offset + offset, region.size);
+	}
+
+	uint32_t GeometryArena::GetBlockCount() const
+	{
+		return static_cast<uint32_t>(blocks.size());
+	}
+
+	uint32_t GeometryArena::GetAllocationCount() const
+	{
+		return allocationCount;
+	}
+
+	VkDeviceSize GeometryArena::GetAllocatedBytes() const
+	{
+		return allocatedBytes;
+	}
+
+	VkDeviceSize GeometryArena::GetCapacityBytes() const
+	{
+		VkDeviceSize capacity = 0;
+		for (const auto& block : blocks)
+		{
+			capacity += block.buffer.GetBufferSize();
+		}
+
+		return capacity;
+	}
+
+	bool GeometryArena::AllocateFromBlock(uint32_t blockIndex, VkDeviceSize size, VkDeviceSize alignment, GeometryAllocation& outAllocation)
+	{
+		Block& block = blocks[blockIndex];
+		std::vector<FreeRange>& freeRanges = block.freeRanges;
+
+		for (auto iter = freeRanges.begin(); iter != freeRanges.end(); iter++)
+		{
+			VkDeviceSize alignedOffset = ((iter->offset + alignment - 1) / alignment) * alignment;
+			VkDeviceSize padding = alignedOffset - iter->offset;
+			if (padding + size > iter->size)
+			{
+				continue;
+			}
+
+			// Split the free range into the (optional) padding before the allocation and the (optional) remainder after it
+			VkDeviceSize rangeEnd = iter->offset + iter->size;
+			VkDeviceSize allocationEnd = alignedOffset + size;
+
+			if (padding > 0)
+			{
+				iter->size = padding;
+				if (allocationEnd < rangeEnd)
+				{
+					freeRanges.insert(iter + 1, { allocationEnd, rangeEnd - allocationEnd });
+				}
+			}
+			else if (allocationEnd < rangeEnd)
+			{
+				iter->offset = allocationEnd;
+				iter->size = rangeEnd - allocationEnd;
+			}
+			else
+			{
+				freeRanges.erase(iter);
+			}
+
+			outAllocation.buffer = block.buffer.GetBuffer();
+			outAllocation.block = blockIndex;
+			outAllocation.offset = alignedOffset;
+			outAllocation.size = size;
+
+			block.allocationCount++;
+			allocatedBytes += size;
+			allocationCount++;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	bool GeometryArena::CreateBlock(VkDeviceSize size)
+	{
+		blocks.emplace_back();
+
+		Block& block = blocks.back();
+		block.buffer.Create(size);
+		if (block.buffer.IsInvalid())
+		{
+			LogError("Failed to create geometry arena block of %llu bytes!", size);
+			blocks.pop_back();
+			return false;
+		}
+
+		block.freeRanges.push_back({ 0, size });
+		block.allocationCount = 0;
+
+		LogInfo("Created geometry arena block %u (%llu bytes)", static_cast<uint32_t>(blocks.size() - 1), size);
+		return true;
+	}
+}
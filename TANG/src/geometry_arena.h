@@ -0,0 +1,97 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <limits>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "data_buffer/geometry_buffer.h"
+#include "staging_ring.h"
+
+namespace TANG
+{
+	// A range of a GeometryArena block. The buffer handle is cached so binding the allocation doesn't require a lookup
+	struct GeometryAllocation
+	{
+		static constexpr uint32_t INVALID_BLOCK = std::numeric_limits<uint32_t>::max();
+
+		VkBuffer buffer = VK_NULL_HANDLE;
+		uint32_t block = INVALID_BLOCK;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+
+		bool IsValid() const { return block != INVALID_BLOCK; }
+	};
+
+	// Global arena that sub-allocates the vertex and index data of every asset out of a few large device-local buffers, instead
+	// of creating (and allocating memory for) separate buffers per asset. Vertex and index data share the same blocks. Allocations
+	// are aligned to the vertex stride or index size, so draws can address them through vertexOffset and firstIndex while binding
+	// the block at offset zero. Freed ranges are coalesced and reused by later allocations using a first-fit free list per block.
+	// Must only be used from the render thread
+	class GeometryArena
+	{
+	private:
+
+		GeometryArena();
+		~GeometryArena();
+
+	public:
+
+		// Singletons should not be assignable nor copyable
+		GeometryArena(const GeometryArena& other) = delete;
+		void operator=(const GeometryArena& other) = delete;
+
+		static GeometryArena& GetInstance()
+		{
+			static GeometryArena instance;
+			return instance;
+		}
+
+		// Blocks are created lazily with the provided size. Allocations larger than the block size get a dedicated block of their own
+		void Create(VkDeviceSize blockSize);
+
+		// Destroys all the blocks, regardless of whether there are allocations still alive. Must be called before the logical device is destroyed
+		void Destroy();
+
+		// Allocates a range of the provided size, with an offset that is a multiple of the alignment. The alignment doesn't have to be
+		// a power of two, since it's the vertex stride for vertex data. Returns false if the block could not be created
+		bool Allocate(VkDeviceSize size, VkDeviceSize alignment, GeometryAllocation& outAllocation);
+
+		// Returns the range to it's block's free list, and resets the allocation
+		void Free(GeometryAllocation& allocation);
+
+		// Records a copy of a staging ring region into the allocation, starting at offset bytes into the allocation
+		void CopyIntoAllocation(VkCommandBuffer commandBuffer, const StagingRegion& region, const GeometryAllocation& allocation, VkDeviceSize offset);
+
+		uint32_t GetBlockCount() const;
+		uint32_t GetAllocationCount() const;
+		VkDeviceSize GetAllocatedBytes() const;
+		VkDeviceSize GetCapacityBytes() const;
+
+	private:
+
+		struct FreeRange
+		{
+			VkDeviceSize offset;
+			VkDeviceSize size;
+		};
+
+		struct Block
+		{
+			GeometryBuffer buffer;
+			std::vector<FreeRange> freeRanges;	// Sorted by offset, and never adjacent to each other
+			uint32_t allocationCount;
+		};
+
+		bool AllocateFromBlock(uint32_t blockIndex, VkDeviceSize size, VkDeviceSize alignment, GeometryAllocation& outAllocation);
+		bool CreateBlock(VkDeviceSize size);
+
+		std::vector<Block> blocks;
+		VkDeviceSize blockSize;
+		VkDeviceSize allocatedBytes;
+		uint32_t allocationCount;
+	};
+}
+
+#endif
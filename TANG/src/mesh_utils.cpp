@@ -0,0 +1,807 @@
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "mesh_utils.h"
+#include "utils/logger.h"
+#include "utils/sanity_check.h"
+
+namespace TANG
+{
+	// Returns the number of 32-bit float components of the format, or 0 if the format is not a 32-bit float format
+	static uint32_t GetFloatComponentCount(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_R32_SFLOAT:				return 1;
+		case VK_FORMAT_R32G32_SFLOAT:			return 2;
+		case VK_FORMAT_R32G32B32_SFLOAT:		return 3;
+		case VK_FORMAT_R32G32B32A32_SFLOAT:		return 4;
+		default: break;
+		}
+
+		return 0;
+	}
+
+	// Returns the size in bytes of the vertex attribute formats we use. Anything else is unsupported
+	static uint32_t GetAttributeSize(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_R32_SFLOAT:				return 4;
+		case VK_FORMAT_R32G32_SFLOAT:			return 8;
+		case VK_FORMAT_R32G32B32_SFLOAT:		return 12;
+		case VK_FORMAT_R32G32B32A32_SFLOAT:		return 16;
+		case VK_FORMAT_R16G16_SFLOAT:			return 4;
+		case VK_FORMAT_R16G16_UNORM:			return 4;
+		case VK_FORMAT_R16G16_SNORM:			return 4;
+		case VK_FORMAT_R16G16B16A16_SFLOAT:		return 8;
+		case VK_FORMAT_R16G16B16A16_SNORM:		return 8;
+		case VK_FORMAT_R8G8B8A8_UNORM:			return 4;
+		case VK_FORMAT_R8G8B8A8_SNORM:			return 4;
+		case VK_FORMAT_R32_UINT:				return 4;
+		default: break;
+		}
+
+		return 0;
+	}
+
+	static uint64_t HashBytes(const uint8_t* data, uint32_t size)
+	{
+		uint64_t hash = 0xcbf29ce484222325;
+		for (uint32_t i = 0; i < size; i++)
+		{
+			hash ^= data[i];
+			hash *= 0x100000001b3;
+		}
+
+		return hash;
+	}
+
+	struct Vector3d
+	{
+		double x, y, z;
+	};
+
+	static Vector3d Subtract(const Vector3d& a, const Vector3d& b)
+	{
+		return { a.x - b.x, a.y - b.y, a.z - b.z };
+	}
+
+	static Vector3d Cross(const Vector3d& a, const Vector3d& b)
+	{
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	static double Dot(const Vector3d& a, const Vector3d& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	static double Length(const Vector3d& v)
+	{
+		return std::sqrt(Dot(v, v));
+	}
+
+	// Symmetric 4x4 matrix of the sum of squared distances to a set of planes, along with the total weight of the planes
+	struct Quadric
+	{
+		double a2 = 0.0, b2 = 0.0, c2 = 0.0, d2 = 0.0;
+		double ab = 0.0, ac = 0.0, ad = 0.0;
+		double bc = 0.0, bd = 0.0, cd = 0.0;
+		double weight = 0.0;
+	};
+
+	static Quadric CreatePlaneQuadric(const Vector3d& normal, const Vector3d& point, double weight)
+	{
+		double a = normal.x, b = normal.y, c = normal.z;
+		double d = -Dot(normal, point);
+
+		Quadric q;
+		q.a2 = a * a * weight; q.b2 = b * b * weight; q.c2 = c * c * weight; q.d2 = d * d * weight;
+		q.ab = a * b * weight; q.ac = a * c * weight; q.ad = a * d * weight;
+		q.bc = b * c * weight; q.bd = b * d * weight; q.cd = c * d * weight;
+		q.weight = weight;
+
+		return q;
+	}
+
+	static void AddQuadric(Quadric& q, const Quadric& other)
+	{
+		q.a2 += other.a2; q.b2 += other.b2; q.c2 += other.c2; q.d2 += other.d2;
+		q.ab += other.ab; q.ac += other.ac; q.ad += other.ad;
+		q.bc += other.bc; q.bd += other.bd; q.cd += other.cd;
+		q.weight += other.weight;
+	}
+
+	// Returns the weighted average of the squared distances from the point to the quadric's planes
+	static double EvaluateQuadric(const Quadric& q, const Vector3d& p)
+	{
+		if (q.weight <= 0.0)
+		{
+			return 0.0;
+		}
+
+		double error = q.a2 * p.x * p.x + q.b2 * p.y * p.y + q.c2 * p.z * p.z + q.d2
+			+ 2.0 * (q.ab * p.x * p.y + q.ac * p.x * p.z + q.bc * p.y * p.z)
+			+ 2.0 * (q.ad * p.x + q.bd * p.y + q.cd * p.z);
+
+		return std::max(error, 0.0) / q.weight;
+	}
+
+	// Collapses the "from" vertex into the "to" vertex
+	struct Collapse
+	{
+		uint32_t from;
+		uint32_t to;
+		double cost;
+	};
+
+	// Builds the vertex-triangle adjacency, stored as a flattened array with per-vertex offsets
+	static void BuildTriangleAdjacency(const std::vector<IndexType>& indices, uint32_t vertexCount, std::vector<uint32_t>& outOffsets, std::vector<uint32_t>& outAdjacency)
+	{
+		outOffsets.assign(vertexCount + 1, 0);
+		for (IndexType index : indices)
+		{
+			outOffsets[index + 1]++;
+		}
+
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			outOffsets[i + 1] += outOffsets[i];
+		}
+
+		outAdjacency.resize(indices.size());
+		std::vector<uint32_t> fill(outOffsets.begin(), outOffsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			outAdjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	// Vertices on an open boundary (or a non-manifold edge) and vertices that share their position with another vertex can't be
+	// collapsed. Collapsing them would pull the silhouette inwards or open cracks along the seams
+	static std::vector<bool> FindLockedVertices(const std::vector<Vector3d>& positions, const std::vector<IndexType>& indices)
+	{
+		uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+		std::vector<bool> isLocked(vertexCount, false);
+
+		std::vector<uint32_t> sortedVertices(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			sortedVertices[i] = i;
+		}
+
+		std::sort(sortedVertices.begin(), sortedVertices.end(), [&positions](uint32_t a, uint32_t b)
+			{
+				const Vector3d& pa = positions[a];
+				const Vector3d& pb = positions[b];
+				if (pa.x != pb.x) return pa.x < pb.x;
+				if (pa.y != pb.y) return pa.y < pb.y;
+				return pa.z < pb.z;
+			});
+
+		for (uint32_t i = 1; i < vertexCount; i++)
+		{
+			const Vector3d& pa = positions[sortedVertices[i - 1]];
+			const Vector3d& pb = positions[sortedVertices[i]];
+			if (pa.x == pb.x && pa.y == pb.y && pa.z == pb.z)
+			{
+				isLocked[sortedVertices[i - 1]] = true;
+				isLocked[sortedVertices[i]] = true;
+			}
+		}
+
+		// Every edge of a closed manifold is shared by exactly two triangles
+		std::vector<uint64_t> edges;
+		edges.reserve(indices.size());
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				uint64_t a = indices[i + j];
+				uint64_t b = indices[i + (j + 1) % 3];
+				edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+			}
+		}
+
+		std::sort(edges.begin(), edges.end());
+		for (size_t i = 0; i < edges.size();)
+		{
+			size_t j = i;
+			while (j < edges.size() && edges[j] == edges[i]) j++;
+
+			if (j - i != 2)
+			{
+				isLocked[static_cast<uint32_t>(edges[i] >> 32)] = true;
+				isLocked[static_cast<uint32_t>(edges[i] & 0xFFFFFFFF)] = true;
+			}
+
+			i = j;
+		}
+
+		return isLocked;
+	}
+
+	// A collapse is rejected if any of the triangles around the collapsed vertex would flip, or if they reference a vertex that has
+	// already been touched by another collapse in the current pass
+	static bool IsCollapseValid(const Collapse& collapse, const std::vector<Vector3d>& positions, const std::vector<IndexType>& indices,
+		const std::vector<uint32_t>& adjacencyOffsets, const std::vector<uint32_t>& adjacency, const std::vector<bool>& isTouched)
+	{
+		for (uint32_t i = adjacencyOffsets[collapse.from]; i < adjacencyOffsets[collapse.from + 1]; i++)
+		{
+			const IndexType* triangle = &indices[static_cast<size_t>(adjacency[i]) * 3];
+			if (isTouched[triangle[0]] || isTouched[triangle[1]] || isTouched[triangle[2]])
+			{
+				return false;
+			}
+
+			// These triangles become degenerate and are removed
+			if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+			{
+				continue;
+			}
+
+			Vector3d before[3];
+			Vector3d after[3];
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				before[j] = positions[triangle[j]];
+				after[j] = positions[triangle[j] == collapse.from ? collapse.to : triangle[j]];
+			}
+
+			Vector3d normalBefore = Cross(Subtract(before[1], before[0]), Subtract(before[2], before[0]));
+			Vector3d normalAfter = Cross(Subtract(after[1], after[0]), Subtract(after[2], after[0]));
+			if (Dot(normalBefore, normalAfter) <= 0.0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	namespace MeshUtils
+	{
+		uint32_t GenerateWeldRemap(const void* vertexData, uint32_t vertexStride, uint32_t vertexCount,
+			const std::vector<VkVertexInputAttributeDescription>& attributes, float epsilon, std::vector<uint32_t>& outRemap)
+		{
+			// Every attribute is converted into a comparable key, where float components are replaced by their quantized
+			// values. Vertices with identical keys are considered duplicates
+			uint32_t keyStride = 0;
+			for (const auto& attribute : attributes)
+			{
+				uint32_t attributeSize = GetAttributeSize(attribute.format);
+				TNG_ASSERT_MSG(attributeSize != 0, "Unsupported vertex attribute format for vertex welding!");
+
+				// Quantized float components are stored as 64-bit integers so large coordinates with a tiny epsilon can't overflow
+				uint32_t floatCount = GetFloatComponentCount(attribute.format);
+				keyStride += floatCount > 0 ? floatCount * static_cast<uint32_t>(sizeof(int64_t)) : attributeSize;
+			}
+
+			const uint8_t* vertexBytes = static_cast<const uint8_t*>(vertexData);
+			double inverseEpsilon = epsilon > 0.0f ? 1.0 / static_cast<double>(epsilon) : 0.0;
+
+			std::vector<uint8_t> keys(static_cast<size_t>(keyStride) * vertexCount);
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				const uint8_t* vertex = vertexBytes + static_cast<size_t>(i) * vertexStride;
+				uint8_t* key = keys.data() + static_cast<size_t>(i) * keyStride;
+
+				for (const auto& attribute : attributes)
+				{
+					uint32_t floatCount = GetFloatComponentCount(attribute.format);
+					if (floatCount == 0)
+					{
+						uint32_t attributeSize = GetAttributeSize(attribute.format);
+						memcpy(key, vertex + attribute.offset, attributeSize);
+						key += attributeSize;
+						continue;
+					}
+
+					for (uint32_t j = 0; j < floatCount; j++)
+					{
+						float value;
+						memcpy(&value, vertex + attribute.offset + j * sizeof(float), sizeof(float));
+
+						int64_t quantized = 0;
+						if (epsilon > 0.0f)
+						{
+							quantized = std::llround(static_cast<double>(value) * inverseEpsilon);
+						}
+						else
+						{
+							// Make sure negative and positive zero compare equal
+							if (value == 0.0f) value = 0.0f;
+							memcpy(&quantized, &value, sizeof(float));
+						}
+
+						memcpy(key, &quantized, sizeof(quantized));
+						key += sizeof(quantized);
+					}
+				}
+			}
+
+			// Open-addressing hash table of vertex indices, sized to the next power of two above twice the vertex count
+			uint32_t tableSize = 1;
+			while (tableSize < vertexCount * 2) tableSize <<= 1;
+
+			static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+			std::vector<uint32_t> table(tableSize, EMPTY_SLOT);
+
+			outRemap.resize(vertexCount);
+			uint32_t uniqueCount = 0;
+
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				const uint8_t* key = keys.data() + static_cast<size_t>(i) * keyStride;
+				uint32_t slot = static_cast<uint32_t>(HashBytes(key, keyStride)) & (tableSize - 1);
+
+				while (true)
+				{
+					uint32_t candidate = table[slot];
+					if (candidate == EMPTY_SLOT)
+					{
+						table[slot] = i;
+						outRemap[i] = uniqueCount++;
+						break;
+					}
+
+					if (memcmp(key, keys.data() + static_cast<size_t>(candidate) * keyStride, keyStride) == 0)
+					{
+						outRemap[i] = outRemap[candidate];
+						break;
+					}
+
+					slot = (slot + 1) & (tableSize - 1);
+				}
+			}
+
+			return uniqueCount;
+		}
+
+		VertexCacheStatistics AnalyzeVertexCache(const std::vector<IndexType>& indices, uint32_t vertexCount, uint32_t cacheSize)
+		{
+			VertexCacheStatistics stats;
+			if (vertexCount == 0 || indices.size() < 3)
+			{
+				return stats;
+			}
+
+			// A vertex is still in the FIFO cache as long as fewer than cacheSize misses have happened since it was inserted,
+			// so we store the miss count at which each vertex gets evicted
+			std::vector<uint32_t> evictionTime(vertexCount, 0);
+			uint32_t misses = 0;
+
+			for (IndexType index : indices)
+			{
+				if (misses >= evictionTime[index])
+				{
+					misses++;
+					evictionTime[index] = misses + cacheSize;
+				}
+			}
+
+			uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+			stats.vertexTransforms = misses;
+			stats.acmr = static_cast<float>(misses) / static_cast<float>(triangleCount);
+			stats.atvr = static_cast<float>(misses) / static_cast<float>(vertexCount);
+
+			return stats;
+		}
+
+		void OptimizeVertexCache(std::vector<IndexType>& indices, uint32_t vertexCount, uint32_t cacheSize)
+		{
+			uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+			if (triangleCount == 0 || vertexCount == 0)
+			{
+				return;
+			}
+
+			// Build the vertex-triangle adjacency, stored as a flattened array with per-vertex offsets
+			std::vector<uint32_t> liveTriangles(vertexCount, 0);
+			for (uint32_t i = 0; i < triangleCount * 3; i++)
+			{
+				liveTriangles[indices[i]]++;
+			}
+
+			std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				adjacencyOffsets[i + 1] = adjacencyOffsets[i] + liveTriangles[i];
+			}
+
+			std::vector<uint32_t> adjacency(adjacencyOffsets[vertexCount]);
+			std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t i = 0; i < triangleCount * 3; i++)
+			{
+				adjacency[adjacencyFill[indices[i]]++] = i / 3;
+			}
+
+			std::vector<uint32_t> cacheTime(vertexCount, 0);
+			std::vector<bool> emitted(triangleCount, false);
+			std::vector<uint32_t> deadEnds;
+			std::vector<uint32_t> candidates;
+
+			std::vector<IndexType> output;
+			output.reserve(triangleCount * 3);
+
+			int64_t fanningVertex = 0;
+			uint32_t timestamp = cacheSize + 1;
+			uint32_t cursor = 1;
+
+			while (fanningVertex >= 0)
+			{
+				uint32_t fan = static_cast<uint32_t>(fanningVertex);
+				candidates.clear();
+
+				// Emit all the triangles around the fanning vertex that haven't been emitted yet
+				for (uint32_t i = adjacencyOffsets[fan]; i < adjacencyOffsets[fan + 1]; i++)
+				{
+					uint32_t triangle = adjacency[i];
+					if (emitted[triangle]) continue;
+
+					for (uint32_t j = 0; j < 3; j++)
+					{
+						IndexType vertex = indices[triangle * 3 + j];
+						output.push_back(vertex);
+						deadEnds.push_back(vertex);
+						candidates.push_back(vertex);
+						liveTriangles[vertex]--;
+
+						// Not in cache, so it gets inserted
+						if (timestamp - cacheTime[vertex] > cacheSize)
+						{
+							cacheTime[vertex] = timestamp++;
+						}
+					}
+
+					emitted[triangle] = true;
+				}
+
+				// Pick the candidate that will still be in the cache after emitting all it's remaining triangles, preferring the oldest one
+				fanningVertex = -1;
+				int64_t bestPriority = -1;
+				for (uint32_t vertex : candidates)
+				{
+					if (liveTriangles[vertex] == 0) continue;
+
+					int64_t priority = 0;
+					if (timestamp - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+					{
+						priority = timestamp - cacheTime[vertex];
+					}
+
+					if (priority > bestPriority)
+					{
+						bestPriority = priority;
+						fanningVertex = vertex;
+					}
+				}
+
+				// Dead end, so we backtrack through the recently-emitted vertices and fall back to a linear scan
+				while (fanningVertex < 0 && !deadEnds.empty())
+				{
+					uint32_t vertex = deadEnds.back();
+					deadEnds.pop_back();
+
+					if (liveTriangles[vertex] > 0)
+					{
+						fanningVertex = vertex;
+					}
+				}
+
+				while (fanningVertex < 0 && cursor < vertexCount)
+				{
+					if (liveTriangles[cursor] > 0)
+					{
+						fanningVertex = cursor;
+					}
+
+					cursor++;
+				}
+			}
+
+			TNG_ASSERT_MSG(output.size() == triangleCount * 3, "Vertex cache optimization did not emit every triangle!");
+			std::copy(output.begin(), output.end(), indices.begin());
+		}
+
+		VkIndexType SelectIndexType(const std::vector<IndexType>& indices)
+		{
+			for (IndexType index : indices)
+			{
+				if (index > std::numeric_limits<uint16_t>::max())
+				{
+					return VK_INDEX_TYPE_UINT32;
+				}
+			}
+
+			return VK_INDEX_TYPE_UINT16;
+		}
+
+		float SimplifyIndices(const void* vertexData, uint32_t vertexStride, uint32_t positionOffset, uint32_t vertexCount,
+			const IndexType* indices, uint32_t indexCount, uint32_t targetIndexCount, float targetError, float errorScale, std::vector<IndexType>& outIndices)
+		{
+			outIndices.assign(indices, indices + indexCount);
+			if (vertexCount == 0 || indexCount < 3 || indexCount <= targetIndexCount || errorScale <= 0.0f)
+			{
+				return 0.0f;
+			}
+
+			// Positions are scaled by the error scale, so the quadric errors are directly comparable to the target error
+			const uint8_t* vertexBytes = static_cast<const uint8_t*>(vertexData);
+			double inverseScale = 1.0 / static_cast<double>(errorScale);
+
+			std::vector<Vector3d> positions(vertexCount);
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				float position[3];
+				memcpy(position, vertexBytes + static_cast<size_t>(i) * vertexStride + positionOffset, sizeof(position));
+
+				positions[i] = { position[0] * inverseScale, position[1] * inverseScale, position[2] * inverseScale };
+			}
+
+			std::vector<bool> isLocked = FindLockedVertices(positions, outIndices);
+
+			// Every vertex starts out with the planes of all the triangles around it
+			std::vector<Quadric> quadrics(vertexCount);
+			for (size_t i = 0; i + 2 < outIndices.size(); i += 3)
+			{
+				const Vector3d& p0 = positions[outIndices[i + 0]];
+				const Vector3d& p1 = positions[outIndices[i + 1]];
+				const Vector3d& p2 = positions[outIndices[i + 2]];
+
+				Vector3d normal = Cross(Subtract(p1, p0), Subtract(p2, p0));
+				double length = Length(normal);
+				if (length <= 0.0) continue;
+
+				// The cross product's length is twice the triangle's area, which is what every plane is weighted by
+				Quadric plane = CreatePlaneQuadric({ normal.x / length, normal.y / length, normal.z / length }, p0, length * 0.5);
+				for (uint32_t j = 0; j < 3; j++)
+				{
+					AddQuadric(quadrics[outIndices[i + j]], plane);
+				}
+			}
+
+			double maxCost = static_cast<double>(targetError) * static_cast<double>(targetError);
+			double achievedCost = 0.0;
+
+			std::vector<uint32_t> adjacencyOffsets;
+			std::vector<uint32_t> adjacency;
+			std::vector<Collapse> collapses;
+			std::vector<uint32_t> collapseTarget(vertexCount);
+			std::vector<bool> isTouched(vertexCount);
+
+			while (outIndices.size() > targetIndexCount)
+			{
+				uint32_t triangleCount = static_cast<uint32_t>(outIndices.size() / 3);
+				BuildTriangleAdjacency(outIndices, vertexCount, adjacencyOffsets, adjacency);
+
+				// Every interior edge shows up once in each direction, so we only need to look at one of them. Boundary edges are skipped
+				// entirely, since both of their vertices are locked
+				collapses.clear();
+				for (uint32_t i = 0; i < triangleCount * 3; i++)
+				{
+					uint32_t a = outIndices[i];
+					uint32_t b = outIndices[(i % 3 == 2) ? i - 2 : i + 1];
+					if (a > b) continue;
+
+					double costAB = isLocked[a] ? std::numeric_limits<double>::max() : EvaluateQuadric(quadrics[a], positions[b]);
+					double costBA = isLocked[b] ? std::numeric_limits<double>::max() : EvaluateQuadric(quadrics[b], positions[a]);
+
+					Collapse collapse = (costAB <= costBA) ? Collapse{ a, b, costAB } : Collapse{ b, a, costBA };
+					if (collapse.cost <= maxCost)
+					{
+						collapses.push_back(collapse);
+					}
+				}
+
+				if (collapses.empty())
+				{
+					break;
+				}
+
+				std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.cost < rhs.cost; });
+
+				// Perform as many independent collapses as we can in this pass. Once a vertex is collapsed, every vertex around it is
+				// touched so the adjacency we use to validate the remaining collapses never goes stale
+				for (uint32_t i = 0; i < vertexCount; i++)
+				{
+					collapseTarget[i] = i;
+				}
+				std::fill(isTouched.begin(), isTouched.end(), false);
+
+				uint32_t trianglesToRemove = static_cast<uint32_t>((outIndices.size() - targetIndexCount) / 3);
+				uint32_t removedTriangles = 0;
+
+				for (const Collapse& collapse : collapses)
+				{
+					if (removedTriangles >= trianglesToRemove)
+					{
+						break;
+					}
+
+					if (isTouched[collapse.from] || isTouched[collapse.to])
+					{
+						continue;
+					}
+
+					if (!IsCollapseValid(collapse, positions, outIndices, adjacencyOffsets, adjacency, isTouched))
+					{
+						continue;
+					}
+
+					for (uint32_t j = adjacencyOffsets[collapse.from]; j < adjacencyOffsets[collapse.from + 1]; j++)
+					{
+						const IndexType* triangle = &outIndices[static_cast<size_t>(adjacency[j]) * 3];
+						if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+						{
+							removedTriangles++;
+						}
+
+						isTouched[triangle[0]] = true;
+						isTouched[triangle[1]] = true;
+						isTouched[triangle[2]] = true;
+					}
+
+					collapseTarget[collapse.from] = collapse.to;
+					AddQuadric(quadrics[collapse.to], quadrics[collapse.from]);
+					achievedCost = std::max(achievedCost, collapse.cost);
+				}
+
+				if (removedTriangles == 0)
+				{
+					break;
+				}
+
+				// Apply the collapses and drop the triangles that became degenerate
+				size_t writeIndex = 0;
+				for (size_t i = 0; i < outIndices.size(); i += 3)
+				{
+					IndexType i0 = static_cast<IndexType>(collapseTarget[outIndices[i + 0]]);
+					IndexType i1 = static_cast<IndexType>(collapseTarget[outIndices[i + 1]]);
+					IndexType i2 = static_cast<IndexType>(collapseTarget[outIndices[i + 2]]);
+					if (i0 == i1 || i1 == i2 || i0 == i2) continue;
+
+					outIndices[writeIndex++] = i0;
+					outIndices[writeIndex++] = i1;
+					outIndices[writeIndex++] = i2;
+				}
+				outIndices.resize(writeIndex);
+			}
+
+			return static_cast<float>(std::sqrt(achievedCost));
+		}
+
+		uint32_t GenerateLODChain(const void* vertexData, uint32_t vertexStride, uint32_t positionOffset, uint32_t vertexCount, BaseMesh* mesh,
+			uint32_t maxLODs, float reduction, float maxError, uint32_t cacheSize)
+		{
+			mesh->lods.clear();
+			if (vertexCount == 0 || mesh->submeshes.empty())
+			{
+				return 0;
+			}
+
+			// Errors are measured relative to the largest dimension of the whole mesh, so small submeshes aren't simplified more aggressively
+			const uint8_t* vertexBytes = static_cast<const uint8_t*>(vertexData);
+			float minBounds[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+			float maxBounds[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				float position[3];
+				memcpy(position, vertexBytes + static_cast<size_t>(i) * vertexStride + positionOffset, sizeof(position));
+
+				for (uint32_t j = 0; j < 3; j++)
+				{
+					minBounds[j] = std::min(minBounds[j], position[j]);
+					maxBounds[j] = std::max(maxBounds[j], position[j]);
+				}
+			}
+
+			float errorScale = std::max(maxBounds[0] - minBounds[0], std::max(maxBounds[1] - minBounds[1], maxBounds[2] - minBounds[2]));
+			if (errorScale <= 0.0f)
+			{
+				return 0;
+			}
+
+			// Submesh indices are relative to their vertex offset, so the vertex range of every submesh is the largest index it uses
+			std::vector<uint32_t> submeshVertexCounts(mesh->submeshes.size(), 0);
+			uint64_t baseIndexCount = 0;
+			for (size_t i = 0; i < mesh->submeshes.size(); i++)
+			{
+				const Submesh& submesh = mesh->submeshes[i];
+				for (uint32_t j = 0; j < submesh.indexCount; j++)
+				{
+					submeshVertexCounts[i] = std::max(submeshVertexCounts[i], static_cast<uint32_t>(mesh->indices[submesh.firstIndex + j]) + 1);
+				}
+
+				baseIndexCount += submesh.indexCount;
+			}
+
+			uint64_t previousIndexCount = baseIndexCount;
+			float targetRatio = 1.0f;
+
+			std::vector<std::vector<IndexType>> simplifiedIndices(mesh->submeshes.size());
+			for (uint32_t lod = 0; lod < maxLODs; lod++)
+			{
+				targetRatio *= reduction;
+
+				MeshLOD meshLOD;
+				uint64_t lodIndexCount = 0;
+
+				// Every LOD is simplified from the base mesh instead of the previous LOD, so the errors don't accumulate
+				for (size_t i = 0; i < mesh->submeshes.size(); i++)
+				{
+					const Submesh& submesh = mesh->submeshes[i];
+					uint32_t targetIndexCount = static_cast<uint32_t>(submesh.indexCount * targetRatio) / 3 * 3;
+
+					float error = SimplifyIndices(vertexBytes + static_cast<size_t>(submesh.vertexOffset) * vertexStride, vertexStride, positionOffset, submeshVertexCounts[i],
+						&mesh->indices[submesh.firstIndex], submesh.indexCount, targetIndexCount, maxError, errorScale, simplifiedIndices[i]);
+
+					meshLOD.error = std::max(meshLOD.error, error);
+					lodIndexCount += simplifiedIndices[i].size();
+				}
+
+				// Not worth keeping a LOD that barely removes any triangles, and the following ones won't do any better
+				if (lodIndexCount == 0 || static_cast<double>(lodIndexCount) > static_cast<double>(previousIndexCount) * 0.9)
+				{
+					break;
+				}
+
+				for (size_t i = 0; i < mesh->submeshes.size(); i++)
+				{
+					OptimizeVertexCache(simplifiedIndices[i], submeshVertexCounts[i], cacheSize);
+
+					Submesh lodSubmesh = mesh->submeshes[i];
+					lodSubmesh.firstIndex = static_cast<uint32_t>(mesh->indices.size());
+					lodSubmesh.indexCount = static_cast<uint32_t>(simplifiedIndices[i].size());
+
+					mesh->indices.insert(mesh->indices.end(), simplifiedIndices[i].begin(), simplifiedIndices[i].end());
+					meshLOD.submeshes.push_back(lodSubmesh);
+				}
+
+				mesh->lods.push_back(std::move(meshLOD));
+				previousIndexCount = lodIndexCount;
+			}
+
+			return static_cast<uint32_t>(mesh->lods.size());
+		}
+
+		void NarrowIndices(const std::vector<IndexType>& indices, std::vector<uint16_t>& outIndices)
+		{
+			outIndices.resize(indices.size());
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				TNG_ASSERT_MSG(indices[i] <= std::numeric_limits<uint16_t>::max(), "Index does not fit in 16 bits!");
+				outIndices[i] = static_cast<uint16_t>(indices[i]);
+			}
+		}
+
+		void GenerateVertexFetchRemap(const std::vector<IndexType>& indices, uint32_t vertexCount, std::vector<uint32_t>& outRemap)
+		{
+			static constexpr uint32_t UNASSIGNED = 0xFFFFFFFF;
+
+			outRemap.assign(vertexCount, UNASSIGNED);
+
+			uint32_t nextVertex = 0;
+			for (IndexType index : indices)
+			{
+				if (outRemap[index] == UNASSIGNED)
+				{
+					outRemap[index] = nextVertex++;
+				}
+			}
+
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				if (outRemap[i] == UNASSIGNED)
+				{
+					outRemap[i] = nextVertex++;
+				}
+			}
+		}
+	}
+}
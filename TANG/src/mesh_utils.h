@@ -0,0 +1,210 @@
+#ifndef MESH_UTILS_H
+#define MESH_UTILS_H
+
+#include <algorithm>
+#include <vector>
+
+#include "asset_types.h"
+#include "utils/logger.h"
+
+namespace TANG
+{
+	// Import-time processing stages that operate on any Mesh<T>. The templated functions are thin wrappers which
+	// forward the raw vertex data to the type-agnostic implementations, using the vertex attribute descriptions
+	// every vertex type already provides to figure out how to interpret each vertex
+	namespace MeshUtils
+	{
+		// Generates a remap table that merges duplicate vertices. Float attributes (R32, R32G32, R32G32B32 and R32G32B32A32 SFLOAT)
+		// are considered equal when they quantize to the same multiple of epsilon, an epsilon of zero requires them to be bitwise-equal.
+		// Every other attribute format is compared bitwise. The remap table maps every original vertex to it's new index, and the new
+		// indices are assigned in order of first appearance. Returns the number of unique vertices
+		uint32_t GenerateWeldRemap(const void* vertexData, uint32_t vertexStride, uint32_t vertexCount,
+			const std::vector<VkVertexInputAttributeDescription>& attributes, float epsilon, std::vector<uint32_t>& outRemap);
+
+		// Statistics of how well the index order makes use of the post-transform vertex cache, simulated as a FIFO cache.
+		// ACMR is the average number of vertex shader invocations per triangle (0.5 is ideal for large regular meshes,
+		// 3.0 is the worst case). ATVR is the number of vertex shader invocations per vertex (1.0 is ideal)
+		struct VertexCacheStatistics
+		{
+			uint32_t vertexTransforms = 0;
+			float acmr = 0.0f;
+			float atvr = 0.0f;
+		};
+
+		VertexCacheStatistics AnalyzeVertexCache(const std::vector<IndexType>& indices, uint32_t vertexCount, uint32_t cacheSize);
+
+		// Reorders the triangles for post-transform vertex cache locality using the Tipsify algorithm (Sander et al., "Fast
+		// Triangle Reordering for Vertex Locality and Reduced Overdraw"). The vertices themselves are left untouched
+		void OptimizeVertexCache(std::vector<IndexType>& indices, uint32_t vertexCount, uint32_t cacheSize);
+
+		// Returns VK_INDEX_TYPE_UINT16 if every index fits in 16 bits, and VK_INDEX_TYPE_UINT32 otherwise. Primitive restart
+		// is never enabled for our pipelines, so the full 16-bit range can be used
+		VkIndexType SelectIndexType(const std::vector<IndexType>& indices);
+
+		// Copies the indices into a 16-bit vector, which must only be done if SelectIndexType() returned VK_INDEX_TYPE_UINT16
+		void NarrowIndices(const std::vector<IndexType>& indices, std::vector<uint16_t>& outIndices);
+
+		// Generates a remap table that orders the vertices by their first use in the index buffer, so vertex fetches become
+		// as sequential as possible. Vertices that are never referenced are moved to the end. The remap table maps every
+		// original vertex to it's new index
+		void GenerateVertexFetchRemap(const std::vector<IndexType>& indices, uint32_t vertexCount, std::vector<uint32_t>& outRemap);
+
+		// Simplifies the triangles using quadric error metrics (Garland and Heckbert, "Surface Simplification Using Quadric Error Metrics").
+		// Only half-edge collapses are performed, meaning a vertex is always collapsed into one of it's neighbours, so the simplified indices
+		// reference the original vertices and no new vertices are created. Vertices on open boundaries and vertices that share their position
+		// with another vertex (UV or normal seams) are never collapsed, so the silhouette and seams don't crack. Simplification stops once the
+		// index count reaches targetIndexCount or no collapse within targetError is left. The error is measured in units of errorScale, which
+		// is usually the size of the whole mesh. Returns the largest error of the collapses that were performed
+		float SimplifyIndices(const void* vertexData, uint32_t vertexStride, uint32_t positionOffset, uint32_t vertexCount,
+			const IndexType* indices, uint32_t indexCount, uint32_t targetIndexCount, float targetError, float errorScale, std::vector<IndexType>& outIndices);
+
+		// Generates up to maxLODs simplified versions of the mesh, every one with roughly reduction times the triangles of the previous one.
+		// Every submesh is simplified separately from the base mesh, and the simplified indices are optimized for the vertex cache and appended
+		// to the mesh's indices. The chain stops early once the simplification can't make meaningful progress anymore. Returns the number of LODs
+		uint32_t GenerateLODChain(const void* vertexData, uint32_t vertexStride, uint32_t positionOffset, uint32_t vertexCount, BaseMesh* mesh,
+			uint32_t maxLODs, float reduction, float maxError, uint32_t cacheSize);
+
+		// Reorders the vertices for fetch locality and remaps the indices to match. This should run after OptimizeVertexCache(),
+		// since it depends on the final triangle order
+		template<typename T>
+		void OptimizeVertexFetch(Mesh<T>* mesh)
+		{
+			uint32_t vertexCount = static_cast<uint32_t>(mesh->vertices.size());
+
+			std::vector<uint32_t> remap;
+			GenerateVertexFetchRemap(mesh->indices, vertexCount, remap);
+
+			std::vector<T> reorderedVertices(vertexCount);
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				reorderedVertices[remap[i]] = mesh->vertices[i];
+			}
+
+			for (IndexType& index : mesh->indices)
+			{
+				index = static_cast<IndexType>(remap[index]);
+			}
+
+			mesh->vertices = std::move(reorderedVertices);
+		}
+
+		// Runs all the vertex cache and vertex fetch optimizations on the mesh, and logs the vertex cache statistics before and after
+		template<typename T>
+		void OptimizeMesh(Mesh<T>* mesh, uint32_t cacheSize)
+		{
+			uint32_t vertexCount = static_cast<uint32_t>(mesh->vertices.size());
+			if (vertexCount == 0 || mesh->indices.size() < 3)
+			{
+				return;
+			}
+
+			VertexCacheStatistics before = AnalyzeVertexCache(mesh->indices, vertexCount, cacheSize);
+
+			OptimizeVertexCache(mesh->indices, vertexCount, cacheSize);
+			OptimizeVertexFetch(mesh);
+
+			VertexCacheStatistics after = AnalyzeVertexCache(mesh->indices, vertexCount, cacheSize);
+
+			LogInfo("Optimized mesh for a %u-entry vertex cache. ACMR: %.3f -> %.3f | ATVR: %.3f -> %.3f | Vertex transforms: %u -> %u",
+				cacheSize, before.acmr, after.acmr, before.atvr, after.atvr, before.vertexTransforms, after.vertexTransforms);
+		}
+
+		// Generates the mesh's LOD chain (see GenerateLODChain()). The position is the vertex attribute at location 0, which must be a vec3
+		template<typename T>
+		void GenerateLODs(Mesh<T>* mesh, uint32_t maxLODs, float reduction, float maxError, uint32_t cacheSize)
+		{
+			const VkVertexInputAttributeDescription* position = nullptr;
+			for (const auto& attribute : T::GetAttributeDescriptions())
+			{
+				if (attribute.location == 0) position = &attribute;
+			}
+
+			if (position == nullptr || position->format != VK_FORMAT_R32G32B32_SFLOAT)
+			{
+				LogWarning("Failed to generate mesh LODs, the vertex type has no vec3 position at location 0!");
+				return;
+			}
+
+			GenerateLODChain(mesh->vertices.data(), sizeof(T), position->offset, static_cast<uint32_t>(mesh->vertices.size()), mesh, maxLODs, reduction, maxError, cacheSize);
+
+			uint32_t baseIndexCount = 0;
+			for (const Submesh& submesh : mesh->submeshes) baseIndexCount += submesh.indexCount;
+
+			for (uint32_t i = 0; i < static_cast<uint32_t>(mesh->lods.size()); i++)
+			{
+				uint32_t lodIndexCount = 0;
+				for (const Submesh& submesh : mesh->lods[i].submeshes) lodIndexCount += submesh.indexCount;
+
+				LogInfo("Generated mesh LOD %u with %u of %u triangles (error %.4f)", i + 1, lodIndexCount / 3, baseIndexCount / 3, mesh->lods[i].error);
+			}
+		}
+
+		// Calculates the object-space AABB and bounding sphere of the mesh's vertices. Every vertex type has a vec3 position named pos
+		template<typename T>
+		MeshBounds CalculateBounds(const Mesh<T>* mesh)
+		{
+			MeshBounds bounds;
+			if (mesh->vertices.empty())
+			{
+				return bounds;
+			}
+
+			bounds.min = mesh->vertices[0].pos;
+			bounds.max = mesh->vertices[0].pos;
+			for (const T& vertex : mesh->vertices)
+			{
+				bounds.min = glm::min(bounds.min, vertex.pos);
+				bounds.max = glm::max(bounds.max, vertex.pos);
+			}
+
+			bounds.sphereCenter = (bounds.min + bounds.max) * 0.5f;
+			for (const T& vertex : mesh->vertices)
+			{
+				bounds.sphereRadius = std::max(bounds.sphereRadius, glm::length(vertex.pos - bounds.sphereCenter));
+			}
+
+			return bounds;
+		}
+
+		// Merges duplicate vertices, shrinking the vertex vector and remapping the indices to match.
+		// Returns the number of vertices that were removed
+		template<typename T>
+		uint32_t WeldVertices(Mesh<T>* mesh, float epsilon)
+		{
+			uint32_t vertexCount = static_cast<uint32_t>(mesh->vertices.size());
+			if (vertexCount == 0)
+			{
+				return 0;
+			}
+
+			std::vector<uint32_t> remap;
+			uint32_t uniqueCount = GenerateWeldRemap(mesh->vertices.data(), sizeof(T), vertexCount, T::GetAttributeDescriptions(), epsilon, remap);
+			if (uniqueCount == vertexCount)
+			{
+				return 0;
+			}
+
+			// New indices are assigned in order of first appearance, so the first vertex that maps to the next free slot is the one we keep
+			std::vector<T> weldedVertices;
+			weldedVertices.reserve(uniqueCount);
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				if (remap[i] == weldedVertices.size())
+				{
+					weldedVertices.push_back(mesh->vertices[i]);
+				}
+			}
+
+			for (IndexType& index : mesh->indices)
+			{
+				index = static_cast<IndexType>(remap[index]);
+			}
+
+			mesh->vertices = std::move(weldedVertices);
+
+			return vertexCount - uniqueCount;
+		}
+	}
+}
+
+#endif
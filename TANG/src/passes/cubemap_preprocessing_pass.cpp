@@ -1,10 +1,12 @@
 
+#include "../asset_loader.h"
 #include "../asset_types.h"
 #include "../cmd_buffer/primary_command_buffer.h"
 #include "../cmd_buffer/secondary_command_buffer.h"
 #include "../descriptors/write_descriptor_set.h"
 #include "../device_cache.h"
 #include "../render_passes/base_render_pass.h"
+#include "../texture_registry.h"
 #include "../ubo_structs.h"
 #include "cubemap_preprocessing_pass.h"
 
@@ -141,7 +143,28 @@ namespace TANG
 		samplerInfo.enableAnisotropicFiltering = false;
 		samplerInfo.maxAnisotropy = 1.0f;
 
-		skyboxTexture.CreateFromFile(CONFIG::SkyboxTextureFilePath, &baseImageInfo, &viewCreateInfo, &samplerInfo);
+		// The skybox is only sampled once to render the cubemap below, but the HDR source is still far larger than it's
+		// BC6H-compressed equivalent, which also loads much faster from it's TTEX cache than decoding the HDR file
+		bool compressSkybox = CONFIG::CompressSkyboxTexture && DeviceCache::Get().GetPhysicalDeviceFeatures().textureCompressionBC;
+		Texture* compressedSkybox = compressSkybox ? LoaderUtils::LoadTexture(CONFIG::SkyboxTextureFilePath, VK_FORMAT_BC6H_UFLOAT_BLOCK) : nullptr;
+		if (compressedSkybox != nullptr)
+		{
+			BaseImageCreateInfo compressedImageInfo = baseImageInfo;
+			compressedImageInfo.width = static_cast<uint32_t>(compressedSkybox->size.x);
+			compressedImageInfo.height = static_cast<uint32_t>(compressedSkybox->size.y);
+			compressedImageInfo.format = compressedSkybox->format;
+			compressedImageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+			compressedImageInfo.mipLevels = compressedSkybox->GetMipLevels();
+
+			skyboxTexture.CreateFromMipChain(compressedSkybox->data, compressedSkybox->mipOffsets.data(), &compressedImageInfo, &viewCreateInfo, &samplerInfo);
+
+			// Once uploaded we have no use for the CPU-side copy anymore
+			TextureRegistry::GetInstance().ReleaseTexture(compressedSkybox);
+		}
+		else
+		{
+			skyboxTexture.CreateFromFile(CONFIG::SkyboxTextureFilePath, &baseImageInfo, &viewCreateInfo, &samplerInfo);
+		}
 
 		//
 		// Create the offscreen textures that we'll render the cube faces to
@@ -614,7 +637,7 @@ namespace TANG
 			VkDescriptorSet descriptors[1] = { cubemapPreprocessingDescriptorSets[i].GetDescriptorSet() };
 			cmdBuffer->CMD_BindDescriptorSets(&cubemapPreprocessingPipeline, 1, descriptors);
 
-			cmdBuffer->CMD_DrawIndexed(asset->indexCount);
+			cmdBuffer->CMD_DrawIndexed(asset->indexCount, asset->firstIndex, asset->vertexOffset);
 		}
 
 		cmdBuffer->CMD_EndRenderPass();
@@ -633,7 +656,7 @@ namespace TANG
 			VkDescriptorSet descriptors[1] = { irradianceSamplingDescriptorSets[i].GetDescriptorSet() };
 			cmdBuffer->CMD_BindDescriptorSets(&irradianceSamplingPipeline, 1, descriptors);
 
-			cmdBuffer->CMD_DrawIndexed(asset->indexCount);
+			cmdBuffer->CMD_DrawIndexed(asset->indexCount, asset->firstIndex, asset->vertexOffset);
 		}
 
 		cmdBuffer->CMD_EndRenderPass();
@@ -663,7 +686,7 @@ namespace TANG
 				};
 				cmdBuffer->CMD_BindDescriptorSets(&prefilterMapPipeline, 2, descriptors);
 
-				cmdBuffer->CMD_DrawIndexed(asset->indexCount);
+				cmdBuffer->CMD_DrawIndexed(asset->indexCount, asset->firstIndex, asset->vertexOffset);
 			}
 
 			cmdBuffer->CMD_EndRenderPass();
@@ -679,7 +702,7 @@ namespace TANG
 		cmdBuffer->CMD_BeginRenderPass(&brdfConvolutionRenderPass, &brdfConvolutionFramebuffer, { CONFIG::BRDFConvolutionMapSize, CONFIG::BRDFConvolutionMapSize }, false, true);
 		cmdBuffer->CMD_BindPipeline(&brdfConvolutionPipeline);
 		cmdBuffer->CMD_BindMesh(fullscreenQuad);
-		cmdBuffer->CMD_DrawIndexed(fullscreenQuad->indexCount);
+		cmdBuffer->CMD_DrawIndexed(fullscreenQuad->indexCount, fullscreenQuad->firstIndex, fullscreenQuad->vertexOffset);
 
 		cmdBuffer->CMD_EndRenderPass();
 	}
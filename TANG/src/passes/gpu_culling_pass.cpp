@@ -0,0 +1,218 @@
+#include "../asset_types.h"
+#include "../cmd_buffer/command_buffer.h"
+#include "../descriptors/descriptor_pool.h"
+#include "../descriptors/write_descriptor_set.h"
+#include "../utils/logger.h"
+#include "gpu_culling_pass.h"
+
+namespace TANG
+{
+	// Must match the push constants of the GPU culling compute shader
+	struct CullingPushConstants
+	{
+		glm::vec4 frustumPlanes[6];
+		uint32_t objectCount;
+	};
+
+	static const uint32_t CullingWorkGroupSize = 64; // Must match local_size_x in the GPU culling compute shader
+
+	GPUCullingPass::GPUCullingPass() : wasCreated(false)
+	{ }
+
+	GPUCullingPass::~GPUCullingPass()
+	{ }
+
+	void GPUCullingPass::Create(const DescriptorPool* descriptorPool)
+	{
+		if (wasCreated)
+		{
+			LogWarning("Attempting to create GPU culling pass more than once!");
+			return;
+		}
+
+		CreateSetLayoutCaches();
+		CreateDescriptorSets(descriptorPool);
+		CreatePipelines();
+		CreateBuffers();
+
+		// The object, group and draw buffers never change, so they're only bound once. The instance buffer is bound by SetInstanceBuffer()
+		for (uint32_t i = 0; i < CONFIG::MaxFramesInFlight; i++)
+		{
+			FrameData& frame = frameData[i];
+
+			WriteDescriptorSets writeDescSets(3, 0);
+			writeDescSets.AddStorageBuffer(frame.descriptorSet.GetDescriptorSet(), 0, &frame.objectBuffer);
+			writeDescSets.AddStorageBuffer(frame.descriptorSet.GetDescriptorSet(), 1, &frame.groupBuffer);
+			writeDescSets.AddStorageBuffer(frame.descriptorSet.GetDescriptorSet(), 2, &frame.drawBuffer);
+			frame.descriptorSet.Update(writeDescSets);
+		}
+
+		wasCreated = true;
+	}
+
+	void GPUCullingPass::Destroy()
+	{
+		gpuCullingPipeline.Destroy();
+
+		for (FrameData& frame : frameData)
+		{
+			frame.drawBuffer.Destroy();
+			frame.groupBuffer.Destroy();
+			frame.objectBuffer.Destroy();
+		}
+
+		gpuCullingSetLayoutCache.DestroyLayouts();
+	}
+
+	void GPUCullingPass::SetInstanceBuffer(uint32_t frameIndex, const ShaderStorageBuffer* instanceBuffer)
+	{
+		WriteDescriptorSets writeDescSets(1, 0);
+		writeDescSets.AddStorageBuffer(frameData[frameIndex].descriptorSet.GetDescriptorSet(), 3, instanceBuffer);
+		frameData[frameIndex].descriptorSet.Update(writeDescSets);
+	}
+
+	void GPUCullingPass::ResetFrame(uint32_t frameIndex)
+	{
+		FrameData& frame = frameData[frameIndex];
+		frame.objectCount = 0;
+		frame.groupCount = 0;
+		frame.drawCount = 0;
+	}
+
+	bool GPUCullingPass::AddGroup(uint32_t frameIndex, uint32_t firstInstance, const std::vector<Submesh>& submeshes, uint32_t& outFirstDraw)
+	{
+		FrameData& frame = frameData[frameIndex];
+		if (frame.groupCount >= CONFIG::MaxDrawnAssetsPerFrame || frame.drawCount + submeshes.size() > CONFIG::MaxIndirectDrawsPerFrame)
+		{
+			return false;
+		}
+
+		CullingGroup& group = static_cast<CullingGroup*>(frame.groupBuffer.GetMappedData())[frame.groupCount++];
+		group.firstDraw = frame.drawCount;
+		group.drawCount = static_cast<uint32_t>(submeshes.size());
+		group.firstInstance = firstInstance;
+		group.padding = 0;
+
+		// The culling dispatch adds the instances, so every draw starts out empty
+		VkDrawIndexedIndirectCommand* draws = static_cast<VkDrawIndexedIndirectCommand*>(frame.drawBuffer.GetMappedData());
+		for (const Submesh& submesh : submeshes)
+		{
+			VkDrawIndexedIndirectCommand& draw = draws[frame.drawCount++];
+			draw.indexCount = submesh.indexCount;
+			draw.instanceCount = 0;
+			draw.firstIndex = submesh.firstIndex;
+			draw.vertexOffset = submesh.vertexOffset;
+			draw.firstInstance = firstInstance;
+		}
+
+		outFirstDraw = group.firstDraw;
+		return true;
+	}
+
+	bool GPUCullingPass::AddObject(uint32_t frameIndex, const glm::mat4& transform, const glm::vec3& boundsCenter, float boundsRadius)
+	{
+		FrameData& frame = frameData[frameIndex];
+		TNG_ASSERT_MSG(frame.groupCount > 0, "Attempting to add a culling object without a group!");
+
+		if (frame.objectCount >= CONFIG::MaxDrawnAssetsPerFrame)
+		{
+			return false;
+		}
+
+		CullingObject& object = static_cast<CullingObject*>(frame.objectBuffer.GetMappedData())[frame.objectCount++];
+		object.transform = transform;
+		object.boundingSphere = glm::vec4(boundsCenter, boundsRadius);
+		object.groupIndex = frame.groupCount - 1;
+
+		return true;
+	}
+
+	void GPUCullingPass::Draw(uint32_t frameIndex, CommandBuffer* cmdBuffer, const Frustum& frustum)
+	{
+		FrameData& frame = frameData[frameIndex];
+		if (frame.objectCount == 0)
+		{
+			return;
+		}
+
+		CullingPushConstants constants{};
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			constants.frustumPlanes[i] = frustum.planes[i];
+		}
+		constants.objectCount = frame.objectCount;
+
+		VkDescriptorSet descriptorSet = frame.descriptorSet.GetDescriptorSet();
+
+		cmdBuffer->CMD_BindPipeline(&gpuCullingPipeline);
+		cmdBuffer->CMD_PushConstants(&gpuCullingPipeline, static_cast<void*>(&constants), sizeof(constants), VK_SHADER_STAGE_COMPUTE_BIT);
+		cmdBuffer->CMD_BindDescriptorSets(&gpuCullingPipeline, 1, &descriptorSet);
+		cmdBuffer->CMD_Dispatch((frame.objectCount + CullingWorkGroupSize - 1) / CullingWorkGroupSize, 1, 1);
+
+		// The draws are consumed as indirect arguments and the transforms by the PBR vertex shader
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+		vkCmdPipelineBarrier(cmdBuffer->GetBuffer(),
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+			0,
+			1, &barrier,
+			0, nullptr,
+			0, nullptr);
+	}
+
+	const ShaderStorageBuffer* GPUCullingPass::GetDrawBuffer(uint32_t frameIndex) const
+	{
+		return &frameData[frameIndex].drawBuffer;
+	}
+
+	void GPUCullingPass::CreatePipelines()
+	{
+		gpuCullingPipeline.SetData(&gpuCullingSetLayoutCache);
+		gpuCullingPipeline.Create();
+	}
+
+	void GPUCullingPass::CreateSetLayoutCaches()
+	{
+		SetLayoutSummary volatileLayout(0);
+		volatileLayout.AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);	// Objects (readonly)
+		volatileLayout.AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);	// Groups (readonly)
+		volatileLayout.AddBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);	// Indirect draws
+		volatileLayout.AddBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);	// Instance transforms (writeonly)
+		gpuCullingSetLayoutCache.CreateSetLayout(volatileLayout, 0);
+	}
+
+	void GPUCullingPass::CreateDescriptorSets(const DescriptorPool* descriptorPool)
+	{
+		if (gpuCullingSetLayoutCache.GetLayoutCount() != 1)
+		{
+			LogError("Failed to create GPU culling pass descriptor sets, too many layouts! Expected (%u) vs. actual (%u)", 1, gpuCullingSetLayoutCache.GetLayoutCount());
+			return;
+		}
+
+		std::optional<DescriptorSetLayout> gpuCullingSetLayout = gpuCullingSetLayoutCache.GetSetLayout(0);
+		if (!gpuCullingSetLayout.has_value())
+		{
+			LogError("Failed to create GPU culling descriptor sets! Descriptor set layout is null");
+			return;
+		}
+
+		for (FrameData& frame : frameData)
+		{
+			frame.descriptorSet.Create(*descriptorPool, gpuCullingSetLayout.value());
+		}
+	}
+
+	void GPUCullingPass::CreateBuffers()
+	{
+		for (FrameData& frame : frameData)
+		{
+			frame.objectBuffer.Create(sizeof(CullingObject) * CONFIG::MaxDrawnAssetsPerFrame);
+			frame.groupBuffer.Create(sizeof(CullingGroup) * CONFIG::MaxDrawnAssetsPerFrame);
+			frame.drawBuffer.Create(sizeof(VkDrawIndexedIndirectCommand) * CONFIG::MaxIndirectDrawsPerFrame);
+		}
+	}
+}
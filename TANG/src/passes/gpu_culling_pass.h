@@ -0,0 +1,102 @@
+#ifndef GPU_CULLING_PASS_H
+#define GPU_CULLING_PASS_H
+
+#include <array>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../config.h"
+#include "../data_buffer/shader_storage_buffer.h"
+#include "../descriptors/descriptor_set.h"
+#include "../frustum_culler.h"
+#include "../pipelines/gpu_culling_pipeline.h"
+
+namespace TANG
+{
+	class CommandBuffer;
+	class DescriptorPool;
+	struct Submesh;
+
+	// Must match the structs in the GPU culling compute shader, which reads them as std430
+	struct CullingObject
+	{
+		glm::mat4 transform;
+		glm::vec4 boundingSphere;	// xyz: local center, w: local radius
+		uint32_t groupIndex;
+		uint32_t padding[3];
+	};
+
+	struct CullingGroup
+	{
+		uint32_t firstDraw;			// Index of the group's first indirect draw
+		uint32_t drawCount;
+		uint32_t firstInstance;		// Where the transforms of the group's visible objects are compacted to in the instance buffer
+		uint32_t padding;
+	};
+
+	// Frustum culls the drawn objects on the GPU, and writes the indirect draws the PBR assets are drawn with. Every instance group
+	// gets one indirect draw per submesh, which starts out with zero instances. The culling dispatch compacts the transforms of the
+	// visible objects into the group's range of the instance buffer and bumps the instance count of the group's draws, so the CPU
+	// never finds out what's visible. The objects, groups and draws are written by the CPU every frame into persistently-mapped buffers
+	class GPUCullingPass
+	{
+	public:
+
+		GPUCullingPass();
+		~GPUCullingPass();
+
+		GPUCullingPass(GPUCullingPass&& other) = delete;
+		GPUCullingPass(const GPUCullingPass& other) = delete;
+		GPUCullingPass& operator=(const GPUCullingPass& other) = delete;
+
+		void Create(const DescriptorPool* descriptorPool);
+		void Destroy();
+
+		// Sets the instance buffer the transforms of the visible objects are written to. Must be called for every frame in flight
+		void SetInstanceBuffer(uint32_t frameIndex, const ShaderStorageBuffer* instanceBuffer);
+
+		// Drops the objects and draws written for the frame. Must only be called once the GPU is done with the frame
+		void ResetFrame(uint32_t frameIndex);
+
+		// Starts a new instance group, whose visible objects are compacted from firstInstance onwards. Writes an indirect draw for every
+		// submesh, and returns the index of the first one. Returns false if the draw buffer is full
+		bool AddGroup(uint32_t frameIndex, uint32_t firstInstance, const std::vector<Submesh>& submeshes, uint32_t& outFirstDraw);
+
+		// Adds an object to the group that was added last. Returns false if the object buffer is full
+		bool AddObject(uint32_t frameIndex, const glm::mat4& transform, const glm::vec3& boundsCenter, float boundsRadius);
+
+		// Records the culling dispatch, followed by a barrier that makes the draws and transforms visible to the indirect draws and vertex
+		// shaders. Must be recorded outside of a render pass
+		void Draw(uint32_t frameIndex, CommandBuffer* cmdBuffer, const Frustum& frustum);
+
+		const ShaderStorageBuffer* GetDrawBuffer(uint32_t frameIndex) const;
+
+	private:
+
+		void CreatePipelines();
+		void CreateSetLayoutCaches();
+		void CreateDescriptorSets(const DescriptorPool* descriptorPool);
+		void CreateBuffers();
+
+		struct FrameData
+		{
+			ShaderStorageBuffer objectBuffer = ShaderStorageBuffer(0, true);
+			ShaderStorageBuffer groupBuffer = ShaderStorageBuffer(0, true);
+			ShaderStorageBuffer drawBuffer = ShaderStorageBuffer(VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, true);
+			DescriptorSet descriptorSet;
+
+			uint32_t objectCount = 0;
+			uint32_t groupCount = 0;
+			uint32_t drawCount = 0;
+		};
+
+		GPUCullingPipeline gpuCullingPipeline;
+		SetLayoutCache gpuCullingSetLayoutCache;
+		std::array<FrameData, CONFIG::MaxFramesInFlight> frameData;
+
+		bool wasCreated;
+	};
+}
+
+#endif
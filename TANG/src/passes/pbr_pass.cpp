@@ -96,7 +96,7 @@ namespace TANG
 		data.cmdBuffer->CMD_BindPipeline(&pbrPipeline);
 		data.cmdBuffer->CMD_BindMesh(data.asset);
 		data.cmdBuffer->CMD_BindDescriptorSets(&pbrPipeline, static_cast<uint32_t>(pbrDescriptorSets.size()), reinterpret_cast<VkDescriptorSet*>(pbrDescriptorSets[currentFrame].data()));
-		data.cmdBuffer->CMD_DrawIndexed(data.asset->indexCount);
+		data.cmdBuffer->CMD_DrawIndexed(data.asset->indexCount, data.asset->firstIndex, data.asset->vertexOffset);
 
 		data.cmdBuffer->EndRecording();
 	}
@@ -96,7 +96,7 @@ namespace TANG
 		data.cmdBuffer->CMD_BindPipeline(&skyboxPipeline);
 		data.cmdBuffer->CMD_BindMesh(data.asset);
 		data.cmdBuffer->CMD_BindDescriptorSets(&skyboxPipeline, static_cast<uint32_t>(skyboxDescriptorSets.size()), reinterpret_cast<VkDescriptorSet*>(skyboxDescriptorSets[currentFrame].data()));
-		data.cmdBuffer->CMD_DrawIndexed(data.asset->indexCount);
+		data.cmdBuffer->CMD_DrawIndexed(data.asset->indexCount, data.asset->firstIndex, data.asset->vertexOffset);
 
 		data.cmdBuffer->EndRecording();
 	}
@@ -0,0 +1,85 @@
+#include "../shaders/shader.h"
+#include "../utils/logger.h"
+#include "gpu_culling_pipeline.h"
+
+namespace TANG
+{
+
+	GPUCullingPipeline::GPUCullingPipeline() : BasePipeline()
+	{
+		FlushData();
+	}
+
+	GPUCullingPipeline::~GPUCullingPipeline()
+	{
+		FlushData();
+	}
+
+	GPUCullingPipeline::GPUCullingPipeline(GPUCullingPipeline&& other) noexcept : BasePipeline(std::move(other))
+	{
+		other.FlushData();
+	}
+
+	void GPUCullingPipeline::SetData(const SetLayoutCache* _setLayoutCache)
+	{
+		setLayoutCache = _setLayoutCache;
+
+		wasDataSet = true;
+	}
+
+	void GPUCullingPipeline::Create()
+	{
+		if (!wasDataSet)
+		{
+			LogError("Failed to create GPU culling pipeline! Create data has not been set correctly");
+			return;
+		}
+
+		std::vector<VkDescriptorSetLayout> setLayoutArray;
+		setLayoutCache->FlattenCache(setLayoutArray);
+
+		// Frustum planes and object count
+		VkPushConstantRange pushConstant{};
+		pushConstant.offset = 0;
+		pushConstant.size = sizeof(glm::vec4) * 6 + sizeof(uint32_t);
+		pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = PopulatePipelineLayoutCreateInfo(setLayoutArray.data(), static_cast<uint32_t>(setLayoutArray.size()), &pushConstant, 1);
+		if (!CreatePipelineLayout(pipelineLayoutInfo))
+		{
+			LogError("Failed to create GPU culling pipeline layout!");
+			return;
+		}
+
+		Shader compShader(ShaderType::GPU_CULLING, ShaderStage::COMPUTE_SHADER);
+		if (!compShader.IsValid())
+		{
+			LogError("Failed to create GPU culling pipeline. Shader creation failed!");
+			return;
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.layout = GetPipelineLayout();
+		pipelineInfo.stage = PopulateShaderCreateInfo(compShader);
+
+		if (!CreateComputePipelineObject(pipelineInfo))
+		{
+			LogError("Failed to create GPU culling pipeline!");
+		}
+	}
+
+	PipelineType GPUCullingPipeline::GetType() const
+	{
+		return PipelineType::COMPUTE;
+	}
+
+	void GPUCullingPipeline::FlushData()
+	{
+		setLayoutCache = nullptr;
+
+		wasDataSet = false;
+	}
+
+
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef GPU_CULLING_PIPELINE_H
+#define GPU_CULLING_PIPELINE_H
+
+#include "base_pipeline.h"
+
+namespace TANG
+{
+	class GPUCullingPipeline : public BasePipeline
+	{
+	public:
+
+		GPUCullingPipeline();
+		~GPUCullingPipeline();
+		GPUCullingPipeline(GPUCullingPipeline&& other) noexcept;
+
+		GPUCullingPipeline(const GPUCullingPipeline& other) = delete;
+		GPUCullingPipeline& operator=(const GPUCullingPipeline& other) = delete;
+
+		void SetData(const SetLayoutCache* setLayoutCache);
+
+		void Create() override;
+
+		PipelineType GetType() const override;
+
+	private:
+
+		void FlushData() override;
+
+		const SetLayoutCache* setLayoutCache;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -76,7 +76,7 @@ namespace TANG
 			VK_DYNAMIC_STATE_SCISSOR
 		};
 
-		VkPipelineVertexInputStateCreateInfo		vertexInputInfo			= PopulateVertexInputCreateInfo<PBRVertex>();
+		VkPipelineVertexInputStateCreateInfo		vertexInputInfo			= PopulateVertexInputCreateInfo<PackedPBRVertex>();
 		VkPipelineInputAssemblyStateCreateInfo		inputAssembly			= PopulateInputAssemblyCreateInfo();
 		VkViewport									viewport				= PopulateViewportInfo(viewportSize.width, viewportSize.height);
 		VkRect2D									scissor					= PopulateScissorInfo(viewportSize);
@@ -83,14 +83,13 @@ namespace TANG
 		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
 		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
-		uint32_t graphicsTransferQueue = std::numeric_limits<uint32_t>::max();
 		uint32_t i = 0;
 		for (const auto& queueFamily : queueFamilies)
 		{
 			// Check that the device supports a graphics queue and compute queue
 			// NOTE - We could potentially select separate queues for graphics and
 			//        compute, but let's keep it simple for now
-			if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT))
+			if (!indices.IsValid(indices.GetIndex(QueueType::GRAPHICS)) && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT))
 			{
 				indices.SetIndex(QueueType::GRAPHICS, i);
 				indices.SetIndex(QueueType::COMPUTE, i);
@@ -100,35 +99,42 @@ namespace TANG
 			VkBool32 presentSupport = false;
 			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
 
-			if (presentSupport)
+			if (!indices.IsValid(indices.GetIndex(QueueType::PRESENT)) && presentSupport)
 			{
 				indices.SetIndex(QueueType::PRESENT, i);
 			}
 
-			// Check that the device supports a transfer queue
-			if (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT)
+			i++;
+		}
+
+		// Uploads are recorded on the TRANSFER queue so they can overlap with rendering, which only happens if the queue comes from a different
+		// family than the graphics queue. A family that supports nothing but transfers usually maps to the dedicated copy engines, so we prefer
+		// it over one that also supports compute. If neither exists, we fall back to the graphics family (graphics queues always support transfers)
+		uint32_t graphicsFamily = indices.GetIndex(QueueType::GRAPHICS);
+		uint32_t computeTransferFamily = QueueFamilyIndices::INVALID_INDEX;
+		for (i = 0; i < queueFamilyCount; i++)
+		{
+			VkQueueFlags flags = queueFamilies[i].queueFlags;
+			if (i == graphicsFamily || !(flags & VK_QUEUE_TRANSFER_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT))
 			{
-				// Choose a different queue from the graphics queue, if possible
-				if (indices.GetIndex(QueueType::GRAPHICS) == i)
-				{
-					graphicsTransferQueue = i;
-				}
-				else
-				{
-					indices.SetIndex(QueueType::TRANSFER, i);
-				}
+				continue;
 			}
 
-			if (indices.IsComplete()) break;
+			if (!(flags & VK_QUEUE_COMPUTE_BIT))
+			{
+				indices.SetIndex(QueueType::TRANSFER, i);
+				break;
+			}
 
-			i++;
+			if (computeTransferFamily == QueueFamilyIndices::INVALID_INDEX)
+			{
+				computeTransferFamily = i;
+			}
 		}
 
-		// If we couldn't find a different queue for the TRANSFER and GRAPHICS operations, then simply
-		// use the same queue for both (if it supports TRANSFER operations)
-		if (!indices.IsValid(static_cast<QueueFamilyIndices::QueueFamilyIndexType>(QueueType::TRANSFER)) && graphicsTransferQueue != QueueFamilyIndices::INVALID_INDEX)
+		if (!indices.IsValid(indices.GetIndex(QueueType::TRANSFER)))
 		{
-			indices.SetIndex(QueueType::TRANSFER, graphicsTransferQueue);
+			indices.SetIndex(QueueType::TRANSFER, indices.IsValid(computeTransferFamily) ? computeTransferFamily : graphicsFamily);
 		}
 
 		// Check that we filled in all of our queue families, otherwise log a warning
@@ -19,9 +19,11 @@
 
 #pragma warning(pop) 
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <cstdint>
+#include <cstring> // memcpy
 
 // Unfortunately the renderer has to know about GLFW in order to create the surface, since the vulkan call itself
 // takes in a GLFWwindow pointer >:(. This also means we have to pass it into the renderer's Initialize() call,
@@ -31,6 +33,7 @@
 #include <glm/glm.hpp>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <set>
 #include <unordered_map>
 #include <vector>
@@ -39,12 +42,17 @@
 #include "cmd_buffer/disposable_command.h"
 #include "command_pool_registry.h"
 #include "config.h"
-#include "data_buffer/vertex_buffer.h"
-#include "data_buffer/index_buffer.h"
 #include "default_material.h"
 #include "descriptors/write_descriptor_set.h"
+#include "device_allocator.h"
 #include "device_cache.h"
+#include "geometry_arena.h"
+#include "mesh_utils.h"
 #include "queue_family_indices.h"
+#include "staging_ring.h"
+#include "upload_context.h"
+#include "texture_registry.h"
+#include "texture_streamer.h"
 #include "utils/file_utils.h"
 #include "ubo_structs.h"
 
@@ -108,11 +116,55 @@ namespace TANG
 		std::vector<VkPresentModeKHR> presentModes;
 	};
 
+	// Returns the index data that must be uploaded for the mesh, narrowing the indices into the provided vector if the mesh uses 16-bit indices
+	static void* GetIndexUploadData(BaseMesh* mesh, std::vector<uint16_t>& narrowIndices, uint64_t& outNumBytes)
+	{
+		if (mesh->indexType == VK_INDEX_TYPE_UINT16)
+		{
+			MeshUtils::NarrowIndices(mesh->indices, narrowIndices);
+			outNumBytes = narrowIndices.size() * sizeof(uint16_t);
+			return narrowIndices.data();
+		}
+
+		outNumBytes = mesh->indices.size() * sizeof(IndexType);
+		return mesh->indices.data();
+	}
+
+	static glm::mat4 CalculateTransformMatrix(const Transform& transform)
+	{
+		glm::mat4 translation = glm::translate(glm::identity<glm::mat4>(), transform.position);
+		glm::mat4 rotation = glm::eulerAngleXYZ(transform.rotation.x, transform.rotation.y, transform.rotation.z);
+		glm::mat4 scale = glm::scale(glm::identity<glm::mat4>(), transform.scale);
+
+		return translation * rotation * scale;
+	}
+
+	// Transforms the asset's object-space bounding sphere into world space. The radius is scaled by the largest axis of the scale, so
+	// the sphere still contains the asset if it's scaled non-uniformly
+	static void CalculateWorldBoundingSphere(const AssetResources& resources, glm::vec3& outCenter, float& outRadius)
+	{
+		const Transform& transform = resources.transform;
+
+		glm::mat4 rotation = glm::eulerAngleXYZ(transform.rotation.x, transform.rotation.y, transform.rotation.z);
+		outCenter = transform.position + glm::vec3(rotation * glm::vec4(resources.boundsCenter * transform.scale, 1.0f));
+
+		glm::vec3 absScale = glm::abs(transform.scale);
+		outRadius = resources.boundsRadius * std::max(absScale.x, std::max(absScale.y, absScale.z));
+	}
+
+	// Returns the draw ranges of the LOD the asset is currently drawn with
+	static const std::vector<Submesh>& GetCurrentSubmeshes(const AssetResources& resources)
+	{
+		return (resources.currentLOD == 0) ? resources.submeshes : resources.lods[resources.currentLOD - 1].submeshes;
+	}
+
 	Renderer::Renderer() : 
 		vkInstance(VK_NULL_HANDLE), debugMessenger(VK_NULL_HANDLE), surface(VK_NULL_HANDLE), queues(), swapChain(VK_NULL_HANDLE), 
 		swapChainImageFormat(VK_FORMAT_UNDEFINED), swapChainExtent({ 0, 0 }), frameDependentData(), swapChainImageDependentData(),
-		pbrSetLayoutCache(), pbrPipeline(), currentFrame(0), resourcesMap(), assetResources(), descriptorPool(), 
-		framebufferWidth(0), framebufferHeight(0), skyboxAssetUUID(INVALID_UUID), fullscreenQuadAssetUUID(INVALID_UUID)
+		pbrPipeline(), pbrSetLayoutCache(), skyboxAssetUUID(INVALID_UUID), fullscreenQuadAssetUUID(INVALID_UUID), uploadBatch(nullptr), uploadBatchAssets(),
+		currentFrame(0), gpuCullingEnabled(false), recordingThreadPool(), nextRecordingGroup(0), recordedAssetCommandBufferCount(0), preparedAssetCommandBuffers(),
+		resourcesMap(), assetResources(), sharedAssetResources(), sharedAssetUUIDs(), retiredAssetResources(), frameCounter(0), descriptorPool(),
+		framebufferWidth(0), framebufferHeight(0)
 	{ }
 
 	void Renderer::Initialize(GLFWwindow* windowHandle, uint32_t windowWidth, uint32_t windowHeight)
@@ -127,12 +179,15 @@ namespace TANG
 		CreateSurface(windowHandle);
 		PickPhysicalDevice();
 		CreateLogicalDevice();
+		DeviceAllocator::GetInstance().Create();
 		CreateSwapChain();
 		CreateDescriptorSetLayouts();
 		CreateDescriptorPool();
 		CreateRenderPasses();
 		CreatePipelines();
 		CreateCommandPools();
+		GeometryArena::GetInstance().Create(CONFIG::GeometryArenaBlockSize);
+		StagingRing::GetInstance().Create(CONFIG::StagingRingSize);
 		CreateColorAttachmentTextures();
 		CreateDepthTextures();
 		CreateFramebuffers();
@@ -147,6 +202,8 @@ namespace TANG
 		glm::vec3 eye = { 0.0f, 0.0f, 1.0f };
 		startingCameraPosition = { 0.0f, 5.0f, 15.0f };
 		startingCameraViewMatrix = glm::inverse(glm::lookAt(startingCameraPosition, startingCameraPosition + eye, { 0.0f, 1.0f, 0.0f })); 
+		cameraPosition = startingCameraPosition;
+		cameraViewMatrix = startingCameraViewMatrix;
 
 		// Calculate the starting projection matrix
 		float aspectRatio = swapChainExtent.width / static_cast<float>(swapChainExtent.height);
@@ -155,6 +212,17 @@ namespace TANG
 	
 		CreateFrameUniformBuffers();
 		InitializeFrameUniformBuffers();
+		CreateFrameDescriptorSets();
+
+		// The culling pass writes the transforms of the visible assets into the instance buffers, so they must exist first
+		if (gpuCullingEnabled)
+		{
+			gpuCullingPass.Create(&descriptorPool);
+			for (uint32_t i = 0; i < GetFDDSize(); i++)
+			{
+				gpuCullingPass.SetInstanceBuffer(i, &GetFDDAtIndex(i)->instanceBuffer);
+			}
+		}
 	}
 
 	void Renderer::Update(float deltaTime)
@@ -187,15 +255,32 @@ namespace TANG
 	{
 		VkDevice logicalDevice = DeviceCache::Get().GetLogicalDevice();
 
+		if (uploadBatch != nullptr)
+		{
+			LogWarning("Shutting down the renderer while an upload batch is still open!");
+			EndUploadBatch();
+		}
+
+		// Every upload in flight must be handed over to the graphics queue before waiting for the device, otherwise the ring would submit
+		// the ownership acquires after the resources they reference are destroyed
+		StagingRing& stagingRing = StagingRing::GetInstance();
+		stagingRing.Wait(stagingRing.GetStatistics().submittedValue);
+
 		vkDeviceWaitIdle(logicalDevice);
 
 		DestroyAllAssetResources();
+		GeometryArena::GetInstance().Destroy();
+		StagingRing::GetInstance().Destroy();
 
 		CleanupSwapChain();
 
 		cubemapPreprocessingPass.Destroy();
 		skyboxPass.Destroy();
 		bloomPass.Destroy();
+		if (gpuCullingEnabled)
+		{
+			gpuCullingPass.Destroy();
+		}
 
 		ldrSetLayoutCache.DestroyLayouts();
 		pbrSetLayoutCache.DestroyLayouts();
@@ -204,17 +289,13 @@ namespace TANG
 		{
 			auto frameData = GetFDDAtIndex(i);
 
-			for (auto& iter : frameData->assetDescriptorDataMap)
-			{
-				iter.second.transformUBO.Destroy();
-			}
-
 			frameData->hdrFramebuffer.Destroy();
 
 			frameData->ldrCameraDataUBO.Destroy();
 			frameData->cameraDataUBO.Destroy();
 			frameData->viewUBO.Destroy();
 			frameData->projUBO.Destroy();
+			frameData->instanceBuffer.Destroy();
 		}
 
 		descriptorPool.Destroy();
@@ -229,6 +310,7 @@ namespace TANG
 			vkDestroyFence(logicalDevice, frameData->inFlightFence, nullptr);
 		}
 
+		recordingThreadPool.Destroy();
 		CommandPoolRegistry::Get().DestroyPools();
 
 		ldrPipeline.Destroy();
@@ -237,6 +319,8 @@ namespace TANG
 		ldrRenderPass.Destroy();
 		hdrRenderPass.Destroy();
 
+		DeviceAllocator::GetInstance().Destroy();
+
 		vkDestroyDevice(logicalDevice, nullptr);
 		DeviceCache::Get().InvalidateCache();
 
@@ -256,39 +340,45 @@ namespace TANG
 	// assumes the caller handled a null asset correctly
 	AssetResources* Renderer::CreateAssetResources(AssetDisk* asset, CorePipeline corePipeline)
 	{
+		if ((corePipeline == CorePipeline::CUBEMAP_PREPROCESSING || corePipeline == CorePipeline::SKYBOX) && skyboxAssetUUID != INVALID_UUID)
+		{
+			LogError("Attempting to load skybox mesh more than once!");
+			return nullptr;
+		}
+
+		if (corePipeline == CorePipeline::FULLSCREEN_QUAD && fullscreenQuadAssetUUID != INVALID_UUID)
+		{
+			LogError("Attempting to load fullscreen quad mesh more than once!");
+			return nullptr;
+		}
+
 		assetResources.emplace_back(AssetResources());
 		resourcesMap.insert({ asset->uuid, static_cast<uint32_t>(assetResources.size() - 1) });
 
 		AssetResources& resources = assetResources.back();
 
+		// Assets created outside of an upload batch get a context of their own, which is submitted once all their resources are recorded. The
+		// uploads are recorded on the transfer queue so they overlap with rendering, and the asset is drawn once they complete
+		UploadContext assetContext(QueueType::TRANSFER);
+		UploadContext& context = (uploadBatch != nullptr) ? *uploadBatch : assetContext;
+
+		bool success = false;
 		switch (corePipeline)
 		{
 		case CorePipeline::PBR:
 		{
-			CreatePBRAssetResources(asset, resources);
+			success = CreatePBRAssetResources(context, asset, resources);
 			break;
 		}
 		case CorePipeline::CUBEMAP_PREPROCESSING:
 		case CorePipeline::SKYBOX:
 		{
-			if (skyboxAssetUUID != INVALID_UUID)
-			{
-				LogError("Attempting to load skybox mesh more than once!");
-				return nullptr;
-			}
-
-			CreateSkyboxAssetResources(asset, resources);
+			success = CreateSkyboxAssetResources(context, asset, resources);
 			break;
 		}
 		case CorePipeline::FULLSCREEN_QUAD:
 		{
-			if (fullscreenQuadAssetUUID != INVALID_UUID)
-			{
-				LogError("Attempting to load fullscreen quad mesh more than once!");
-				return nullptr;
-			}
-
-			CreateFullscreenQuadAssetResources(asset, resources);
+			success = CreateFullscreenQuadAssetResources(context, asset, resources);
 			break;
 		}
 		default:
@@ -297,47 +387,156 @@ namespace TANG
 		}
 		}
 
-		CreateAssetCommandBuffer(&resources);
+		// Nothing else was added since the entry was created, so it's still the last one
+		if (!success)
+		{
+			auto mapIter = resourcesMap.find(asset->uuid);
+			if (mapIter != resourcesMap.end() && mapIter->second == static_cast<uint32_t>(assetResources.size() - 1))
+			{
+				resourcesMap.erase(mapIter);
+			}
+
+			assetResources.pop_back();
+			return nullptr;
+		}
+
+		// PBR assets draw from the command buffers of their shared resources instead
+		if (corePipeline != CorePipeline::PBR)
+		{
+			resources.recordingGroup = AcquireRecordingGroup();
+			CreateAssetCommandBuffer(resources.uuid, resources.recordingGroup);
+		}
+
+		if (uploadBatch != nullptr)
+		{
+			uploadBatchAssets.push_back(asset->uuid);
+		}
+		else
+		{
+			SetAssetUploadValue(resources, assetContext.Submit());
+		}
 
 		return &resources;
 	}
 
-	void Renderer::CreatePBRAssetResources(AssetDisk* asset, AssetResources& out_resources)
+	void Renderer::BeginUploadBatch()
 	{
+		if (uploadBatch != nullptr)
+		{
+			LogWarning("Attempting to begin an upload batch, but one is already open!");
+			return;
+		}
+
+		uploadBatch = new UploadContext(QueueType::TRANSFER);
+	}
+
+	uint64_t Renderer::EndUploadBatch()
+	{
+		if (uploadBatch == nullptr)
+		{
+			LogWarning("Attempting to end an upload batch, but none is open!");
+			return 0;
+		}
+
+		uint64_t value = FlushUploadBatch();
+
+		delete uploadBatch;
+		uploadBatch = nullptr;
+
+		return value;
+	}
+
+	uint64_t Renderer::FlushUploadBatch()
+	{
+		uint64_t value = uploadBatch->Submit();
+
+		for (UUID uuid : uploadBatchAssets)
+		{
+			AssetResources* resources = GetAssetResourcesFromUUID(uuid);
+			if (resources != nullptr)
+			{
+				SetAssetUploadValue(*resources, value);
+			}
+		}
+
+		uploadBatchAssets.clear();
+		return value;
+	}
+
+	void Renderer::SetAssetUploadValue(AssetResources& resources, uint64_t value)
+	{
+		auto sharedIter = sharedAssetResources.find(resources.sharedUUID);
+		if (sharedIter == sharedAssetResources.end())
+		{
+			resources.uploadValue = value;
+			return;
+		}
+
+		// Timeline values only ever increase, so the largest one covers the uploads of every copy
+		SharedAssetResources& shared = sharedIter->second;
+		resources.uploadValue = std::max(value, shared.uploadValue);
+		shared.uploadValue = resources.uploadValue;
+	}
+
+	void Renderer::WaitForAssetUploads(UploadContext& context)
+	{
+		uint64_t value = (&context == uploadBatch) ? FlushUploadBatch() : context.Submit();
+		UploadContext::Wait(value);
+	}
+
+	bool Renderer::IsAssetUploadComplete(UUID uuid)
+	{
+		AssetResources* resources = GetAssetResourcesFromUUID(uuid);
+		if (resources == nullptr)
+		{
+			return false;
+		}
+
+		if (std::find(uploadBatchAssets.begin(), uploadBatchAssets.end(), uuid) != uploadBatchAssets.end())
+		{
+			return false;
+		}
+
+		return UploadContext::IsComplete(resources->uploadValue);
+	}
+
+	bool Renderer::CreatePBRAssetResources(UploadContext& context, AssetDisk* asset, AssetResources& out_resources)
+	{
+		// Loading the same source file always produces the same mesh and materials, so copies of an asset that's already loaded start out
+		// from the first copy's resources instead of creating (and uploading) their own
+		auto sharedUUIDIter = asset->name.empty() ? sharedAssetUUIDs.end() : sharedAssetUUIDs.find(asset->name);
+		if (sharedUUIDIter != sharedAssetUUIDs.end())
+		{
+			SharedAssetResources& shared = sharedAssetResources.at(sharedUUIDIter->second);
+			shared.refCount++;
+
+			out_resources = shared.resources;
+			out_resources.uuid = asset->uuid;
+			out_resources.uploadValue = shared.uploadValue;
+			return true;
+		}
+
 		uint64_t totalIndexCount = 0;
-		uint32_t vBufferOffset = 0;
 
 		//////////////////////////////
 		//
 		//	MESH
 		//
 		//////////////////////////////
-		Mesh<PBRVertex>* currMesh = reinterpret_cast<Mesh<PBRVertex>*>(asset->mesh);
-
-		// Create the vertex and index buffers
-		uint64_t numVertexBytes = currMesh->vertices.size() * sizeof(PBRVertex);
-		VertexBuffer& vb = out_resources.vertexBuffer;
-		vb.Create(numVertexBytes);
-
-		uint64_t numIndexBytes = currMesh->indices.size() * sizeof(IndexType);
-		IndexBuffer& ib = out_resources.indexBuffer;
-		ib.Create(numIndexBytes);
+		Mesh<PackedPBRVertex>* currMesh = reinterpret_cast<Mesh<PackedPBRVertex>*>(asset->mesh);
 
+		if (!CreateMeshGeometry(context, currMesh, currMesh->vertices.data(), currMesh->vertices.size(), sizeof(PackedPBRVertex), out_resources))
 		{
-			DisposableCommand command(QueueType::TRANSFER, true);
-			vb.CopyIntoBuffer(command.GetBuffer(), currMesh->vertices.data(), numVertexBytes);
-			ib.CopyIntoBuffer(command.GetBuffer(), currMesh->indices.data(), numIndexBytes);
+			LogError("Failed to create mesh geometry for asset '%s'!", asset->name.c_str());
+			return false;
 		}
 
-		// Destroy the staging buffers
-		vb.DestroyIntermediateBuffers();
-		ib.DestroyIntermediateBuffers();
-
 		// Accumulate the index count of this mesh;
 		totalIndexCount += currMesh->indices.size();
 
-		// Set the current offset and then increment
-		out_resources.offset = vBufferOffset++;
+		// The bounding sphere is calculated at import time. It's used for frustum culling, and to calculate how large the asset is on screen
+		out_resources.boundsCenter = currMesh->bounds.sphereCenter;
+		out_resources.boundsRadius = currMesh->bounds.sphereRadius;
 
 		//////////////////////////////
 		//
@@ -345,21 +544,53 @@ namespace TANG
 		//
 		//////////////////////////////
 		uint32_t numMaterials = static_cast<uint32_t>(asset->materials.size());
-		TNG_ASSERT_MSG(numMaterials <= 1, "Multiple materials per asset are not currently supported!");
-
 		if (numMaterials == 0)
 		{
 			// We need at least _one_ material, even if we didn't deserialize any material information
 			// In this case we use a default material (look at default_material.h)
 			asset->materials.resize(1);
 			asset->materials[0].SetName("Default Material");
+			numMaterials = 1;
+		}
+		else if (numMaterials > CONFIG::MaxMaterialsPerAsset)
+		{
+			LogWarning("Asset '%s' has %u materials, but only %u are supported! The remaining submeshes will use the first material", asset->name.c_str(), numMaterials, CONFIG::MaxMaterialsPerAsset);
+			numMaterials = CONFIG::MaxMaterialsPerAsset;
 		}
-		Material& material = asset->materials[0];
 
-		// Resize to the number of possible texture types
-		out_resources.material.resize(static_cast<uint32_t>(Material::TEXTURE_TYPE::_COUNT));
+		// The submesh ranges are relative to the mesh, so we offset them by where the mesh ended up in the arena blocks
+		out_resources.submeshes = currMesh->submeshes;
+		for (Submesh& submesh : out_resources.submeshes)
+		{
+			submesh.firstIndex += out_resources.firstIndex;
+			submesh.vertexOffset += out_resources.vertexOffset;
 
-		// Pre-emptively fill out the texture create info, so we can just pass it to all CreateFromFile() calls
+			if (submesh.materialIndex >= numMaterials)
+			{
+				submesh.materialIndex = 0;
+			}
+		}
+
+		// The LODs share the mesh's vertices and index allocation, so their ranges are offset the same way
+		out_resources.lods = currMesh->lods;
+		for (MeshLOD& lod : out_resources.lods)
+		{
+			for (Submesh& submesh : lod.submeshes)
+			{
+				submesh.firstIndex += out_resources.firstIndex;
+				submesh.vertexOffset += out_resources.vertexOffset;
+
+				if (submesh.materialIndex >= numMaterials)
+				{
+					submesh.materialIndex = 0;
+				}
+			}
+		}
+		out_resources.currentLOD = 0;
+
+		out_resources.materials.resize(numMaterials);
+
+		// Pre-emptively fill out the sampler create info, so we can just pass it to all AcquireResource() calls
 		SamplerCreateInfo samplerInfo{};
 		samplerInfo.minificationFilter = VK_FILTER_LINEAR;
 		samplerInfo.magnificationFilter = VK_FILTER_LINEAR;
@@ -374,65 +605,49 @@ namespace TANG
 		fallbackSamplerInfo.maxAnisotropy = 1.0;
 		fallbackSamplerInfo.enableAnisotropicFiltering = false;
 
-		ImageViewCreateInfo viewCreateInfo{};
-		viewCreateInfo.aspect = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
-		viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		viewCreateInfo.viewScope = ImageViewScope::ENTIRE_IMAGE;
-
-		BaseImageCreateInfo baseImageInfo{};
-		baseImageInfo.width = 0; // Unused
-		baseImageInfo.height = 0; // Unused
-		baseImageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-		baseImageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-		baseImageInfo.mipLevels = 1;
-		baseImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-		baseImageInfo.arrayLayers = 1;
-		baseImageInfo.flags = 0;
-
-		// Default material fallback
-		BaseImageCreateInfo fallbackBaseImageInfo{};
-		fallbackBaseImageInfo.width = 1;
-		fallbackBaseImageInfo.height = 1;
-		fallbackBaseImageInfo.mipLevels = 1;
-		fallbackBaseImageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-		fallbackBaseImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-		fallbackBaseImageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-		fallbackBaseImageInfo.arrayLayers = 1;
-		fallbackBaseImageInfo.flags = 0;
-
-		for (uint32_t i = 0; i < static_cast<uint32_t>(Material::TEXTURE_TYPE::_COUNT); i++)
-		{
-			Material::TEXTURE_TYPE texType = static_cast<Material::TEXTURE_TYPE>(i);
-
-			// The only supported texture (currently) that stores actual colors is the diffuse map,
-			// so we need to set it's format to sRGB instead of UNORM
-			if (texType == Material::TEXTURE_TYPE::DIFFUSE)
-			{
-				baseImageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-				fallbackBaseImageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-			}
-			else
-			{
-				baseImageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-				fallbackBaseImageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
-			}
+		TextureRegistry& textureRegistry = TextureRegistry::GetInstance();
 
-			if (material.HasTextureOfType(texType))
-			{
-				Texture* matTexture = material.GetTextureOfType(texType);
-				TNG_ASSERT_MSG(matTexture != nullptr, "Why is this texture nullptr when we specifically checked against it?");
+		for (uint32_t m = 0; m < numMaterials; m++)
+		{
+			const Material& material = asset->materials[m];
 
-				TextureResource& texResource = out_resources.material[i];
-				texResource.CreateFromFile(matTexture->fileName, &baseImageInfo, &viewCreateInfo, &samplerInfo);
-			}
-			else // use fallback
+			// Resize to the number of possible texture types
+			std::vector<TextureResource*>& textures = out_resources.materials[m].textures;
+			textures.resize(static_cast<uint32_t>(Material::TEXTURE_TYPE::_COUNT));
+
+			for (uint32_t i = 0; i < static_cast<uint32_t>(Material::TEXTURE_TYPE::_COUNT); i++)
 			{
-				uint32_t data = DEFAULT_MATERIAL.at(texType);
+				Material::TEXTURE_TYPE texType = static_cast<Material::TEXTURE_TYPE>(i);
+
+				// These are packed into the ORM texture by the asset loader, so they're never bound on their own
+				if (texType == Material::TEXTURE_TYPE::AMBIENT_OCCLUSION || texType == Material::TEXTURE_TYPE::ROUGHNESS || texType == Material::TEXTURE_TYPE::METALLIC)
+				{
+					textures[i] = nullptr;
+					continue;
+				}
+
+				// Texture resources are shared between all assets that use the same image contents. The data was already decoded
+				// (and possibly compressed) by the asset loader in the right format, so we upload it's mip chain directly instead of
+				// reading the file from disk again
+				if (material.HasTextureOfType(texType))
+				{
+					Texture* matTexture = material.GetTextureOfType(texType);
+					TNG_ASSERT_MSG(matTexture != nullptr, "Why is this texture nullptr when we specifically checked against it?");
+
+					textures[i] = textureRegistry.AcquireResource(context, matTexture, &samplerInfo);
+				}
+				else // use fallback
+				{
+					// The only supported texture (currently) that stores actual colors is the diffuse map,
+					// so we need to set it's format to sRGB instead of UNORM
+					VkFormat format = (texType == Material::TEXTURE_TYPE::DIFFUSE) ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
 
-				TextureResource& texResource = out_resources.material[i];
-				texResource.Create(&fallbackBaseImageInfo, &viewCreateInfo, &fallbackSamplerInfo);
-				texResource.CopyFromData(static_cast<void*>(&data), sizeof(data));
-				texResource.TransitionLayout_Immediate(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+					uint32_t data = DEFAULT_MATERIAL.at(texType);
+
+					// The fallback textures are 1x1, so we can simply use the texel color itself as the content hash
+					uint64_t fallbackHash = (static_cast<uint64_t>(i + 1) << 32) | data;
+					textures[i] = textureRegistry.AcquireResource(context, fallbackHash, format, &data, 1, 1, &fallbackSamplerInfo);
+				}
 			}
 		}
 
@@ -442,60 +657,61 @@ namespace TANG
 		out_resources.transform = Transform();
 		out_resources.indexCount = totalIndexCount;
 		out_resources.uuid = asset->uuid;
+		out_resources.sharedUUID = GetUUID();
+		out_resources.recordingGroup = AcquireRecordingGroup();
 
-		CreateAssetUniformBuffers(out_resources.uuid);
-		CreateAssetDescriptorSets(out_resources.uuid);
+		// Every copy of the asset shares the descriptor sets and command buffers created here, see SharedAssetResources
+		SharedAssetResources& shared = sharedAssetResources[out_resources.sharedUUID];
+		shared.resources = out_resources;
+		shared.sourceName = asset->name;
+		shared.refCount = 1;
+		if (!shared.sourceName.empty())
+		{
+			sharedAssetUUIDs.insert({ shared.sourceName, out_resources.sharedUUID });
+		}
 
-		// Initialize the view + projection matrix UBOs to some values, so when new assets are created they get sensible defaults
-		// for their descriptor sets. 
-		// Note that we're operating under the assumption that assets will only be created before
-		// we hit the update loop, simply because we're updating all frames in flight here. If this changes in the future, another
-		// solution must be implemented
+		for (uint32_t i = 0; i <= static_cast<uint32_t>(out_resources.lods.size()); i++)
+		{
+			shared.commandBufferUUIDs.push_back(GetUUID());
+			CreateAssetCommandBuffer(shared.commandBufferUUIDs.back(), out_resources.recordingGroup);
+		}
+
+		CreateAssetDescriptorSets(out_resources.sharedUUID, numMaterials);
+
+		// Point the new descriptor sets at the projection UBO and material textures, for every frame in flight. Assets are also created
+		// mid-frame by the asynchronous loader, but the sets were just allocated, so no command buffer (recorded or in flight) can be using
+		// them yet and writing the sets of the other frames is safe. This must still happen on the main thread, outside of command recording
 		for (uint32_t i = 0; i < GetFDDSize(); i++)
 		{
-			InitializeDescriptorSets(out_resources.uuid, i);
+			InitializeDescriptorSets(out_resources.sharedUUID, i);
 		}
+
+		return true;
 	}
 
-	void Renderer::CreateSkyboxAssetResources(AssetDisk* asset, AssetResources& out_resources)
+	bool Renderer::CreateSkyboxAssetResources(UploadContext& context, AssetDisk* asset, AssetResources& out_resources)
 	{
 		if (fullscreenQuadAssetUUID == INVALID_UUID)
 		{
 			LogError("Failed to load skybox. Fullscreen quad asset is not loaded when it's required to preprocess the skybox BRDF convolution map!");
-			return;
+			return false;
 		}
 
 		LogInfo("Starting cubemap preprocessing...");
 
 		uint64_t totalIndexCount = 0;
-		uint32_t vBufferOffset = 0;
 
 		Mesh<CubemapVertex>* currMesh = reinterpret_cast<Mesh<CubemapVertex>*>(asset->mesh);
 
-		// Create the vertex buffer
-		uint64_t numVertexBytes = currMesh->vertices.size() * sizeof(CubemapVertex);
-		VertexBuffer& vb = out_resources.vertexBuffer;
-		vb.Create(numVertexBytes);
-
-		uint64_t numIndexBytes = currMesh->indices.size() * sizeof(IndexType);
-		IndexBuffer& ib = out_resources.indexBuffer;
-		ib.Create(numIndexBytes);
+		if (!CreateMeshGeometry(context, currMesh, currMesh->vertices.data(), currMesh->vertices.size(), sizeof(CubemapVertex), out_resources))
 		{
-			DisposableCommand command(QueueType::TRANSFER, true);
-			vb.CopyIntoBuffer(command.GetBuffer(), currMesh->vertices.data(), numVertexBytes);
-			ib.CopyIntoBuffer(command.GetBuffer(), currMesh->indices.data(), numIndexBytes);
+			LogError("Failed to create mesh geometry for asset '%s'!", asset->name.c_str());
+			return false;
 		}
 
-		// Destroy the staging buffers
-		vb.DestroyIntermediateBuffers();
-		ib.DestroyIntermediateBuffers();
-
 		// Accumulate the index count of this mesh;
 		totalIndexCount += currMesh->indices.size();
 
-		// Set the current offset and then increment
-		out_resources.offset = vBufferOffset++;
-
 		out_resources.shouldDraw = false;
 		out_resources.transform = Transform();
 		out_resources.indexCount = totalIndexCount;
@@ -504,6 +720,10 @@ namespace TANG
 		cubemapPreprocessingPass.SetData(&descriptorPool, swapChainExtent);
 		cubemapPreprocessingPass.Create();
 
+		// The preprocessing draws the cube mesh right away, so it's upload must have completed (and been handed over to the graphics
+		// queue) before the preprocessing commands are submitted
+		WaitForAssetUploads(context);
+
 		// Convert the HDR texture into a cubemap and calculate IBL components (irradiance + prefilter map + BRDF LUT)
 		PrimaryCommandBuffer cmdBuffer;
 		cmdBuffer.Create(GetCommandPool(QueueType::GRAPHICS));
@@ -529,7 +749,11 @@ namespace TANG
 		if (SubmitQueue(QueueType::GRAPHICS, &submitInfo, 1, cubemapPreprocessingFence) != VK_SUCCESS)
 		{
 			LogError("Failed to execute commands for cubemap preprocessing!");
-			return;
+
+			// The upload has completed and nothing was submitted that reads the mesh, so it's geometry can be freed right away
+			GeometryArena::GetInstance().Free(out_resources.vertexAllocation);
+			GeometryArena::GetInstance().Free(out_resources.indexAllocation);
+			return false;
 		}
 
 		// Wait for the GPU to finish preprocessing the cubemap
@@ -549,40 +773,25 @@ namespace TANG
 		// Cache the skybox mesh UUID. We used it to convert the HDR equirectangular map to a cubemap, but we can
 		// reuse the cube mesh to draw the skybox in future frames as well
 		skyboxAssetUUID = asset->uuid;
+
+		return true;
 	}
 
-	void Renderer::CreateFullscreenQuadAssetResources(AssetDisk* asset, AssetResources& out_resources)
+	bool Renderer::CreateFullscreenQuadAssetResources(UploadContext& context, AssetDisk* asset, AssetResources& out_resources)
 	{
 		uint64_t totalIndexCount = 0;
-		uint32_t vBufferOffset = 0;
 
 		Mesh<UVVertex>* currMesh = reinterpret_cast<Mesh<UVVertex>*>(asset->mesh);
 
-		// Create the vertex buffer
-		uint64_t numVertexBytes = currMesh->vertices.size() * sizeof(UVVertex);
-		VertexBuffer& vb = out_resources.vertexBuffer;
-		vb.Create(numVertexBytes);
-
-		uint64_t numIndexBytes = currMesh->indices.size() * sizeof(IndexType);
-		IndexBuffer& ib = out_resources.indexBuffer;
-		ib.Create(numIndexBytes);
-
+		if (!CreateMeshGeometry(context, currMesh, currMesh->vertices.data(), currMesh->vertices.size(), sizeof(UVVertex), out_resources))
 		{
-			DisposableCommand command(QueueType::TRANSFER, true);
-			vb.CopyIntoBuffer(command.GetBuffer(), currMesh->vertices.data(), numVertexBytes);
-			ib.CopyIntoBuffer(command.GetBuffer(), currMesh->indices.data(), numIndexBytes);
+			LogError("Failed to create mesh geometry for asset '%s'!", asset->name.c_str());
+			return false;
 		}
 
-		// Destroy the staging buffers
-		vb.DestroyIntermediateBuffers();
-		ib.DestroyIntermediateBuffers();
-
 		// Accumulate the index count of this mesh;
 		totalIndexCount += currMesh->indices.size();
 
-		// Set the current offset and then increment
-		out_resources.offset = vBufferOffset++;
-
 		out_resources.shouldDraw = false;
 		out_resources.transform = Transform();
 		out_resources.indexCount = totalIndexCount;
@@ -591,13 +800,18 @@ namespace TANG
 		CreateLDRUniformBuffer();
 		CreateLDRDescriptorSet();
 
+		// The quad is drawn every frame by the LDR conversion (and by the skybox preprocessing), which can't skip it while it's uploading
+		WaitForAssetUploads(context);
+
 		// Cache the UUID
 		fullscreenQuadAssetUUID = asset->uuid;
+
+		return true;
 	}
 
-	void Renderer::CreateAssetCommandBuffer(AssetResources* resources)
+	void Renderer::CreateAssetCommandBuffer(UUID uuid, uint32_t recordingGroup)
 	{
-		UUID uuid = resources->uuid;
+		CommandPoolRegistry& registry = CommandPoolRegistry::Get();
 
 		for (uint32_t i = 0; i < GetFDDSize(); i++)
 		{
@@ -609,24 +823,158 @@ namespace TANG
 				return;
 			}
 
-			secondaryCmdBufferMap->emplace(uuid, SecondaryCommandBuffer());
-			SecondaryCommandBuffer& commandBuffer = secondaryCmdBufferMap->at(uuid);
-			commandBuffer.Create(GetCommandPool(QueueType::GRAPHICS));
+			AssetCommandBuffer& assetCmdBuffer = secondaryCmdBufferMap->emplace(uuid, AssetCommandBuffer()).first->second;
+			assetCmdBuffer.recordingGroup = recordingGroup;
+			assetCmdBuffer.commandBuffer.Create(registry.GetRecordingPool(recordingGroup, i));
+		}
+	}
+
+	uint32_t Renderer::AcquireRecordingGroup()
+	{
+		uint32_t recordingGroup = nextRecordingGroup;
+		nextRecordingGroup = (nextRecordingGroup + 1) % CommandPoolRegistry::Get().GetRecordingGroupCount();
+		return recordingGroup;
+	}
+
+	bool Renderer::CreateMeshGeometry(UploadContext& context, BaseMesh* mesh, const void* vertexData, uint64_t vertexCount, uint32_t vertexStride, AssetResources& out_resources)
+	{
+		GeometryArena& arena = GeometryArena::GetInstance();
+
+		std::vector<uint16_t> narrowIndices;
+		uint64_t numIndexBytes = 0;
+		void* indexData = GetIndexUploadData(mesh, narrowIndices, numIndexBytes);
+		uint32_t indexSize = (mesh->indexType == VK_INDEX_TYPE_UINT16) ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		uint64_t numVertexBytes = vertexCount * vertexStride;
+		if (!arena.Allocate(numVertexBytes, vertexStride, out_resources.vertexAllocation))
+		{
+			return false;
+		}
+
+		if (!arena.Allocate(numIndexBytes, indexSize, out_resources.indexAllocation))
+		{
+			arena.Free(out_resources.vertexAllocation);
+			return false;
 		}
+
+		// Meshes larger than the staging ring are uploaded in chunks, which must not split a vertex or an index
+		bool staged = context.StageChunked(vertexData, numVertexBytes, vertexStride, 4, [&](VkCommandBuffer commandBuffer, const StagingRegion& region, VkDeviceSize dataOffset)
+			{
+				arena.CopyIntoAllocation(commandBuffer, region, out_resources.vertexAllocation, dataOffset);
+			});
+
+		staged = staged && context.StageChunked(indexData, numIndexBytes, indexSize, 4, [&](VkCommandBuffer commandBuffer, const StagingRegion& region, VkDeviceSize dataOffset)
+			{
+				arena.CopyIntoAllocation(commandBuffer, region, out_resources.indexAllocation, dataOffset);
+			});
+
+		if (!staged)
+		{
+			arena.Free(out_resources.vertexAllocation);
+			arena.Free(out_resources.indexAllocation);
+			return false;
+		}
+
+		// Only the ranges we wrote are handed over to the graphics queue, the rest of the arena block may be in use by other meshes
+		if (context.IsOwnershipTransferRequired())
+		{
+			const GeometryAllocation& vertices = out_resources.vertexAllocation;
+			const GeometryAllocation& indices = out_resources.indexAllocation;
+			context.ReleaseBuffer(vertices.buffer, vertices.offset, vertices.size, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+			context.ReleaseBuffer(indices.buffer, indices.offset, indices.size, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
+		}
+
+		// The allocations are aligned to the vertex stride and index size, so these divisions are exact
+		out_resources.vertexOffset = static_cast<int32_t>(out_resources.vertexAllocation.offset / vertexStride);
+		out_resources.firstIndex = static_cast<uint32_t>(out_resources.indexAllocation.offset / indexSize);
+		out_resources.indexType = mesh->indexType;
+
+		return true;
 	}
 
 	void Renderer::DestroyAssetBuffersHelper(AssetResources* resources)
 	{
-		// Destroy the vertex buffer
-		resources->vertexBuffer.Destroy();
+		// The shared resources are only released along with the last copy
+		auto sharedIter = sharedAssetResources.find(resources->sharedUUID);
+		if (sharedIter != sharedAssetResources.end())
+		{
+			SharedAssetResources& shared = sharedIter->second;
+			shared.refCount--;
+
+			if (shared.refCount == 0)
+			{
+				for (uint32_t i = 0; i < GetFDDSize(); i++)
+				{
+					auto frameData = GetFDDAtIndex(i);
+					for (UUID commandBufferUUID : shared.commandBufferUUIDs)
+					{
+						frameData->assetCommandBuffers.erase(commandBufferUUID);
+					}
+				}
+
+				if (!shared.sourceName.empty())
+				{
+					sharedAssetUUIDs.erase(shared.sourceName);
+				}
+				sharedAssetResources.erase(sharedIter);
+			}
+			else
+			{
+				resources->vertexAllocation = GeometryAllocation();
+				resources->indexAllocation = GeometryAllocation();
+				resources->materials.clear();
+				resources->submeshes.clear();
+				resources->lods.clear();
+				return;
+			}
+		}
+
+		// Frames that were already submitted may still be reading the geometry and textures, so they're retired instead of released right away.
+		// Otherwise a later upload could overwrite the geometry ranges while a frame is still drawing from them
+		RetiredAssetResources retired;
+		retired.vertexAllocation = resources->vertexAllocation;
+		retired.indexAllocation = resources->indexAllocation;
+		retired.retiredFrame = frameCounter;
+
+		for (auto& material : resources->materials)
+		{
+			retired.textures.insert(retired.textures.end(), material.textures.begin(), material.textures.end());
+		}
 
-		// Destroy the index buffer
-		resources->indexBuffer.Destroy();
+		retiredAssetResources.push_back(std::move(retired));
 
-		// Destroy textures
-		for (auto& tex : resources->material)
+		resources->vertexAllocation = GeometryAllocation();
+		resources->indexAllocation = GeometryAllocation();
+		resources->materials.clear();
+		resources->submeshes.clear();
+		resources->lods.clear();
+	}
+
+	void Renderer::ReleaseRetiredAssetResources(bool force)
+	{
+		GeometryArena& arena = GeometryArena::GetInstance();
+		TextureRegistry& textureRegistry = TextureRegistry::GetInstance();
+
+		// Once every frame in flight has waited on it's fence since the asset was destroyed, nothing can be using it's resources anymore
+		for (auto iter = retiredAssetResources.begin(); iter != retiredAssetResources.end();)
 		{
-			tex.Destroy();
+			if (!force && frameCounter - iter->retiredFrame <= CONFIG::MaxFramesInFlight)
+			{
+				++iter;
+				continue;
+			}
+
+			// Return the vertex and index ranges to the geometry arena
+			arena.Free(iter->vertexAllocation);
+			arena.Free(iter->indexAllocation);
+
+			// Release our references to the textures, they're only destroyed once no other assets are using them
+			for (TextureResource* texture : iter->textures)
+			{
+				textureRegistry.ReleaseResource(texture);
+			}
+
+			iter = retiredAssetResources.erase(iter);
 		}
 	}
 
@@ -644,15 +992,31 @@ namespace TANG
 			return;
 		}
 
-		// Destroy the resources
+		// The asset might have been created in the current upload batch, in which case it's upload hasn't even been submitted yet
+		if (uploadBatch != nullptr)
+		{
+			FlushUploadBatch();
+		}
+
+		// The upload commands reference the geometry and textures, so they must be done before we destroy them
+		UploadContext::Wait(asset->uploadValue);
+
+		// Retire the resources, the frames in flight may still be drawing the asset
 		DestroyAssetBuffersHelper(asset);
 
 		// Remove resources from the vector
-		uint32_t resourceIndex = static_cast<uint32_t>((asset - &assetResources[0]) / sizeof(assetResources));
+		uint32_t resourceIndex = static_cast<uint32_t>(asset - &assetResources[0]);
 		assetResources.erase(assetResources.begin() + resourceIndex);
 
-		// Destroy reference to resources
+		// Destroy reference to resources, and shift the indices of the resources that came after it
 		resourcesMap.erase(uuid);
+		for (auto& iter : resourcesMap)
+		{
+			if (iter.second > resourceIndex)
+			{
+				iter.second--;
+			}
+		}
 		
 		// Remove the secondary command buffer
 		for (uint32_t i = 0; i < GetFDDSize(); i++)
@@ -675,8 +1039,14 @@ namespace TANG
 			DestroyAssetBuffersHelper(&assetResources[i]);
 		}
 
+		// Only called once the device is idle, so there's no need to wait for the frames in flight
+		ReleaseRetiredAssetResources(true);
+
 		assetResources.clear();
 		resourcesMap.clear();
+
+		// All the references should be gone by now, but make sure nothing outlives the logical device
+		TextureRegistry::GetInstance().DestroyAllResources();
 	}
 
 	void Renderer::CreateSurface(GLFWwindow* windowHandle)
@@ -696,37 +1066,28 @@ namespace TANG
 	void Renderer::UpdateCameraData(const glm::vec3& position, const glm::mat4& viewMatrix)
 	{
 		auto frameData = GetCurrentFDD();
-		auto& assetDescriptorMap = frameData->assetDescriptorDataMap;
 
+		cameraPosition = position;
+		cameraViewMatrix = viewMatrix;
+
+		// Every asset reads the camera data through the frame's shared descriptor set, so only the buffers need to be updated
 		UpdateCameraDataUniformBuffers(currentFrame, position, viewMatrix);
 		UpdateProjectionUniformBuffer(currentFrame);
 
-		// Update the view matrix and camera position UBOs for all assets, as well as the descriptor sets unless they're not being drawn this frame
-		for (auto& assetData : assetDescriptorMap)
-		{
-			UUID assetUUID = assetData.first;
-			AssetResources* resources = GetAssetResourcesFromUUID(assetUUID);
-			if (resources == nullptr)
-			{
-				continue;
-			}
-
-			// Don't update asset resources that are not being drawn this frame
-			if (!resources->shouldDraw)
-			{
-				continue;
-			}
-
-			// Wait for the frame to finish using the camera buffer before updating it
-			vkWaitForFences(GetLogicalDevice(), 1, &frameData->inFlightFence, VK_TRUE, UINT64_MAX);
-
-			UpdateCameraDataDescriptorSet(assetUUID, currentFrame);
-		}
-
 		// Update the camera descriptor for the skybox as well
 		skyboxPass.UpdateCameraMatricesShaderParameters(currentFrame, &frameData->viewUBO, &frameData->projUBO);
 	}
 
+	uint32_t Renderer::GetRecordedAssetCommandBufferCount() const
+	{
+		return recordedAssetCommandBufferCount;
+	}
+
+	CullingStatistics Renderer::GetCullingStatistics() const
+	{
+		return frustumCuller.GetStatistics();
+	}
+
 	void Renderer::RecreateSwapChain()
 	{
 		VkDevice logicalDevice = GetLogicalDevice();
@@ -739,6 +1100,9 @@ namespace TANG
 		CreateColorAttachmentTextures();
 		CreateDepthTextures();
 		CreateFramebuffers();
+
+		// The cached asset command buffers reference the old framebuffers and extent
+		InvalidateAllAssetCommandBuffers();
 	}
 
 	void Renderer::SetAssetDrawState(UUID uuid)
@@ -806,9 +1170,26 @@ namespace TANG
 		VkDevice logicalDevice = GetLogicalDevice();
 		VkResult result = VK_SUCCESS;
 
-		FrameDependentData* frameData = GetCurrentFDD();
+		FrameDependentData* frameData = GetCurrentFDD();
+
+		vkWaitForFences(logicalDevice, 1, &frameData->inFlightFence, VK_TRUE, UINT64_MAX);
+
+		// The frame that last used this frame's resources is done, so the assets destroyed before it can be released
+		frameCounter++;
+		ReleaseRetiredAssetResources(false);
+
+		// The GPU is done reading this frame's transforms, so the instance buffer can be filled from the start again
+		frameData->instanceCount = 0;
+		if (gpuCullingEnabled)
+		{
+			gpuCullingPass.ResetFrame(currentFrame);
+		}
+
+		// Hand the uploads that completed since the last frame over to the graphics queue, so the assets can be drawn this frame
+		StagingRing::GetInstance().Update();
 
-		vkWaitForFences(logicalDevice, 1, &frameData->inFlightFence, VK_TRUE, UINT64_MAX);
+		// The GPU is done with this frame's descriptor sets, so it's safe to swap the streamed textures they reference
+		UpdateStreamedTextures();
 
 		uint32_t imageIndex;
 		result = vkAcquireNextImageKHR(logicalDevice, swapChain, UINT64_MAX,
@@ -836,6 +1217,10 @@ namespace TANG
 		PrimaryCommandBuffer* hdrCmdBuffer = &(frameData->hdrCommandBuffer);
 		hdrCmdBuffer->Reset();
 		hdrCmdBuffer->BeginRecording(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr);
+
+		// The GPU culling dispatch can't be recorded inside of a render pass, so the asset draws are prepared before it begins
+		PrepareAssetDraws(hdrCmdBuffer);
+
 		hdrCmdBuffer->CMD_BeginRenderPass(&hdrRenderPass, &(frameData->hdrFramebuffer), swapChainExtent, true, true);
 
 		// Record skybox commands
@@ -1244,7 +1629,16 @@ namespace TANG
 
 		VkPhysicalDeviceFeatures deviceFeatures{};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
+		deviceFeatures.textureCompressionBC = DeviceCache::Get().GetPhysicalDeviceFeatures().textureCompressionBC;
 		deviceFeatures.geometryShader = VK_TRUE;
+		deviceFeatures.drawIndirectFirstInstance = DeviceCache::Get().GetPhysicalDeviceFeatures().drawIndirectFirstInstance;
+
+		// Every instance group's indirect draws start at the group's range of the instance buffer
+		gpuCullingEnabled = CONFIG::EnableGPUCulling && (deviceFeatures.drawIndirectFirstInstance == VK_TRUE);
+		if (CONFIG::EnableGPUCulling && !gpuCullingEnabled)
+		{
+			LogWarning("GPU culling was requested, but the device doesn't support drawIndirectFirstInstance! Falling back to CPU frustum culling and direct draws");
+		}
 
 		VkDeviceCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -1273,6 +1667,19 @@ namespace TANG
 		}
 
 		DeviceCache::Get().CacheLogicalDevice(device);
+		for (uint32_t i = 0; i < static_cast<uint32_t>(QueueType::COUNT); i++)
+		{
+			DeviceCache::Get().CacheQueueFamilyIndex(static_cast<QueueType>(i), indices.GetIndex(static_cast<QueueType>(i)));
+		}
+
+		if (DeviceCache::Get().HasDedicatedTransferQueue())
+		{
+			LogInfo("Uploads will be recorded on a dedicated transfer queue");
+		}
+		else
+		{
+			LogInfo("No dedicated transfer queue available, uploads will be recorded on the graphics queue");
+		}
 
 		// Get the queues from the logical device
 		vkGetDeviceQueue(device, indices.GetIndex(QueueType::GRAPHICS)	, 0, &queues[QueueType::GRAPHICS]);
@@ -1362,7 +1769,14 @@ namespace TANG
 
 	void Renderer::CreateCommandPools()
 	{
-		CommandPoolRegistry::Get().CreatePools(surface);
+		CommandPoolRegistry& registry = CommandPoolRegistry::Get();
+		registry.CreatePools(surface);
+
+		// The main thread records one of the groups while it waits for the workers
+		recordingThreadPool.Create(CONFIG::RecordingThreadCount);
+		registry.CreateRecordingPools(recordingThreadPool.GetThreadCount() + 1, CONFIG::MaxFramesInFlight);
+
+		LogInfo("Created %u secondary command buffer recording threads", recordingThreadPool.GetThreadCount());
 	}
 
 	void Renderer::CreatePipelines()
@@ -1518,22 +1932,6 @@ namespace TANG
 		}
 	}
 
-	void Renderer::CreateAssetUniformBuffers(UUID uuid)
-	{
-		VkDeviceSize transformUBOSize = sizeof(TransformUBO);
-
-		for (uint32_t i = 0; i < GetFDDSize(); i++)
-		{
-			FrameDependentData* currentFDD = GetFDDAtIndex(i);
-			AssetDescriptorData& assetDescriptorData = currentFDD->assetDescriptorDataMap[uuid];
-
-			// Create the TransformUBO
-			UniformBuffer& transUBO = assetDescriptorData.transformUBO;
-			transUBO.Create(transformUBOSize);
-			transUBO.MapMemory();
-		}
-	}
-
 	void Renderer::CreateFrameUniformBuffers()
 	{
 		VkDeviceSize viewUBOSize = sizeof(ViewUBO);
@@ -1558,6 +1956,9 @@ namespace TANG
 			UniformBuffer& cameraDataUBO = frameData->cameraDataUBO;
 			cameraDataUBO.Create(cameraDataSize);
 			cameraDataUBO.MapMemory();
+
+			// Create the instance buffer. The transforms are read as a std430 array of mat4, so they're tightly packed
+			frameData->instanceBuffer.Create(sizeof(TransformUBO) * CONFIG::MaxDrawnAssetsPerFrame);
 		}
 	}
 
@@ -1574,7 +1975,7 @@ namespace TANG
 		}
 	}
 
-	void Renderer::CreateAssetDescriptorSets(UUID uuid)
+	void Renderer::CreateAssetDescriptorSets(UUID uuid, uint32_t materialCount)
 	{
 		uint32_t fddSize = GetFDDSize();
 
@@ -1595,11 +1996,54 @@ namespace TANG
 					LogError("Failed to create asset descriptor set #%u for asset with UUID '%u'", j, uuid);
 					continue;
 				}
+
+				// The texture set is created once per material instead
+				if (j == 0)
+				{
+					for (uint32_t k = 0; k < materialCount; k++)
+					{
+						assetDescriptorData.materialDescriptorSets.push_back(DescriptorSet());
+						assetDescriptorData.materialDescriptorSets.back().Create(descriptorPool, setLayoutOpt.value());
+					}
+					continue;
+				}
+
+				// The volatile set is shared by every asset, see CreateFrameDescriptorSets()
+				if (j == 2)
+				{
+					continue;
+				}
+
 				currentSet->Create(descriptorPool, setLayoutOpt.value());
 			}
 		}
 	}
 
+	void Renderer::CreateFrameDescriptorSets()
+	{
+		std::optional<DescriptorSetLayout> setLayoutOpt = pbrSetLayoutCache.GetSetLayout(2);
+		if (!setLayoutOpt.has_value())
+		{
+			LogError("Failed to create frame descriptor sets, the volatile set layout is missing!");
+			return;
+		}
+
+		// The set always points to the same buffers, every instance reads it's transform with gl_InstanceIndex
+		for (uint32_t i = 0; i < GetFDDSize(); i++)
+		{
+			auto frameData = GetFDDAtIndex(i);
+
+			DescriptorSet& descSet = frameData->volatileDescriptorSet;
+			descSet.Create(descriptorPool, setLayoutOpt.value());
+
+			WriteDescriptorSets writeDescSets(3, 0);
+			writeDescSets.AddStorageBuffer(descSet.GetDescriptorSet(), 0, &frameData->instanceBuffer);
+			writeDescSets.AddUniformBuffer(descSet.GetDescriptorSet(), 1, &frameData->cameraDataUBO);
+			writeDescSets.AddUniformBuffer(descSet.GetDescriptorSet(), 2, &frameData->viewUBO);
+			descSet.Update(writeDescSets);
+		}
+	}
+
 	void Renderer::CreateLDRDescriptorSet()
 	{
 		if (ldrSetLayoutCache.GetLayoutCount() != 1)
@@ -1628,12 +2072,11 @@ namespace TANG
 		SetLayoutSummary persistentLayout(0);
 		persistentLayout.AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Diffuse texture
 		persistentLayout.AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Normal texture
-		persistentLayout.AddBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Metallic texture
-		persistentLayout.AddBinding(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Roughness texture
-		persistentLayout.AddBinding(4, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Lightmap texture
-		persistentLayout.AddBinding(5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Irradiance map (diffuse IBL)
-		persistentLayout.AddBinding(6, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Prefilter map (specular IBL)
-		persistentLayout.AddBinding(7, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // BRDF convolution map (specular IBL)
+		persistentLayout.AddBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // ORM texture (occlusion, roughness, metallic)
+		persistentLayout.AddBinding(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Lightmap texture
+		persistentLayout.AddBinding(4, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Irradiance map (diffuse IBL)
+		persistentLayout.AddBinding(5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // Prefilter map (specular IBL)
+		persistentLayout.AddBinding(6, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT); // BRDF convolution map (specular IBL)
 		pbrSetLayoutCache.CreateSetLayout(persistentLayout, 0);
 
 		// Holds ProjUBO
@@ -1642,9 +2085,9 @@ namespace TANG
 		unstableLayout.AddBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT);         // Camera exposure
 		pbrSetLayoutCache.CreateSetLayout(unstableLayout, 0);
 
-		// Holds TransformUBO + ViewUBO + CameraDataUBO
+		// Holds the instance transforms + ViewUBO + CameraDataUBO
 		SetLayoutSummary volatileLayout(2);
-		volatileLayout.AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);   // Transform matrix
+		volatileLayout.AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);   // Transform matrices
 		volatileLayout.AddBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT); // Camera data
 		volatileLayout.AddBinding(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT);   // View matrix
 		pbrSetLayoutCache.CreateSetLayout(volatileLayout, 0);
@@ -1660,24 +2103,24 @@ namespace TANG
 
 	void Renderer::CreateDescriptorPool()
 	{
-		// We will create a descriptor pool that can allocate a large number of descriptor sets using the following logic:
-		// Since we have to allocate a descriptor set for every unique asset (not sure if this is the correct way, to be honest)
-		// and for every frame in flight, we'll set a maximum number of assets (100) and multiply that by the max number of frames
-		// in flight
-		// TODO - Once I learn how to properly set a different transform for every asset, this will probably have to change...I just
-		//        don't know what I'm doing.
-		const uint32_t fddSize = GetFDDSize();
+		// Every asset needs it's uniform buffer sets plus one texture set per material, for every frame in flight. The passes allocate their
+		// sets from this pool as well, so every type gets enough descriptors for every set to hold as many as the largest set of any layout does
+		const uint32_t maxSetsPerAsset = 2 + CONFIG::MaxMaterialsPerAsset;
+		const uint32_t maxSets = maxSetsPerAsset * GetFDDSize() * CONFIG::MaxAssetCount;
 
-		const uint32_t numUniformBuffers = 8;
-		const uint32_t numImageSamplers = 7;
+		const uint32_t maxUniformBuffersPerSet = 2;		// View and projection matrices
+		const uint32_t maxImageSamplersPerSet = 7;		// PBR material textures and IBL maps
+		const uint32_t maxStorageBuffersPerSet = 4;		// GPU culling buffers
 
-		std::array<VkDescriptorPoolSize, 2> poolSizes{};
+		std::array<VkDescriptorPoolSize, 3> poolSizes{};
 		poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		poolSizes[0].descriptorCount = numUniformBuffers * GetFDDSize();
+		poolSizes[0].descriptorCount = maxUniformBuffersPerSet * maxSets;
 		poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		poolSizes[1].descriptorCount = numImageSamplers * GetFDDSize();
+		poolSizes[1].descriptorCount = maxImageSamplersPerSet * maxSets;
+		poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		poolSizes[2].descriptorCount = maxStorageBuffersPerSet * maxSets;
 
-		descriptorPool.Create(poolSizes.data(), static_cast<uint32_t>(poolSizes.size()), static_cast<uint32_t>(poolSizes.size()) * fddSize * CONFIG::MaxAssetCount, 0);
+		descriptorPool.Create(poolSizes.data(), static_cast<uint32_t>(poolSizes.size()), maxSets, 0);
 	}
 
 	void Renderer::CreateDepthTextures()
@@ -1766,50 +2209,200 @@ namespace TANG
 		}
 	}
 
-	void Renderer::DrawAssets(PrimaryCommandBuffer* cmdBuffer)
+	void Renderer::PrepareAssetDraws(PrimaryCommandBuffer* cmdBuffer)
 	{
-		std::vector<VkCommandBuffer> secondaryCmdBuffers;
-		secondaryCmdBuffers.resize(assetResources.size()); // At most we can have the same number of cmd buffers as there are asset resources
-		uint32_t secondaryCmdBufferCount = 0;
+		auto frameData = GetCurrentFDD();
+
+		Frustum frustum = Frustum::FromViewProjection(startingProjectionMatrix * cameraViewMatrix);
+
+		// Assets are drawn starting from the first frame after their upload completes, instead of waiting for it
+		std::vector<AssetResources*> candidates;
+		frustumCuller.BeginFrame();
 		for (auto& iter : assetResources)
 		{
-			UUID& uuid = iter.uuid;
+			if (!iter.shouldDraw || !UploadContext::IsComplete(iter.uploadValue))
+			{
+				continue;
+			}
 
-			if (iter.shouldDraw)
+			if (frameData->assetDescriptorDataMap.find(iter.sharedUUID) == frameData->assetDescriptorDataMap.end())
 			{
-				SecondaryCommandBuffer* secondaryCmdBuffer = GetSecondaryCommandBufferFromUUID(uuid);
-				if (secondaryCmdBuffer == nullptr)
-				{
-					continue;
-				}
+				LogWarning("Asset with UUID '%ull' doesn't have any descriptor sets, skipping it!", iter.uuid);
+				continue;
+			}
+
+			if (CONFIG::EnableFrustumCulling)
+			{
+				glm::vec3 worldCenter;
+				float worldRadius;
+				CalculateWorldBoundingSphere(iter, worldCenter, worldRadius);
+				frustumCuller.AddObject(iter.uuid, worldCenter, worldRadius);
+			}
+
+			candidates.push_back(&iter);
+		}
+
+		// Culled assets are skipped before they pick a LOD or request texture residency, so they stop competing for the texture budget
+		std::vector<uint8_t> visible(candidates.size(), 1);
+		if (CONFIG::EnableFrustumCulling)
+		{
+			frustumCuller.Cull(frustum, visible);
+		}
+
+		// Everything that writes to shared state (the instance buffer, the LODs and the texture streamer) is done here on the main thread,
+		// so only the recording itself is split across the recording threads.
+		// The visible assets are grouped by their shared resources and LOD first. The groups are kept in the order their first asset was found,
+		// so in a static scene every group gets the same instance range every frame, and the cached command buffers stay valid
+		std::vector<std::vector<AssetResources*>> instanceGroups;
+		std::map<std::pair<uint64_t, uint32_t>, uint32_t> instanceGroupMap;
+		for (size_t i = 0; i < candidates.size(); i++)
+		{
+			if (!visible[i])
+			{
+				continue;
+			}
+
+			AssetResources& iter = *candidates[i];
+
+			float screenSize = CalculateScreenSize(iter);
+			SelectLOD(iter, screenSize);
+			RequestTextureResidency(iter, screenSize);
+
+			auto groupIter = instanceGroupMap.emplace(std::make_pair(iter.sharedUUID, iter.currentLOD), static_cast<uint32_t>(instanceGroups.size()));
+			if (groupIter.second)
+			{
+				instanceGroups.emplace_back();
+			}
+
+			instanceGroups[groupIter.first->second].push_back(&iter);
+		}
+
+		preparedAssetCommandBuffers.clear();
+		preparedAssetCommandBuffers.reserve(instanceGroups.size());
+
+		// Every group is drawn from the shared command buffer of it's LOD, and recorded from it's first asset. Any asset in the group would do,
+		// since they only differ in their transforms. Command buffers that are still valid are executed as-is
+		std::vector<AssetDrawRecord> draws;
+		for (const std::vector<AssetResources*>& group : instanceGroups)
+		{
+			AssetResources* resources = group.front();
+
+			const SharedAssetResources& shared = sharedAssetResources.at(resources->sharedUUID);
+			AssetCommandBuffer* assetCmdBuffer = GetAssetCommandBufferFromUUID(shared.commandBufferUUIDs[resources->currentLOD]);
+			if (assetCmdBuffer == nullptr)
+			{
+				continue;
+			}
 
-				UpdateTransformUniformBuffer(iter.transform, uuid);
-				UpdateTransformDescriptorSet(uuid);
+			uint32_t firstInstance = 0;
+			uint32_t instanceCount = static_cast<uint32_t>(group.size());
+			uint32_t firstDraw = 0;
+			if (!WriteInstanceGroup(group, firstInstance, firstDraw))
+			{
+				LogWarning("Exceeded the maximum number of drawn assets or indirect draws per frame, skipping the rest!");
+				break;
+			}
 
-				RecordSecondaryCommandBuffer(secondaryCmdBuffer, &iter);
+			// The instance range (and the indirect draws, with GPU culling) are baked into the recorded draws, so they only stay the same
+			// while the same assets are drawn
+			if (!assetCmdBuffer->isRecorded || assetCmdBuffer->recordedLOD != resources->currentLOD ||
+				assetCmdBuffer->recordedFirstInstance != firstInstance || assetCmdBuffer->recordedInstanceCount != instanceCount ||
+				assetCmdBuffer->recordedFirstDraw != firstDraw)
+			{
+				draws.push_back({ resources, &assetCmdBuffer->commandBuffer, firstInstance, instanceCount, firstDraw });
 
-				secondaryCmdBuffers[secondaryCmdBufferCount++] = secondaryCmdBuffer->GetBuffer();
+				assetCmdBuffer->isRecorded = true;
+				assetCmdBuffer->recordedLOD = resources->currentLOD;
+				assetCmdBuffer->recordedFirstInstance = firstInstance;
+				assetCmdBuffer->recordedInstanceCount = instanceCount;
+				assetCmdBuffer->recordedFirstDraw = firstDraw;
 			}
+
+			preparedAssetCommandBuffers.push_back(assetCmdBuffer->commandBuffer.GetBuffer());
+		}
+
+		RecordSecondaryCommandBuffers(draws);
+		recordedAssetCommandBufferCount = static_cast<uint32_t>(draws.size());
+
+		if (gpuCullingEnabled)
+		{
+			gpuCullingPass.Draw(currentFrame, cmdBuffer, frustum);
 		}
+	}
 
+	void Renderer::DrawAssets(PrimaryCommandBuffer* cmdBuffer)
+	{
 		// Don't attempt to execute 0 command buffers
-		if (secondaryCmdBufferCount > 0)
+		if (!preparedAssetCommandBuffers.empty())
+		{
+			cmdBuffer->CMD_ExecuteSecondaryCommands(preparedAssetCommandBuffers.data(), static_cast<uint32_t>(preparedAssetCommandBuffers.size()));
+		}
+	}
+
+	void Renderer::RecordSecondaryCommandBuffers(const std::vector<AssetDrawRecord>& draws)
+	{
+		// With only a few assets, waking up the workers costs more than recording them on the main thread does
+		if (draws.size() < CONFIG::ParallelRecordingMinAssets || recordingThreadPool.GetThreadCount() == 0)
+		{
+			for (const AssetDrawRecord& draw : draws)
+			{
+				RecordSecondaryCommandBuffer(draw);
+			}
+			return;
+		}
+
+		// Every asset's command buffers are allocated from it's recording group's pools, and a pool must only be used by one thread at a
+		// time. So instead of splitting the draws into even chunks, every group is recorded by a single job. Assets are spread across the
+		// groups round-robin, so the jobs end up roughly the same size
+		std::vector<std::vector<const AssetDrawRecord*>> groups(CommandPoolRegistry::Get().GetRecordingGroupCount());
+		for (const AssetDrawRecord& draw : draws)
 		{
-			cmdBuffer->CMD_ExecuteSecondaryCommands(secondaryCmdBuffers.data(), secondaryCmdBufferCount);
+			groups[draw.resources->recordingGroup].push_back(&draw);
+		}
+
+		ThreadPool::JobGroup jobGroup = recordingThreadPool.CreateJobGroup();
+
+		std::vector<std::future<void>> futures;
+		futures.reserve(groups.size());
+		for (const auto& group : groups)
+		{
+			if (group.empty())
+			{
+				continue;
+			}
+
+			futures.push_back(recordingThreadPool.Submit([this, &group]()
+			{
+				for (const AssetDrawRecord* draw : group)
+				{
+					RecordSecondaryCommandBuffer(*draw);
+				}
+			}, jobGroup));
+		}
+
+		// The main thread picks up whichever jobs the workers haven't started yet
+		for (auto& future : futures)
+		{
+			recordingThreadPool.Wait(future, jobGroup);
 		}
 	}
 
-	void Renderer::RecordSecondaryCommandBuffer(SecondaryCommandBuffer* cmdBuffer, AssetResources* resources)
+	void Renderer::RecordSecondaryCommandBuffer(const AssetDrawRecord& draw)
 	{
 		auto frameData = GetCurrentFDD();
+		SecondaryCommandBuffer* cmdBuffer = draw.commandBuffer;
+		const AssetResources* resources = draw.resources;
 
-		// Retrieve the vector of descriptor sets for the given asset
-		auto& descSets = frameData->assetDescriptorDataMap[resources->uuid].descriptorSets;
+		// Retrieve the vector of descriptor sets for the given asset. Set 0 is swapped out for every submesh's material below. This may run on
+		// a recording thread, so the map must not be modified here. PrepareAssetDraws() makes sure the entry exists
+		AssetDescriptorData& assetDescriptorData = frameData->assetDescriptorDataMap.at(resources->sharedUUID);
+		auto& descSets = assetDescriptorData.descriptorSets;
 		std::vector<VkDescriptorSet> vkDescSets(descSets.size());
 		for (uint32_t i = 0; i < descSets.size(); i++)
 		{
 			vkDescSets[i] = descSets[i].GetDescriptorSet();
 		}
+		vkDescSets[2] = frameData->volatileDescriptorSet.GetDescriptorSet();
 
 		VkCommandBufferInheritanceInfo inheritanceInfo{};
 		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
@@ -1821,15 +2414,142 @@ namespace TANG
 		cmdBuffer->BeginRecording(VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT, &inheritanceInfo);
 
 		cmdBuffer->CMD_BindMesh(resources);
-		cmdBuffer->CMD_BindDescriptorSets(&pbrPipeline, static_cast<uint32_t>(vkDescSets.size()), vkDescSets.data());
 		cmdBuffer->CMD_BindPipeline(&pbrPipeline);
 		cmdBuffer->CMD_SetScissor({ 0, 0 }, swapChainExtent);
 		cmdBuffer->CMD_SetViewport(static_cast<float>(swapChainExtent.width), static_cast<float>(swapChainExtent.height));
-		cmdBuffer->CMD_DrawIndexed(resources->indexCount);
+
+		// All the submeshes share the vertex and index buffers, so only the material's descriptor set changes between draws. With GPU culling,
+		// every submesh has an indirect draw whose instance count is written by the culling dispatch
+		const std::vector<Submesh>& submeshes = GetCurrentSubmeshes(*resources);
+		for (uint32_t i = 0; i < static_cast<uint32_t>(submeshes.size()); i++)
+		{
+			const Submesh& submesh = submeshes[i];
+
+			vkDescSets[0] = assetDescriptorData.materialDescriptorSets[submesh.materialIndex].GetDescriptorSet();
+			cmdBuffer->CMD_BindDescriptorSets(&pbrPipeline, static_cast<uint32_t>(vkDescSets.size()), vkDescSets.data());
+
+			if (gpuCullingEnabled)
+			{
+				VkDeviceSize drawOffset = static_cast<VkDeviceSize>(draw.firstDraw + i) * sizeof(VkDrawIndexedIndirectCommand);
+				cmdBuffer->CMD_DrawIndexedIndirect(gpuCullingPass.GetDrawBuffer(currentFrame)->GetBuffer(), drawOffset);
+			}
+			else
+			{
+				cmdBuffer->CMD_DrawIndexedInstanced(submesh.indexCount, draw.instanceCount, submesh.firstIndex, submesh.vertexOffset, draw.firstInstance);
+			}
+		}
 
 		cmdBuffer->EndRecording();
 	}
 
+	void Renderer::UpdateStreamedTextures()
+	{
+		TextureStreamer& textureStreamer = TextureStreamer::GetInstance();
+		textureStreamer.Update();
+
+		// The textures are swapped in-place, but the descriptor sets still point to the previous image views. Only this frame's descriptor
+		// sets are rewritten, the other frames in flight rewrite theirs once they come around (the old images outlive them)
+		FrameDependentData* frameData = GetCurrentFDD();
+		uint64_t residencyVersion = textureStreamer.GetResidencyVersion();
+		if (frameData->textureResidencyVersion == residencyVersion)
+		{
+			return;
+		}
+
+		// Rewriting the descriptor sets re-records the asset's command buffers, so only the assets whose textures were replaced since this
+		// frame last caught up are touched
+		for (const auto& iter : sharedAssetResources)
+		{
+			bool isOutdated = false;
+			for (const MaterialResources& material : iter.second.resources.materials)
+			{
+				for (const TextureResource* texture : material.textures)
+				{
+					if (textureStreamer.GetResidencyVersion(texture) > frameData->textureResidencyVersion)
+					{
+						isOutdated = true;
+						break;
+					}
+				}
+
+				if (isOutdated) break;
+			}
+
+			if (isOutdated)
+			{
+				UpdatePBRTextureDescriptorSet(iter.first, currentFrame);
+			}
+		}
+
+		frameData->textureResidencyVersion = residencyVersion;
+	}
+
+	void Renderer::RequestTextureResidency(const AssetResources& resources, float screenSize)
+	{
+		if (!CONFIG::EnableTextureStreaming)
+		{
+			return;
+		}
+
+		TextureStreamer& textureStreamer = TextureStreamer::GetInstance();
+		for (const MaterialResources& material : resources.materials)
+		{
+			for (TextureResource* texture : material.textures)
+			{
+				if (texture != nullptr)
+				{
+					textureStreamer.RequestScreenSize(texture, screenSize);
+				}
+			}
+		}
+	}
+
+	void Renderer::SelectLOD(AssetResources& resources, float screenSize)
+	{
+		uint32_t maxLOD = std::min(static_cast<uint32_t>(resources.lods.size()), static_cast<uint32_t>(CONFIG::MeshLODScreenSizes.size()));
+		if (maxLOD == 0)
+		{
+			resources.currentLOD = 0;
+			return;
+		}
+
+		// Threshold N separates LOD N from LOD N+1. The screen size has to cross it by the hysteresis margin before we switch, otherwise
+		// an asset sitting right at the threshold would keep swapping LODs every frame
+		float screenFraction = screenSize / static_cast<float>(swapChainExtent.height);
+		uint32_t lod = std::min(resources.currentLOD, maxLOD);
+		while (lod < maxLOD && screenFraction < CONFIG::MeshLODScreenSizes[lod] * (1.0f - CONFIG::MeshLODHysteresis))
+		{
+			lod++;
+		}
+
+		while (lod > 0 && screenFraction > CONFIG::MeshLODScreenSizes[lod - 1] * (1.0f + CONFIG::MeshLODHysteresis))
+		{
+			lod--;
+		}
+
+		resources.currentLOD = lod;
+	}
+
+	float Renderer::CalculateScreenSize(const AssetResources& resources) const
+	{
+		glm::vec3 worldCenter;
+		float worldRadius;
+		CalculateWorldBoundingSphere(resources, worldCenter, worldRadius);
+
+		// The camera is inside the bounding sphere, so the asset could be covering the whole screen
+		float screenHeight = static_cast<float>(swapChainExtent.height);
+		float distance = glm::length(worldCenter - cameraPosition);
+		if (distance <= worldRadius)
+		{
+			return screenHeight;
+		}
+
+		// The projection's Y scale maps a height of one unit at a distance of one unit to half the screen. Assuming the textures are mapped
+		// once across the asset, this is roughly the number of texels we can see along their largest dimension
+		float projectionScale = std::abs(startingProjectionMatrix[1][1]);
+		return std::min((worldRadius / distance) * projectionScale * screenHeight, screenHeight);
+	}
+
 	void Renderer::PerformLDRConversion(PrimaryCommandBuffer* cmdBuffer)
 	{
 		UpdateLDRUniformBuffer();
@@ -1843,7 +2563,7 @@ namespace TANG
 		cmdBuffer->CMD_SetScissor({ 0, 0 }, swapChainExtent);
 		cmdBuffer->CMD_SetViewport(static_cast<float>(swapChainExtent.width), static_cast<float>(swapChainExtent.height));
 		cmdBuffer->CMD_BindMesh(fullscreenQuadAsset);
-		cmdBuffer->CMD_DrawIndexed(fullscreenQuadAsset->indexCount);
+		cmdBuffer->CMD_DrawIndexed(fullscreenQuadAsset->indexCount, fullscreenQuadAsset->firstIndex, fullscreenQuadAsset->vertexOffset);
 
 		// NOTE - color attachment is cleared at the beginning of the frame, so transitioning the layout to something
 		//        else won't make a difference
@@ -1854,14 +2574,11 @@ namespace TANG
 		for (uint32_t i = 0; i < GetFDDSize(); i++)
 		{
 			auto frameData = GetFDDAtIndex(i);
-			for (auto& resources : assetResources)
+			for (auto& iter : frameData->assetCommandBuffers)
 			{
-				auto iter = frameData->assetCommandBuffers.find(resources.uuid);
-				if (iter != frameData->assetCommandBuffers.end())
-				{
-					SecondaryCommandBuffer* commandBuffer = &iter->second;
-					commandBuffer->Create(GetCommandPool(QueueType::GRAPHICS));
-				}
+				AssetCommandBuffer& assetCmdBuffer = iter.second;
+				assetCmdBuffer.commandBuffer.Create(CommandPoolRegistry::Get().GetRecordingPool(assetCmdBuffer.recordingGroup, i));
+				assetCmdBuffer.isRecorded = false;
 			}
 		}
 	}
@@ -1906,10 +2623,10 @@ namespace TANG
 		frameData->projUBO.UpdateData(&projUBO, sizeof(ProjUBO));
 	}
 
-	void Renderer::UpdateProjectionDescriptorSet(UUID uuid, uint32_t frameIndex)
+	void Renderer::UpdateProjectionDescriptorSet(UUID sharedUUID, uint32_t frameIndex)
 	{
 		auto frameData = GetFDDAtIndex(frameIndex);
-		auto& currentAssetDataMap = frameData->assetDescriptorDataMap[uuid];
+		auto& currentAssetDataMap = frameData->assetDescriptorDataMap[sharedUUID];
 
 		DescriptorSet& descSet = currentAssetDataMap.descriptorSets[1];
 
@@ -1917,34 +2634,47 @@ namespace TANG
 		WriteDescriptorSets writeDescSets(1, 0);
 		writeDescSets.AddUniformBuffer(descSet.GetDescriptorSet(), 0, &frameData->projUBO);
 		descSet.Update(writeDescSets);
+
+		// Updating a descriptor set invalidates every command buffer it's bound in
+		InvalidateSharedCommandBuffers(sharedUUID, frameIndex);
 	}
 
-	void Renderer::UpdatePBRTextureDescriptorSet(UUID uuid, uint32_t frameIndex)
+	void Renderer::UpdatePBRTextureDescriptorSet(UUID sharedUUID, uint32_t frameIndex)
 	{
 		FrameDependentData* currentFDD = GetFDDAtIndex(frameIndex);
-		auto& currentAssetDataMap = currentFDD->assetDescriptorDataMap[uuid];
+		auto& currentAssetDataMap = currentFDD->assetDescriptorDataMap[sharedUUID];
 
-		DescriptorSet& descSet = currentAssetDataMap.descriptorSets[0];
-
-		// Get the asset resources so we can retrieve the textures
-		AssetResources* asset = GetAssetResourcesFromUUID(uuid);
-		if (asset == nullptr)
+		// Get the shared resources so we can retrieve the textures
+		auto sharedIter = sharedAssetResources.find(sharedUUID);
+		if (sharedIter == sharedAssetResources.end())
 		{
 			return;
 		}
+		const AssetResources* asset = &sharedIter->second.resources;
 
-		// Update PBR textures
-		WriteDescriptorSets writeDescSets(0, 8);
-		writeDescSets.AddImage(descSet.GetDescriptorSet(), 0, &asset->material[static_cast<uint32_t>(Material::TEXTURE_TYPE::DIFFUSE)]		, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
-		writeDescSets.AddImage(descSet.GetDescriptorSet(), 1, &asset->material[static_cast<uint32_t>(Material::TEXTURE_TYPE::NORMAL)]		, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
-		writeDescSets.AddImage(descSet.GetDescriptorSet(), 2, &asset->material[static_cast<uint32_t>(Material::TEXTURE_TYPE::METALLIC)]		, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
-		writeDescSets.AddImage(descSet.GetDescriptorSet(), 3, &asset->material[static_cast<uint32_t>(Material::TEXTURE_TYPE::ROUGHNESS)]	, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
-		writeDescSets.AddImage(descSet.GetDescriptorSet(), 4, &asset->material[static_cast<uint32_t>(Material::TEXTURE_TYPE::LIGHTMAP)]		, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
-		writeDescSets.AddImage(descSet.GetDescriptorSet(), 5, cubemapPreprocessingPass.GetIrradianceMap()									, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
-		writeDescSets.AddImage(descSet.GetDescriptorSet(), 6, cubemapPreprocessingPass.GetPrefilterMap()									, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
-		writeDescSets.AddImage(descSet.GetDescriptorSet(), 7, cubemapPreprocessingPass.GetBRDFConvolutionMap()								, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+		TNG_ASSERT_MSG(currentAssetDataMap.materialDescriptorSets.size() == asset->materials.size(), "Mismatched number of material descriptor sets!");
 
-		descSet.Update(writeDescSets);
+		for (uint32_t i = 0; i < static_cast<uint32_t>(asset->materials.size()); i++)
+		{
+			DescriptorSet& descSet = currentAssetDataMap.materialDescriptorSets[i];
+			const std::vector<TextureResource*>& textures = asset->materials[i].textures;
+
+			// Update PBR textures
+			WriteDescriptorSets writeDescSets(0, 7);
+			writeDescSets.AddImage(descSet.GetDescriptorSet(), 0, textures[static_cast<uint32_t>(Material::TEXTURE_TYPE::DIFFUSE)]		, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+			writeDescSets.AddImage(descSet.GetDescriptorSet(), 1, textures[static_cast<uint32_t>(Material::TEXTURE_TYPE::NORMAL)]		, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+			writeDescSets.AddImage(descSet.GetDescriptorSet(), 2, textures[static_cast<uint32_t>(Material::TEXTURE_TYPE::ORM)]			, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+			writeDescSets.AddImage(descSet.GetDescriptorSet(), 3, textures[static_cast<uint32_t>(Material::TEXTURE_TYPE::LIGHTMAP)]		, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+			writeDescSets.AddImage(descSet.GetDescriptorSet(), 4, cubemapPreprocessingPass.GetIrradianceMap()							, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+			writeDescSets.AddImage(descSet.GetDescriptorSet(), 5, cubemapPreprocessingPass.GetPrefilterMap()							, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+			writeDescSets.AddImage(descSet.GetDescriptorSet(), 6, cubemapPreprocessingPass.GetBRDFConvolutionMap()						, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0);
+
+			descSet.Update(writeDescSets);
+		}
+
+		// Updating a descriptor set invalidates every command buffer it's bound in. This is how swapping streamed textures (or anything
+		// else about the materials) ends up re-recording the asset
+		InvalidateSharedCommandBuffers(sharedUUID, frameIndex);
 	}
 
 	void Renderer::UpdateLDRDescriptorSet()
@@ -1959,33 +2689,42 @@ namespace TANG
 		descSet.Update(writeDescSets);
 	}
 
-	void Renderer::UpdateCameraDataDescriptorSet(UUID uuid, uint32_t frameIndex)
+	bool Renderer::WriteInstanceGroup(const std::vector<AssetResources*>& assets, uint32_t& outFirstInstance, uint32_t& outFirstDraw)
 	{
-		auto frameData = GetFDDAtIndex(frameIndex);
-		auto& currentAssetDataMap = frameData->assetDescriptorDataMap[uuid];
+		FrameDependentData* frameData = GetCurrentFDD();
+		// The instance buffer is sized for a fixed number of assets, the ones past that are skipped for the frame
+		if (frameData->instanceCount + assets.size() > CONFIG::MaxDrawnAssetsPerFrame)
+		{
+			return false;
+		}
 
-		DescriptorSet& descSet = currentAssetDataMap.descriptorSets[2];
+		outFirstInstance = frameData->instanceCount;
+		outFirstDraw = 0;
 
-		// Update view matrix + camera data descriptor set
-		WriteDescriptorSets writeDescSets(2, 0);
-		writeDescSets.AddUniformBuffer(descSet.GetDescriptorSet(), 2, &frameData->viewUBO);
-		writeDescSets.AddUniformBuffer(descSet.GetDescriptorSet(), 0, &frameData->cameraDataUBO);
-		descSet.Update(writeDescSets);
-	}
+		if (gpuCullingEnabled)
+		{
+			// Every asset of the group shares the same submeshes, and there's one culling object per instance so they always fit
+			if (!gpuCullingPass.AddGroup(currentFrame, outFirstInstance, GetCurrentSubmeshes(*assets.front()), outFirstDraw))
+			{
+				return false;
+			}
 
-	void Renderer::UpdateTransformUniformBuffer(const Transform& transform, UUID uuid)
-	{
-		// Construct and update the transform UBO
-		TransformUBO tempUBO{};
+			for (const AssetResources* asset : assets)
+			{
+				gpuCullingPass.AddObject(currentFrame, CalculateTransformMatrix(asset->transform), asset->boundsCenter, asset->boundsRadius);
+			}
 
-		glm::mat4 finalTransform = glm::identity<glm::mat4>();
+			frameData->instanceCount += static_cast<uint32_t>(assets.size());
+			return true;
+		}
 
-		glm::mat4 translation = glm::translate(glm::identity<glm::mat4>(), transform.position);
-		glm::mat4 rotation = glm::eulerAngleXYZ(transform.rotation.x, transform.rotation.y, transform.rotation.z);
-		glm::mat4 scale = glm::scale(glm::identity<glm::mat4>(), transform.scale);
+		TransformUBO* transforms = static_cast<TransformUBO*>(frameData->instanceBuffer.GetMappedData());
+		for (const AssetResources* asset : assets)
+		{
+			transforms[frameData->instanceCount++] = TransformUBO(CalculateTransformMatrix(asset->transform));
+		}
 
-		tempUBO.transform = translation * rotation * scale;
-		GetCurrentFDD()->assetDescriptorDataMap[uuid].transformUBO.UpdateData(&tempUBO, sizeof(TransformUBO));
+		return true;
 	}
 
 	void Renderer::UpdateCameraDataUniformBuffers(uint32_t frameIndex, const glm::vec3& position, const glm::mat4& viewMatrix)
@@ -2002,26 +2741,11 @@ namespace TANG
 		frameData->cameraDataUBO.UpdateData(&cameraDataUBO, sizeof(CameraDataUBO));
 	}
 
-	void Renderer::UpdateTransformDescriptorSet(UUID uuid)
-	{
-		auto frameData = GetCurrentFDD();
-		auto& currentAssetDataMap = frameData->assetDescriptorDataMap[uuid];
-
-		DescriptorSet& descSet = currentAssetDataMap.descriptorSets[2];
-
-		// Update transform + cameraData descriptor sets
-		WriteDescriptorSets writeDescSets(2, 0);
-		writeDescSets.AddUniformBuffer(descSet.GetDescriptorSet(), 0, &currentAssetDataMap.transformUBO);
-		writeDescSets.AddUniformBuffer(descSet.GetDescriptorSet(), 1, &frameData->cameraDataUBO);
-		descSet.Update(writeDescSets);
-	}
-
-	void Renderer::InitializeDescriptorSets(UUID uuid, uint32_t frameIndex)
+	void Renderer::InitializeDescriptorSets(UUID sharedUUID, uint32_t frameIndex)
 	{
-		// Update all descriptor sets
-		UpdateCameraDataDescriptorSet(uuid, frameIndex);
-		UpdateProjectionDescriptorSet(uuid, frameIndex);
-		UpdatePBRTextureDescriptorSet(uuid, frameIndex);
+		// Update all descriptor sets. The camera data lives in the frame's shared set, which is written once at startup
+		UpdateProjectionDescriptorSet(sharedUUID, frameIndex);
+		UpdatePBRTextureDescriptorSet(sharedUUID, frameIndex);
 	}
 
 	void Renderer::InitializeFrameUniformBuffers()
@@ -2150,6 +2874,19 @@ namespace TANG
 	}
 
 	SecondaryCommandBuffer* Renderer::GetSecondaryCommandBufferFromUUID(UUID uuid)
+	{
+		AssetCommandBuffer* assetCmdBuffer = GetAssetCommandBufferFromUUID(uuid);
+		if (assetCmdBuffer == nullptr)
+		{
+			return nullptr;
+		}
+
+		// Whoever records into the buffer directly doesn't go through the cache, so the next cached draw must re-record it
+		assetCmdBuffer->isRecorded = false;
+		return &assetCmdBuffer->commandBuffer;
+	}
+
+	Renderer::AssetCommandBuffer* Renderer::GetAssetCommandBufferFromUUID(UUID uuid)
 	{
 		auto frameData = GetCurrentFDD();
 
@@ -2165,6 +2902,36 @@ namespace TANG
 		return &(secondaryCmdBufferIter->second);
 	}
 
+	void Renderer::InvalidateSharedCommandBuffers(UUID sharedUUID, uint32_t frameIndex)
+	{
+		auto sharedIter = sharedAssetResources.find(sharedUUID);
+		if (sharedIter == sharedAssetResources.end())
+		{
+			return;
+		}
+
+		auto frameData = GetFDDAtIndex(frameIndex);
+		for (UUID commandBufferUUID : sharedIter->second.commandBufferUUIDs)
+		{
+			auto iter = frameData->assetCommandBuffers.find(commandBufferUUID);
+			if (iter != frameData->assetCommandBuffers.end())
+			{
+				iter->second.isRecorded = false;
+			}
+		}
+	}
+
+	void Renderer::InvalidateAllAssetCommandBuffers()
+	{
+		for (uint32_t i = 0; i < GetFDDSize(); i++)
+		{
+			for (auto& iter : GetFDDAtIndex(i)->assetCommandBuffers)
+			{
+				iter.second.isRecorded = false;
+			}
+		}
+	}
+
 	void Renderer::CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
 	{
 		DisposableCommand command(QueueType::TRANSFER, true);
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <optional>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -11,6 +12,7 @@
 #include "cmd_buffer/primary_command_buffer.h"
 #include "cmd_buffer/secondary_command_buffer.h"
 
+#include "data_buffer/shader_storage_buffer.h"
 #include "data_buffer/uniform_buffer.h"
 
 #include "descriptors/descriptor_pool.h"
@@ -20,6 +22,7 @@
 
 #include "passes/bloom_pass.h"
 #include "passes/cubemap_preprocessing_pass.h"
+#include "passes/gpu_culling_pass.h"
 #include "passes/pbr_pass.h"
 #include "passes/skybox_pass.h"
 
@@ -30,8 +33,10 @@
 #include "render_passes/ldr_render_pass.h"
 
 #include "framebuffer.h"
+#include "frustum_culler.h"
 #include "queue_types.h"
 #include "texture_resource.h"
+#include "utils/thread_pool.h"
 
 struct GLFWwindow;
 
@@ -41,6 +46,7 @@ namespace TANG
 	struct SwapChainSupportDetails;
 	class QueueFamilyIndices;
 	class DisposableCommand;
+	class UploadContext;
 
 	class Renderer
 	{
@@ -52,6 +58,7 @@ namespace TANG
 		Renderer& operator=(const Renderer& other) = delete;
 
 		friend class DisposableCommand;
+		friend class StagingRing;
 
 	public:
 
@@ -93,11 +100,24 @@ namespace TANG
 		// Before calling this function, make sure you've called LoaderUtils::LoadAsset() and have
 		// successfully loaded an asset from file! This functions assumes this, and if it can't retrieve
 		// the loaded asset data it will return prematurely
+		// 
+		// The uploads are recorded into the current upload batch if there is one, otherwise they're submitted right away. Either way this
+		// function doesn't wait for them to complete, see IsAssetUploadComplete(). Returns nullptr on failure, in which case the asset is
+		// not known to the renderer
 		AssetResources* CreateAssetResources(AssetDisk* asset, CorePipeline corePipeline);
 
-		void CreatePBRAssetResources(AssetDisk* asset, AssetResources& out_resources);
-		void CreateSkyboxAssetResources(AssetDisk* asset, AssetResources& out_resources);
-		void CreateFullscreenQuadAssetResources(AssetDisk* asset, AssetResources& out_resources);
+		// These return false if the resources could not be created. Nothing is left allocated in that case
+		bool CreatePBRAssetResources(UploadContext& context, AssetDisk* asset, AssetResources& out_resources);
+		bool CreateSkyboxAssetResources(UploadContext& context, AssetDisk* asset, AssetResources& out_resources);
+		bool CreateFullscreenQuadAssetResources(UploadContext& context, AssetDisk* asset, AssetResources& out_resources);
+
+		// Every asset created between these two calls records it's uploads (geometry, texture copies, layout transitions and mip generation)
+		// into the same command buffer, which is submitted once by EndUploadBatch(). Returns the timeline value of that submission
+		void BeginUploadBatch();
+		uint64_t EndUploadBatch();
+
+		// Returns whether the GPU has finished uploading the asset's resources. Assets in an upload batch that hasn't ended yet are never complete
+		bool IsAssetUploadComplete(UUID uuid);
 
 		void DestroyAssetResources(UUID uuid);
 		void DestroyAllAssetResources();
@@ -108,6 +128,12 @@ namespace TANG
 		// Updates the view matrix using the provided position and inverted view matrix. The caller can get this data from any derived BaseCamera object
 		void UpdateCameraData(const glm::vec3& position, const glm::mat4& viewMatrix);
 
+		// Returns how many asset secondary command buffers had to be re-recorded during the last frame. The rest were reused as-is
+		uint32_t GetRecordedAssetCommandBufferCount() const;
+
+		// Returns how many assets were tested against the camera's frustum during the last frame, and how many of them were culled
+		CullingStatistics GetCullingStatistics() const;
+
 	private:
 
 		VkInstance vkInstance;
@@ -126,9 +152,24 @@ namespace TANG
 		// position might change every frame, but the PBR textures will likely seldom change (if at all)
 		struct AssetDescriptorData
 		{
+			// Indexed by set number. Set 0 holds the PBR textures and is stored per-material in materialDescriptorSets instead,
+			// and set 2 is shared by every asset (see FrameDependentData::volatileDescriptorSet), so their entries in here are left empty
 			std::vector<DescriptorSet> descriptorSets;
+			std::vector<DescriptorSet> materialDescriptorSets;
+		};
 
-			UniformBuffer transformUBO;
+		// An asset's secondary command buffer, along with the state it was recorded with. The commands only change when something they
+		// reference does, so the buffer is reused across frames until it's explicitly invalidated (see InvalidateSharedCommandBuffers()),
+		// or until the LOD, instance range or indirect draws it was recorded with no longer match
+		struct AssetCommandBuffer
+		{
+			SecondaryCommandBuffer commandBuffer;
+			uint32_t recordingGroup = 0;		// The buffer is allocated from this group's recording pools
+			bool isRecorded = false;
+			uint32_t recordedLOD = 0;
+			uint32_t recordedFirstInstance = 0;
+			uint32_t recordedInstanceCount = 0;
+			uint32_t recordedFirstDraw = 0;
 		};
 
 
@@ -148,6 +189,12 @@ namespace TANG
 			UniformBuffer projUBO;
 			UniformBuffer cameraDataUBO;
 
+			// The transforms of every instance drawn this frame are written back-to-back into this buffer, and the vertex shader reads
+			// it's own with gl_InstanceIndex. Since set 2 doesn't hold anything asset-specific otherwise, all the assets share it
+			ShaderStorageBuffer instanceBuffer = ShaderStorageBuffer(0, true);
+			uint32_t instanceCount = 0;				// Transforms written this frame
+			DescriptorSet volatileDescriptorSet;
+
 			// Skybox
 			std::array<DescriptorSet, 3> skyboxDescriptorSets;
 
@@ -167,32 +214,37 @@ namespace TANG
 			PrimaryCommandBuffer hdrCommandBuffer;
 			PrimaryCommandBuffer postProcessingCommandBuffer;
 			PrimaryCommandBuffer ldrCommandBuffer;
-			std::unordered_map<UUID, SecondaryCommandBuffer> assetCommandBuffers;
+			std::unordered_map<UUID, AssetCommandBuffer> assetCommandBuffers;
 
 			TextureResource hdrDepthBuffer;
 			TextureResource hdrAttachment;
 			Framebuffer hdrFramebuffer;
+
+			// Residency version of the streamed textures when the material descriptor sets were last written (see TextureStreamer)
+			uint64_t textureResidencyVersion = 0;
 		};
 		std::vector<FrameDependentData> frameDependentData;
 		// We want to organize our descriptor sets as follows:
 		// 
-		// FOR EVERY ASSET:
+		// FOR EVERY UNIQUE ASSET (copies share their sets, see SharedAssetResources):
 		//		FOR EVERY FRAME IN FLIGHT:
-		//			Descriptor set 0:
+		//			Descriptor set 0 (one per material):
 		//				- diffuse sampler			(binding 0)
 		//				- normal sampler			(binding 1)
-		//				- metallic sampler			(binding 2)
-		//				- roughness sampler			(binding 3)
-		//				- lightmap sampler			(binding 4)
+		//				- ORM sampler				(binding 2, occlusion, roughness and metallic packed together)
+		//				- lightmap sampler			(binding 3)
+		//				- irradiance map sampler	(binding 4)
+		//				- prefilter map sampler		(binding 5)
+		//				- BRDF convolution sampler	(binding 6)
 		//			Descriptor set 1:
 		//				- Projection matrix UBO		(binding 0)
-		//			Descriptor set 2:
-		//				- CameraData UBO			(binding 0)
-		//				- Transform matrix UBO		(binding 1)
-		//				- View matrix UBO			(binding 2)
+		//				- Camera exposure UBO		(binding 1)
 		// 
-		// Total per frame in flight: 3 descriptor sets - 4 uniform buffers and 5 image samplers
-		// Total per all frames in flight (2): 6 descriptor sets - 8 uniform buffers and 10 image samplers
+		// FOR EVERY FRAME IN FLIGHT:
+		//			Descriptor set 2 (shared by every asset):
+		//				- Instance transform SSBO	(binding 0, indexed with gl_InstanceIndex)
+		//				- CameraData UBO			(binding 1)
+		//				- View matrix UBO			(binding 2)
 
 
 		////////////////////////////////////////////////////////////////////
@@ -228,6 +280,9 @@ namespace TANG
 		UUID skyboxAssetUUID;
 		UUID fullscreenQuadAssetUUID;
 
+		UploadContext* uploadBatch;				// Null if no upload batch was begun
+		std::vector<UUID> uploadBatchAssets;	// Assets created in the current upload batch, their upload value is only known once it's submitted
+
 		uint32_t currentFrame;
 
 		// TODO - Rework this garbage
@@ -235,11 +290,64 @@ namespace TANG
 		glm::mat4 startingCameraViewMatrix;
 		glm::mat4 startingProjectionMatrix;
 
+		glm::vec3 cameraPosition;
+		glm::mat4 cameraViewMatrix;
+
+		// Culls the assets that are ready to be drawn against the camera's frustum, before they're grouped and recorded
+		FrustumCuller frustumCuller;
+
+		// Culls the drawn assets on the GPU, and owns the indirect draws they're drawn with. Only created if gpuCullingEnabled is true
+		GPUCullingPass gpuCullingPass;
+		bool gpuCullingEnabled;					// CONFIG::EnableGPUCulling, as long as the device supports drawIndirectFirstInstance
+
+		// Records the assets' secondary command buffers in parallel, one job per recording group (see CommandPoolRegistry::CreateRecordingPools())
+		ThreadPool recordingThreadPool;
+		uint32_t nextRecordingGroup;			// Recording groups are handed out to new assets round-robin
+		uint32_t recordedAssetCommandBufferCount;	// Asset secondary command buffers re-recorded during the last frame
+		std::vector<VkCommandBuffer> preparedAssetCommandBuffers;	// Filled by PrepareAssetDraws(), and executed by DrawAssets()
+
+		// Everything needed to record an asset's secondary command buffer, gathered on the main thread before recording. The asset draws
+		// every instance of it's instance group
+		struct AssetDrawRecord
+		{
+			AssetResources* resources;
+			SecondaryCommandBuffer* commandBuffer;
+			uint32_t firstInstance;
+			uint32_t instanceCount;
+			uint32_t firstDraw;					// Index of the group's first indirect draw, only used with GPU culling
+		};
+
 		// The assetResources vector contains all the vital information that we need for every asset in order to render it
 		// The resourcesMap maps an asset's UUID to a location within the assetResources vector
 		std::unordered_map<UUID, uint32_t> resourcesMap;
 		std::vector<AssetResources> assetResources;
 
+		// Everything the copies of an asset (the same source file loaded more than once) have in common: the geometry, the textures, the descriptor
+		// sets and the secondary command buffers. The first copy creates them, and they're released along with the last copy. Every LOD gets it's
+		// own command buffer, since copies drawn at different LODs end up in different instanced draws
+		struct SharedAssetResources
+		{
+			AssetResources resources;				// The first copy's resources, which every later copy starts out from
+			std::string sourceName;					// Source file of the asset, see AssetDisk::name. Empty if the asset can't be shared
+			std::vector<UUID> commandBufferUUIDs;	// Indexed by LOD
+			uint64_t uploadValue = 0;				// Most recent upload value any of the copies was given, see SetAssetUploadValue()
+			uint32_t refCount = 0;
+		};
+		std::unordered_map<UUID, SharedAssetResources> sharedAssetResources;	// Keyed by AssetResources::sharedUUID
+		std::unordered_map<std::string, UUID> sharedAssetUUIDs;					// Maps an asset's source file to it's shared UUID
+
+		// The geometry and textures of destroyed assets may still be read by the frames in flight, so they're only released once every
+		// frame in flight has waited on it's fence since the asset was destroyed (see ReleaseRetiredAssetResources())
+		struct RetiredAssetResources
+		{
+			GeometryAllocation vertexAllocation;
+			GeometryAllocation indexAllocation;
+			std::vector<TextureResource*> textures;
+			uint64_t retiredFrame;
+		};
+		std::vector<RetiredAssetResources> retiredAssetResources;
+		uint64_t frameCounter;					// Incremented every frame, after waiting on the frame's fence
+
 		DescriptorPool descriptorPool;
 
 		// Cached window sizes
@@ -282,10 +390,12 @@ namespace TANG
 		void CreateSwapChain();
 		void CreateSwapChainImageViews(uint32_t imageCount);
 
-		// Creates a secondary command buffer, given the asset resources. After an asset is loaded and it's asset resources
-		// are loaded, this function must be called to create the secondary command buffer that holds the commands to render
-		// the asset.
-		void CreateAssetCommandBuffer(AssetResources* resources);
+		// Creates a secondary command buffer per frame in flight under the provided UUID, allocated from the recording group's pools. Core assets
+		// get one under their own UUID, while PBR assets get one per LOD under the UUIDs of their shared resources (see SharedAssetResources)
+		void CreateAssetCommandBuffer(UUID uuid, uint32_t recordingGroup);
+
+		// Hands out the recording groups round-robin, so the recording jobs end up roughly the same size
+		uint32_t AcquireRecordingGroup();
 
 		void CreateCommandPools();
 
@@ -301,11 +411,11 @@ namespace TANG
 
 		void CreateSyncObjects();
 
-		void CreateAssetUniformBuffers(UUID uuid);
 		void CreateFrameUniformBuffers();
 		void CreateLDRUniformBuffer();
 
-		void CreateAssetDescriptorSets(UUID uuid);
+		void CreateAssetDescriptorSets(UUID uuid, uint32_t materialCount);
+		void CreateFrameDescriptorSets();
 		void CreateLDRDescriptorSet();
 
 		void CreateDescriptorSetLayouts();
@@ -317,8 +427,35 @@ namespace TANG
 		void CreateDepthTextures();
 		void CreateColorAttachmentTextures();
 
+		// Assets outside the camera's frustum are culled first (see CONFIG::EnableFrustumCulling), and the rest are grouped. Assets that share
+		// the same shared resources (see AssetResources::sharedUUID) and LOD are grouped together, and every group is drawn with a
+		// single instanced draw recorded into the shared command buffer of that LOD. With GPU culling, the culling dispatch
+		// is recorded into the command buffer as well, so this must be called before the HDR render pass begins
+		void PrepareAssetDraws(PrimaryCommandBuffer* cmdBuffer);
+
+		// Executes the secondary command buffers gathered by PrepareAssetDraws()
 		void DrawAssets(PrimaryCommandBuffer* cmdBuffer);
-		void RecordSecondaryCommandBuffer(SecondaryCommandBuffer* cmdBuffer, AssetResources* resources);
+
+		// Only reads the asset's resources and the frame's descriptor sets, so it may be called from the recording threads as long as
+		// no two threads record from the same recording group
+		void RecordSecondaryCommandBuffer(const AssetDrawRecord& draw);
+
+		// Records the secondary command buffers of every draw. Past CONFIG::ParallelRecordingMinAssets draws, the recording is split across
+		// the recording threads by recording group
+		void RecordSecondaryCommandBuffers(const std::vector<AssetDrawRecord>& draws);
+
+		// Streams texture mips in and out, and rewrites the material descriptor sets of the current frame if any streamed texture was replaced.
+		// Must be called after waiting on the current frame's fence
+		void UpdateStreamedTextures();
+
+		// Requests the asset's textures to be streamed in at the resolution they're visible at on screen
+		void RequestTextureResidency(const AssetResources& resources, float screenSize);
+
+		// Picks the LOD the asset is drawn with, based on the fraction of the screen height it covers (see CONFIG::MeshLODScreenSizes)
+		void SelectLOD(AssetResources& resources, float screenSize);
+
+		// Estimates how many pixels tall the asset's bounding sphere is on screen
+		float CalculateScreenSize(const AssetResources& resources) const;
 
 		void PerformLDRConversion(PrimaryCommandBuffer* cmdBuffer);
 
@@ -328,16 +465,19 @@ namespace TANG
 
 		void CleanupSwapChain();
 
-		void InitializeDescriptorSets(UUID uuid, uint32_t frameIndex);
+		// The asset descriptor sets are shared by every copy of an asset, so these take the copies' shared UUID (see AssetResources::sharedUUID)
+		void InitializeDescriptorSets(UUID sharedUUID, uint32_t frameIndex);
 		void InitializeFrameUniformBuffers();
 
-		void UpdateTransformDescriptorSet(UUID uuid);
-		void UpdateCameraDataDescriptorSet(UUID uuid, uint32_t frameIndex);
-		void UpdateProjectionDescriptorSet(UUID uuid, uint32_t frameIndex);
-		void UpdatePBRTextureDescriptorSet(UUID uuid, uint32_t frameIndex);
+		void UpdateProjectionDescriptorSet(UUID sharedUUID, uint32_t frameIndex);
+		void UpdatePBRTextureDescriptorSet(UUID sharedUUID, uint32_t frameIndex);
 		void UpdateLDRDescriptorSet();
 
-		void UpdateTransformUniformBuffer(const Transform& transform, UUID uuid);
+		// Reserves a range of the current frame's instance buffer for the assets, and returns the index of the first one. Without GPU culling
+		// their transforms are written back-to-back right away. With GPU culling they're handed to the culling pass along with an indirect draw
+		// per submesh (returning the index of the first one), and only the visible ones are written by the GPU. Returns false if they don't
+		// all fit (see CONFIG::MaxDrawnAssetsPerFrame and CONFIG::MaxIndirectDrawsPerFrame)
+		bool WriteInstanceGroup(const std::vector<AssetResources*>& assets, uint32_t& outFirstInstance, uint32_t& outFirstDraw);
 		void UpdateCameraDataUniformBuffers(uint32_t frameIndex, const glm::vec3& position, const glm::mat4& viewMatrix);
 		void UpdateProjectionUniformBuffer(uint32_t frameIndex);
 		void UpdateLDRUniformBuffer();
@@ -350,6 +490,14 @@ namespace TANG
 
 		AssetResources* GetAssetResourcesFromUUID(UUID uuid);
 		SecondaryCommandBuffer* GetSecondaryCommandBufferFromUUID(UUID uuid);
+		AssetCommandBuffer* GetAssetCommandBufferFromUUID(UUID uuid);
+
+		// Forces the secondary command buffers of every LOD of the shared resources to be re-recorded for the provided frame the next time
+		// they're drawn. Must be called whenever something the recorded commands reference changes, like the descriptor sets being rewritten
+		void InvalidateSharedCommandBuffers(UUID sharedUUID, uint32_t frameIndex);
+
+		// Same as above, for every asset and every frame. Used when the swap chain is recreated, since every buffer references it's extent and framebuffer
+		void InvalidateAllAssetCommandBuffers();
 
 		void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
 
@@ -359,8 +507,27 @@ namespace TANG
 
 		bool HasStencilComponent(VkFormat format);
 
+		// Sub-allocates the vertex and index data of the mesh from the GeometryArena and uploads it. Fills out the allocations, vertex offset,
+		// first index and index type of the asset resources. Returns false if the geometry could not be allocated
+		bool CreateMeshGeometry(UploadContext& context, BaseMesh* mesh, const void* vertexData, uint64_t vertexCount, uint32_t vertexStride, AssetResources& out_resources);
+
+		// Retires the asset's geometry and textures, they're released once no frame in flight can be using them anymore
 		void DestroyAssetBuffersHelper(AssetResources* resources);
 
+		// Returns the geometry and textures of destroyed assets to the arena and the texture registry. Unless forced, only the resources
+		// that were retired more than CONFIG::MaxFramesInFlight frames ago are released
+		void ReleaseRetiredAssetResources(bool force);
+
+		// Copies don't upload anything themselves, so they're drawn once the copy that created the shared resources has been uploaded
+		void SetAssetUploadValue(AssetResources& resources, uint64_t value);
+
+		// Submits the current upload batch, and stamps the assets created in it with the timeline value of the submission. The batch keeps recording afterwards
+		uint64_t FlushUploadBatch();
+
+		// Submits everything recorded into the context (flushing the batch if it's the upload batch) and waits for it to complete. Only meant for
+		// core assets that are used as soon as they're created, since everything else is drawn once it's upload completes without waiting
+		void WaitForAssetUploads(UploadContext& context);
+
 		VkFramebuffer GetFramebufferAtIndex(uint32_t frameBufferIndex);
 
 		// Returns the current frame-dependent data
@@ -58,12 +58,11 @@ layout(location = 3) in mat3 inTBN;
 
 layout(set = 0, binding = 0) uniform sampler2D diffuseSampler;
 layout(set = 0, binding = 1) uniform sampler2D normalSampler;
-layout(set = 0, binding = 2) uniform sampler2D metallicSampler;
-layout(set = 0, binding = 3) uniform sampler2D roughnessSampler;
-layout(set = 0, binding = 4) uniform sampler2D lightmapSampler;
-layout(set = 0, binding = 5) uniform samplerCube irradianceMap;
-layout(set = 0, binding = 7) uniform sampler2D BRDFLUT;
-layout(set = 0, binding = 6) uniform samplerCube prefilterMap;
+layout(set = 0, binding = 2) uniform sampler2D ormSampler; // Occlusion (R), roughness (G), metallic (B)
+layout(set = 0, binding = 3) uniform sampler2D lightmapSampler;
+layout(set = 0, binding = 4) uniform samplerCube irradianceMap;
+layout(set = 0, binding = 6) uniform sampler2D BRDFLUT;
+layout(set = 0, binding = 5) uniform samplerCube prefilterMap;
 
 layout(set = 2, binding = 1) uniform CameraData {
     vec4 position;
@@ -83,8 +82,9 @@ const float MAX_REFLECTION_LOD = 4.0;
 void main() 
 {
     // NORMAL MAP
-    vec3 normal = texture(normalSampler, inUV).rgb;
-    normal = normal * 2.0 - 1.0;
+    // Normal maps only store X and Y (either as BC5 or RG8). Z is always positive in tangent space, so it's reconstructed here
+    vec2 normalXY = texture(normalSampler, inUV).rg * 2.0 - 1.0;
+    vec3 normal = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
     normal = normalize( inTBN * normal );
     ////
 
@@ -103,8 +103,10 @@ void main()
     float HdotV = max(dot(halfVector, view), 0.0);
     float HdotN = max(dot(halfVector, normal), 0.0);
     float lightIntensity = 1.0; // NOTE - This is only for point / spotlights, which we do not support right now
-    float metalness = texture(metallicSampler, inUV).b;
-    float roughness = texture(roughnessSampler, inUV).g;
+    vec3 orm = texture(ormSampler, inUV).rgb;
+    float ambientOcclusion = orm.r;
+    float roughness = orm.g;
+    float metalness = orm.b;
     ////
 
     vec3 F0 = vec3(0.04);
@@ -151,7 +153,7 @@ void main()
         vec2 BRDFSample = texture(BRDFLUT, vec2(NdotV, roughness)).rg;
         vec3 specular = prefilteredColor * (F * BRDFSample.x + BRDFSample.y);
 
-        ambient = (kD * diffuse + specular) * 1.0; // Hard-coding the ambient occlusion term to 1.0 for now
+        ambient = (kD * diffuse + specular) * ambientOcclusion;
     }
     ////
 
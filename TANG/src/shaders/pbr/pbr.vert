@@ -8,40 +8,59 @@ layout(set = 2, binding = 2) uniform ViewObject {
     mat4 view;
 } viewUBO;
 
-layout(set = 2, binding = 0) uniform TransformObject {
-    mat4 transform;
-} transformUBO;
+// The transforms of every instance drawn this frame. Instanced draws start at their own firstInstance, which gl_InstanceIndex includes
+layout(std430, set = 2, binding = 0) readonly buffer InstanceTransforms {
+    mat4 transforms[];
+} instanceData;
 
 
+// Packed vertex layout, see PackedPBRVertex in vertex_types.h
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inTangent;
-layout(location = 3) in vec3 inBitangent;
-layout(location = 4) in vec2 inUV;
+layout(location = 1) in vec2 inPackedNormal;  // Octahedral-encoded normal
+layout(location = 2) in vec2 inPackedTangent; // Octahedral-encoded tangent, Y is remapped to (0, 1] and multiplied by the bitangent sign
+layout(location = 3) in vec2 inUV;
 
 layout(location = 0) out vec3 outWorldPosition;
 layout(location = 1) out vec3 outNormal;
 layout(location = 2) out vec2 outUV;
 layout(location = 3) out mat3 outTBN;
 
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.x += (v.x >= 0.0) ? -t : t;
+    v.y += (v.y >= 0.0) ? -t : t;
+    return normalize(v);
+}
+
 void main() {
-    gl_Position = projUBO.proj * viewUBO.view * transformUBO.transform * vec4(inPosition, 1.0);
+    // Unpack the normal, tangent and bitangent
+    vec3 inNormal = DecodeOctahedral(inPackedNormal);
+
+    float bitangentSign = (inPackedTangent.y < 0.0) ? -1.0 : 1.0;
+    vec3 inTangent = DecodeOctahedral(vec2(inPackedTangent.x, abs(inPackedTangent.y) * 2.0 - 1.0));
+    vec3 inBitangent = cross(inNormal, inTangent) * bitangentSign;
+
+    mat4 transform = instanceData.transforms[gl_InstanceIndex];
+
+    gl_Position = projUBO.proj * viewUBO.view * transform * vec4(inPosition, 1.0);
 
     // Calculate the output variables going to the pixel shader
-    outWorldPosition = (transformUBO.transform * vec4(inPosition, 1.0)).xyz;
+    outWorldPosition = (transform * vec4(inPosition, 1.0)).xyz;
 
-    outNormal = normalize((transformUBO.transform * vec4(inNormal, 0.0)).xyz);
+    outNormal = normalize((transform * vec4(inNormal, 0.0)).xyz);
     outUV = inUV;
 
     // Construct the TBN matrix
-    vec3 T = normalize((transformUBO.transform * vec4(inTangent, 0.0)).xyz);
+    vec3 T = normalize((transform * vec4(inTangent, 0.0)).xyz);
     vec3 N = outNormal;
 
     // Re-orthogonalize the TBN matrix in case the tangents are interpolated between vertices (using Gram-Schmidt process)
     T = normalize(T - dot(T, N) * N);
 
     //vec3 B = cross(N, T);
-    vec3 B = normalize((transformUBO.transform * vec4(inBitangent, 0.0)).xyz);
+    vec3 B = normalize((transform * vec4(inBitangent, 0.0)).xyz);
 
     // TBN must form a right handed coord system.
     // Some models have symmetric UVs. Check and fix.
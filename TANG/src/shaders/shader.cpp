@@ -25,6 +25,7 @@ static const std::unordered_map<TANG::ShaderType, std::string> ShaderTypeToFolde
 	{ TANG::ShaderType::BLOOM_UPSCALING			, "bloom_upscaling"			},
 	{ TANG::ShaderType::BLOOM_DOWNSCALING		, "bloom_downscaling"		},
 	{ TANG::ShaderType::BLOOM_COMPOSITION		, "bloom_composition"		},
+	{ TANG::ShaderType::GPU_CULLING				, "gpu_culling"				},
 };
 
 static const std::unordered_map<TANG::ShaderStage, std::string> ShaderStageToFileName =
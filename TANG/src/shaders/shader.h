@@ -23,6 +23,7 @@ namespace TANG
 		BLOOM_UPSCALING,
 		BLOOM_DOWNSCALING,
 		BLOOM_COMPOSITION,
+		GPU_CULLING,
 	};
 
 	enum class ShaderStage
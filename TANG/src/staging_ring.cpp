@@ -0,0 +1,365 @@
+
+#include "command_pool_registry.h"
+#include "device_cache.h"
+#include "renderer.h"
+#include "staging_ring.h"
+#include "utils/logger.h"
+#include "utils/sanity_check.h"
+
+namespace TANG
+{
+	StagingRing::StagingRing() : buffer(), capacity(0), head(0), tail(0), usedBytes(0), pendingBytes(0), submissions(), followUps(), freeFences(), stallCount(0), submittedValue(0), completedValue(0)
+	{
+	}
+
+	StagingRing::~StagingRing()
+	{
+		if (!submissions.empty() || !followUps.empty())
+		{
+			LogWarning("Staging ring destroyed with %u submissions still in flight!", static_cast<uint32_t>(submissions.size() + followUps.size()));
+		}
+	}
+
+	void StagingRing::Create(VkDeviceSize size)
+	{
+		TNG_ASSERT_MSG(size > 0, "Staging ring size must be greater than zero!");
+
+		buffer.Create(size);
+		if (buffer.IsInvalid())
+		{
+			LogError("Failed to create staging ring of %llu bytes!", size);
+			return;
+		}
+
+		capacity = size;
+		head = 0;
+		tail = 0;
+		usedBytes = 0;
+		pendingBytes = 0;
+	}
+
+	void StagingRing::Destroy()
+	{
+		if (pendingBytes > 0)
+		{
+			LogWarning("Destroying staging ring with %llu bytes that were never submitted!", pendingBytes);
+		}
+
+		while (!submissions.empty())
+		{
+			Reclaim(true);
+		}
+		ReclaimFollowUps(true, completedValue);
+
+		VkDevice logicalDevice = GetLogicalDevice();
+		for (VkFence fence : freeFences)
+		{
+			vkDestroyFence(logicalDevice, fence, nullptr);
+		}
+		freeFences.clear();
+
+		buffer.Destroy();
+
+		capacity = 0;
+		head = 0;
+		tail = 0;
+		usedBytes = 0;
+		pendingBytes = 0;
+	}
+
+	bool StagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment, StagingRegion& outRegion)
+	{
+		if (size == 0 || size > capacity)
+		{
+			LogError("Invalid staging ring allocation of %llu bytes, the ring holds %llu bytes!", size, capacity);
+			return false;
+		}
+
+		if (alignment == 0)
+		{
+			alignment = 1;
+		}
+
+		Reclaim(false);
+
+		VkDeviceSize consumedBytes = 0;
+		VkDeviceSize offset = FindRegion(size, alignment, consumedBytes);
+		while (offset == capacity)
+		{
+			// The space we need is held by regions that haven't even been submitted, so waiting won't help
+			if (submissions.empty())
+			{
+				return false;
+			}
+
+			stallCount++;
+			Reclaim(true);
+			offset = FindRegion(size, alignment, consumedBytes);
+		}
+
+		head = offset + size;
+		if (head == capacity)
+		{
+			head = 0;
+		}
+
+		usedBytes += consumedBytes;
+		pendingBytes += consumedBytes;
+
+		outRegion.buffer = buffer.GetBuffer();
+		outRegion.offset = offset;
+		outRegion.size = size;
+		outRegion.mappedData = static_cast<char*>(buffer.GetAllocation().mappedData) + offset;
+
+		return true;
+	}
+
+	uint64_t StagingRing::Submit(QueueType type, VkCommandBuffer commandBuffer, VkCommandBuffer followUpCommandBuffer)
+	{
+		VkDevice logicalDevice = GetLogicalDevice();
+
+		vkEndCommandBuffer(commandBuffer);
+
+		VkFence fence = AcquireFence();
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+
+		if (fence == VK_NULL_HANDLE || Renderer::GetInstance().SubmitQueue(type, &submitInfo, 1, fence, false) != VK_SUCCESS)
+		{
+			LogError("Failed to submit staging ring upload!");
+
+			// Nothing is going to read from the regions, so we can hand them out again right away. They're the most recent ones, so
+			// rolling back the head is enough
+			head = (head + capacity - (pendingBytes % capacity)) % capacity;
+			usedBytes -= pendingBytes;
+			pendingBytes = 0;
+
+			if (usedBytes == 0)
+			{
+				head = 0;
+				tail = 0;
+			}
+
+			if (fence != VK_NULL_HANDLE) vkDestroyFence(logicalDevice, fence, nullptr);
+			vkFreeCommandBuffers(logicalDevice, GetCommandPool(type), 1, &commandBuffer);
+			if (followUpCommandBuffer != VK_NULL_HANDLE) vkFreeCommandBuffers(logicalDevice, GetCommandPool(QueueType::GRAPHICS), 1, &followUpCommandBuffer);
+			return 0;
+		}
+
+		if (followUpCommandBuffer != VK_NULL_HANDLE)
+		{
+			vkEndCommandBuffer(followUpCommandBuffer);
+		}
+
+		submittedValue++;
+		submissions.push_back({ pendingBytes, fence, submittedValue, type, commandBuffer, followUpCommandBuffer });
+		pendingBytes = 0;
+
+		return submittedValue;
+	}
+
+	void StagingRing::Update()
+	{
+		Reclaim(false);
+	}
+
+	bool StagingRing::IsComplete(uint64_t value)
+	{
+		if (value <= completedValue)
+		{
+			return true;
+		}
+
+		Reclaim(false);
+		return value <= completedValue;
+	}
+
+	void StagingRing::Wait(uint64_t value)
+	{
+		// Submissions are reclaimed in order, so waiting on the oldest one until ours is reclaimed never waits longer than needed
+		while (value > completedValue && !submissions.empty())
+		{
+			Reclaim(true);
+		}
+
+		ReclaimFollowUps(true, value);
+	}
+
+	VkDeviceSize StagingRing::GetCapacity() const
+	{
+		return capacity;
+	}
+
+	StagingRingStatistics StagingRing::GetStatistics() const
+	{
+		StagingRingStatistics stats;
+		stats.capacityBytes = capacity;
+		stats.usedBytes = usedBytes;
+		stats.inFlightSubmissions = static_cast<uint32_t>(submissions.size());
+		stats.stallCount = stallCount;
+		stats.submittedValue = submittedValue;
+		stats.completedValue = completedValue;
+		stats.inFlightFollowUps = static_cast<uint32_t>(followUps.size());
+
+		return stats;
+	}
+
+	VkDeviceSize StagingRing::FindRegion(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outConsumedBytes) const
+	{
+		// Reclaim() rewinds the ring once it's empty, so the whole buffer is available
+		if (usedBytes == 0)
+		{
+			outConsumedBytes = size;
+			return 0;
+		}
+
+		VkDeviceSize alignedHead = ((head + alignment - 1) / alignment) * alignment;
+
+		if (head >= tail)
+		{
+			// The head caught up with the tail, so the ring is full
+			if (head == tail)
+			{
+				return capacity;
+			}
+
+			// The free space is split between the end and the start of the buffer
+			if (alignedHead + size <= capacity)
+			{
+				outConsumedBytes = alignedHead + size - head;
+				return alignedHead;
+			}
+
+			// Skip the rest of the buffer and wrap around. The skipped bytes are reclaimed along with the region
+			if (size <= tail)
+			{
+				outConsumedBytes = (capacity - head) + size;
+				return 0;
+			}
+
+			return capacity;
+		}
+
+		// The free space is between the head and the tail
+		if (alignedHead + size <= tail)
+		{
+			outConsumedBytes = alignedHead + size - head;
+			return alignedHead;
+		}
+
+		return capacity;
+	}
+
+	void StagingRing::Reclaim(bool wait)
+	{
+		VkDevice logicalDevice = GetLogicalDevice();
+
+		if (wait && !submissions.empty())
+		{
+			vkWaitForFences(logicalDevice, 1, &submissions.front().fence, VK_TRUE, UINT64_MAX);
+		}
+
+		while (!submissions.empty() && vkGetFenceStatus(logicalDevice, submissions.front().fence) == VK_SUCCESS)
+		{
+			Submission& submission = submissions.front();
+
+			vkFreeCommandBuffers(logicalDevice, GetCommandPool(submission.type), 1, &submission.commandBuffer);
+
+			if (submission.followUpCommandBuffer != VK_NULL_HANDLE)
+			{
+				SubmitFollowUp(submission);
+			}
+
+			vkResetFences(logicalDevice, 1, &submission.fence);
+			freeFences.push_back(submission.fence);
+
+			usedBytes -= submission.bytes;
+			tail = (tail + submission.bytes) % capacity;
+			completedValue = submission.value;
+
+			submissions.pop_front();
+		}
+
+		if (usedBytes == 0)
+		{
+			head = 0;
+			tail = 0;
+		}
+
+		ReclaimFollowUps(false, 0);
+	}
+
+	void StagingRing::SubmitFollowUp(const Submission& submission)
+	{
+		VkCommandBuffer commandBuffer = submission.followUpCommandBuffer;
+		VkFence fence = AcquireFence();
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+
+		if (fence == VK_NULL_HANDLE || Renderer::GetInstance().SubmitQueue(QueueType::GRAPHICS, &submitInfo, 1, fence, false) != VK_SUCCESS)
+		{
+			LogError("Failed to submit follow-up of staging ring upload %llu!", submission.value);
+
+			if (fence != VK_NULL_HANDLE) freeFences.push_back(fence);
+			vkFreeCommandBuffers(GetLogicalDevice(), GetCommandPool(QueueType::GRAPHICS), 1, &commandBuffer);
+			return;
+		}
+
+		followUps.push_back({ fence, submission.value, commandBuffer });
+	}
+
+	void StagingRing::ReclaimFollowUps(bool wait, uint64_t value)
+	{
+		VkDevice logicalDevice = GetLogicalDevice();
+
+		// Follow-ups are submitted in order on a single queue, so they also complete in order
+		while (!followUps.empty())
+		{
+			FollowUp& followUp = followUps.front();
+
+			if (wait && followUp.value <= value)
+			{
+				vkWaitForFences(logicalDevice, 1, &followUp.fence, VK_TRUE, UINT64_MAX);
+			}
+			else if (vkGetFenceStatus(logicalDevice, followUp.fence) != VK_SUCCESS)
+			{
+				break;
+			}
+
+			vkFreeCommandBuffers(logicalDevice, GetCommandPool(QueueType::GRAPHICS), 1, &followUp.commandBuffer);
+
+			vkResetFences(logicalDevice, 1, &followUp.fence);
+			freeFences.push_back(followUp.fence);
+
+			followUps.pop_front();
+		}
+	}
+
+	VkFence StagingRing::AcquireFence()
+	{
+		if (!freeFences.empty())
+		{
+			VkFence fence = freeFences.back();
+			freeFences.pop_back();
+			return fence;
+		}
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		VkFence fence = VK_NULL_HANDLE;
+		if (vkCreateFence(GetLogicalDevice(), &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+		{
+			LogError("Failed to create staging ring fence!");
+			return VK_NULL_HANDLE;
+		}
+
+		return fence;
+	}
+}
@@ -0,0 +1,144 @@
+#ifndef STAGING_RING_H
+#define STAGING_RING_H
+
+#include <deque>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "data_buffer/staging_buffer.h"
+#include "queue_types.h"
+
+namespace TANG
+{
+	// A range of the staging ring that host data can be written into. The range stays reserved until the submission that reads
+	// from it has completed on the GPU
+	struct StagingRegion
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+		void* mappedData = nullptr;		// Points to the start of the region
+	};
+
+	struct StagingRingStatistics
+	{
+		VkDeviceSize capacityBytes = 0;
+		VkDeviceSize usedBytes = 0;			// Bytes reserved by regions that are either waiting to be submitted or still in flight
+		uint32_t inFlightSubmissions = 0;
+		uint32_t stallCount = 0;			// Number of times an allocation had to wait for the GPU to free up space
+		uint64_t submittedValue = 0;		// Timeline value of the most recent submission
+		uint64_t completedValue = 0;		// Timeline value of the most recent submission known to have completed
+		uint32_t inFlightFollowUps = 0;		// Follow-up graphics submissions that haven't completed yet
+	};
+
+	// Single persistently-mapped staging buffer that every host-to-device upload goes through (see CONFIG::StagingRingSize), instead of
+	// creating a staging buffer per upload. Regions are handed out in order and wrap around at the end of the buffer. Every submission
+	// that reads from the ring is tracked with a fence, and the regions allocated before it are reclaimed once it's signaled. If the ring
+	// is full, allocations wait for the oldest submission to complete. Every submission is also given an increasing timeline value, which
+	// is how callers check whether an upload has completed without holding on to the fence (fences are recycled). Uploads should go through
+	// an UploadContext, which takes care of submitting and splitting uploads that don't fit. Must only be used from the render thread
+	class StagingRing
+	{
+	private:
+
+		StagingRing();
+		~StagingRing();
+
+	public:
+
+		// Singletons should not be assignable nor copyable
+		StagingRing(const StagingRing& other) = delete;
+		void operator=(const StagingRing& other) = delete;
+
+		static StagingRing& GetInstance()
+		{
+			static StagingRing instance;
+			return instance;
+		}
+
+		// Creates the ring buffer. Must be called after the DeviceAllocator is created
+		void Create(VkDeviceSize size);
+
+		// Waits for every submission that reads from the ring, and destroys the ring buffer. Must be called before the logical device is destroyed
+		void Destroy();
+
+		// Reserves a region with an offset that is a multiple of the alignment, waiting for in-flight submissions if needed. Returns false if
+		// the region is larger than the ring, or if the space is held by regions that haven't been submitted yet
+		bool Allocate(VkDeviceSize size, VkDeviceSize alignment, StagingRegion& outRegion);
+
+		// Ends and submits the command buffer on the provided queue, along with a fence that reclaims every region allocated since the
+		// previous submission once it's signaled. The ring takes ownership of the command buffer, which must have been allocated from the
+		// queue's command pool, and frees it after it has executed. If a follow-up command buffer (allocated from the GRAPHICS pool) is
+		// provided, it's submitted on the graphics queue once the first one has completed. This is how ownership of resources uploaded on a
+		// dedicated transfer queue is acquired by the graphics queue, without the graphics queue ever waiting on the transfer queue.
+		// Returns the timeline value of the submission, or zero if it failed
+		uint64_t Submit(QueueType type, VkCommandBuffer commandBuffer, VkCommandBuffer followUpCommandBuffer = VK_NULL_HANDLE);
+
+		// Reclaims every completed submission and submits their follow-ups. Should be called once per frame before the frame is recorded,
+		// so finished uploads are handed over to the graphics queue ahead of the frame that first uses them
+		void Update();
+
+		// Returns whether the submission with the provided timeline value (and every submission before it) has completed. Zero is always complete.
+		// Once complete, the follow-up of the submission has been submitted, so any later submission on the graphics queue can use the resources
+		bool IsComplete(uint64_t value);
+
+		// Waits until the submission with the provided timeline value and its follow-up have completed, and reclaims it's regions
+		void Wait(uint64_t value);
+
+		VkDeviceSize GetCapacity() const;
+
+		StagingRingStatistics GetStatistics() const;
+
+	private:
+
+		struct Submission
+		{
+			VkDeviceSize bytes;					// Bytes reserved since the previous submission, including the padding and any space skipped when wrapping around
+			VkFence fence;
+			uint64_t value;
+			QueueType type;
+			VkCommandBuffer commandBuffer;
+			VkCommandBuffer followUpCommandBuffer;
+		};
+
+		struct FollowUp
+		{
+			VkFence fence;
+			uint64_t value;						// Timeline value of the submission this follows
+			VkCommandBuffer commandBuffer;
+		};
+
+		// Returns the offset of the region, or the capacity if it doesn't fit in the free space. Also returns how many bytes it would consume
+		VkDeviceSize FindRegion(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outConsumedBytes) const;
+
+		// Reclaims the regions of every submission that has completed, and submits their follow-ups. If wait is true, waits for the oldest
+		// submission first
+		void Reclaim(bool wait);
+
+		void SubmitFollowUp(const Submission& submission);
+
+		// Frees the command buffers of every follow-up that has completed. If wait is true, waits for the follow-ups of every submission
+		// up to the provided timeline value first
+		void ReclaimFollowUps(bool wait, uint64_t value);
+
+		VkFence AcquireFence();
+
+		StagingBuffer buffer;
+		VkDeviceSize capacity;
+		VkDeviceSize head;						// Where the next region starts
+		VkDeviceSize tail;						// Where the oldest reserved region starts
+		VkDeviceSize usedBytes;
+		VkDeviceSize pendingBytes;				// Bytes reserved since the last submission
+
+		std::deque<Submission> submissions;
+		std::deque<FollowUp> followUps;
+		std::vector<VkFence> freeFences;
+
+		uint32_t stallCount;
+		uint64_t submittedValue;
+		uint64_t completedValue;
+	};
+}
+
+#endif
@@ -2,6 +2,7 @@
 #include <cstdarg>
 
 #include "asset_loader.h"
+#include "async_asset_loader.h"
 #include "camera/freefly_camera.h"
 #include "config.h"
 #include "renderer.h"
@@ -25,6 +26,35 @@ static TANG::CorePipeline GetCorePipelineFromFilePath(const std::string& filePat
 	}
 }
 
+// Registers an asset that was loaded from disk and creates it's renderer resources. This must be called from the main thread,
+// regardless of whether the asset was loaded synchronously or through the asynchronous loader
+static TANG::UUID FinalizeAssetLoad(TANG::AssetDisk* asset)
+{
+	TANG::LoaderUtils::Register(asset);
+
+	// TODO - Find a better way to determine which pipeline type to use
+	TANG::CorePipeline corePipeline = GetCorePipelineFromFilePath(asset->name);
+
+	TANG::AssetResources* resources = TANG::Renderer::GetInstance().CreateAssetResources(asset, corePipeline);
+	if (resources == nullptr)
+	{
+		TANG::LogError("Failed to create asset resources for asset '%s'", asset->name.c_str());
+
+		// Nothing can refer to the asset without a UUID, so it's unloaded right away instead of staying registered with it's data alive
+		TANG::LoaderUtils::Unload(asset->uuid);
+		return TANG::INVALID_UUID;
+	}
+
+	// The data was copied into the staging ring when the uploads were recorded, so the CPU-side copies are only taking up memory
+	// even if the GPU hasn't finished uploading it yet
+	if (TANG::CONFIG::ReleaseCPUAssetDataAfterUpload)
+	{
+		TANG::LoaderUtils::ReleaseCPUData(asset->uuid);
+	}
+
+	return asset->uuid;
+}
+
 namespace TANG
 {
 	// Let's make extra sure our conversions from float* to glm::vec3 for asset transforms below
@@ -49,6 +79,7 @@ namespace TANG
 		InputManager::GetInstance().Initialize(window.GetHandle());
 		renderer.Initialize(window.GetHandle(), CONFIG::WindowWidth, CONFIG::WindowHeight);
 		camera.Initialize({ 0.0f, 5.0f, 15.0f }, { 0.0f, 0.0f, 0.0f }); // Start the camera facing towards negative Z
+		AsyncAssetLoader::GetInstance().Initialize(CONFIG::AssetLoaderThreadCount);
 
 		// Load core assets
 		LoadAsset(CONFIG::FullscreenQuadMeshFilePath.c_str());
@@ -87,6 +118,13 @@ namespace TANG
 			renderer.SetNextFramebufferSize(width, height);
 		}
 
+		// Create the renderer resources for any assets that finished loading in the background. Their uploads are submitted together on the
+		// transfer queue, and the assets start drawing on the first frame after the upload completes. Only a few are finalized per frame,
+		// so a burst of completed loads doesn't cause a hitch
+		renderer.BeginUploadBatch();
+		AsyncAssetLoader::GetInstance().ProcessCompletedLoads(FinalizeAssetLoad, CONFIG::MaxAsyncAssetFinalizesPerFrame);
+		renderer.EndUploadBatch();
+
 		// Update the camera data that the renderer is holding with the most up-to-date info
 		renderer.UpdateCameraData(camera.GetPosition(), camera.GetViewMatrix());
 
@@ -101,6 +139,7 @@ namespace TANG
 	void Shutdown()
 	{
 		camera.Shutdown();
+		AsyncAssetLoader::GetInstance().Shutdown();
 		LoaderUtils::UnloadAll();
 		Renderer::GetInstance().Shutdown();
 		MainWindow::Get().Destroy();
@@ -130,27 +169,41 @@ namespace TANG
 
 	UUID LoadAsset(const char* filepath)
 	{
-		Renderer& renderer = Renderer::GetInstance();
-
-		AssetDisk* asset = LoaderUtils::Load(filepath);
-		// If Load() returns nullptr, we know it didn't allocate memory on the heap, so no need to de-allocate anything here
+		AssetDisk* asset = LoaderUtils::LoadFromDisk(filepath);
+		// If LoadFromDisk() returns nullptr, we know it didn't allocate memory on the heap, so no need to de-allocate anything here
 		if (asset == nullptr)
 		{
 			LogError("Failed to load asset '%s'", filepath);
 			return INVALID_UUID;
 		}
 
-		// TODO - Find a better way to determine which pipeline type to use
-		CorePipeline corePipeline = GetCorePipelineFromFilePath(std::string(filepath));
+		return FinalizeAssetLoad(asset);
+	}
 
-		AssetResources* resources = renderer.CreateAssetResources(asset, corePipeline);
-		if (resources == nullptr)
-		{
-			LogError("Failed to create asset resources for asset '%s'", filepath);
-			return INVALID_UUID;
-		}
+	AssetLoadHandle LoadAssetAsync(const char* filepath)
+	{
+		TNG_ASSERT_MSG(filepath != nullptr, "Filepath cannot be null!");
+		return AsyncAssetLoader::GetInstance().Submit(filepath);
+	}
+
+	AssetLoadState GetAssetLoadState(AssetLoadHandle handle)
+	{
+		return AsyncAssetLoader::GetInstance().GetState(handle);
+	}
 
-		return asset->uuid;
+	UUID GetLoadedAssetUUID(AssetLoadHandle handle)
+	{
+		return AsyncAssetLoader::GetInstance().GetUUID(handle);
+	}
+
+	bool CancelAssetLoad(AssetLoadHandle handle)
+	{
+		return AsyncAssetLoader::GetInstance().Cancel(handle);
+	}
+
+	void ReleaseAssetLoadHandle(AssetLoadHandle handle)
+	{
+		AsyncAssetLoader::GetInstance().Release(handle);
 	}
 
 	void SetCameraSpeed(float speed)
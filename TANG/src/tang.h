@@ -26,8 +26,9 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-#include "utils/uuid.h"    // TANG::UUID
-#include "input_manager.h" // TANG::KeyState
+#include "utils/uuid.h"          // TANG::UUID
+#include "input_manager.h"       // TANG::KeyState
+#include "async_asset_loader.h"  // TANG::AssetLoadHandle, TANG::AssetLoadState
 
 namespace TANG
 {
@@ -76,6 +77,24 @@ namespace TANG
 	// load the TASSET file directly
 	UUID LoadAsset(const char* filepath);
 
+	// Starts loading an asset in the background and returns immediately. Importing the asset and decoding it's textures
+	// happens on worker threads, while the renderer resources are created during a later Update() call. Use GetAssetLoadState()
+	// to poll for completion, and GetLoadedAssetUUID() to retrieve the asset UUID once the state is READY
+	AssetLoadHandle LoadAssetAsync(const char* filepath);
+
+	// Returns the current state of the asynchronous load. Invalid or released handles return AssetLoadState::INVALID
+	AssetLoadState GetAssetLoadState(AssetLoadHandle handle);
+
+	// Returns the UUID of an asset loaded through LoadAssetAsync(). This returns INVALID_UUID until the load is READY
+	UUID GetLoadedAssetUUID(AssetLoadHandle handle);
+
+	// Cancels an asynchronous load. Returns false if the load had already finished, failed or doesn't exist
+	bool CancelAssetLoad(AssetLoadHandle handle);
+
+	// Releases the load handle once it's no longer needed. Releasing an in-flight load cancels it, but releasing a
+	// READY load does NOT unload the asset
+	void ReleaseAssetLoadHandle(AssetLoadHandle handle);
+
 	// Sets the speed of the primary camera
 	void SetCameraSpeed(float speed);
 
@@ -0,0 +1,903 @@
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+#include <glm/gtc/packing.hpp>
+
+#include "texture_compression.h"
+#include "utils/logger.h"
+#include "utils/sanity_check.h"
+#include "utils/thread_pool.h"
+
+namespace TANG
+{
+	static constexpr uint32_t BLOCK_SIZE_BYTES = 16;
+	static constexpr uint32_t BLOCK_TEXEL_COUNT = 16;
+
+	// Number of block rows that are encoded per thread pool job
+	static constexpr uint32_t BLOCK_ROWS_PER_JOB = 8;
+
+	// Interpolation weights for 4-bit indices, shared between BC6H and BC7
+	static constexpr uint32_t WEIGHTS_4BIT[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Writes values into a block starting at the least significant bit of the first byte, which is how all the BCn formats
+	// lay out their fields. The block must be zeroed beforehand
+	struct BlockWriter
+	{
+		uint8_t* block;
+		uint32_t bit;
+
+		void Write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t i = 0; i < bitCount; i++, bit++)
+			{
+				if ((value >> i) & 1)
+				{
+					block[bit >> 3] |= static_cast<uint8_t>(1 << (bit & 7));
+				}
+			}
+		}
+	};
+
+	// Finds the principal axis of the texels through power iteration on their covariance matrix. Returns false if
+	// all the texels are identical, in which case any axis works
+	template<uint32_t N>
+	static bool FindPrincipalAxis(const float (*texels)[N], float* outMean, float* outAxis)
+	{
+		float minValue[N], maxValue[N];
+		for (uint32_t c = 0; c < N; c++)
+		{
+			outMean[c] = 0.0f;
+			minValue[c] = texels[0][c];
+			maxValue[c] = texels[0][c];
+		}
+
+		for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+		{
+			for (uint32_t c = 0; c < N; c++)
+			{
+				outMean[c] += texels[i][c];
+				minValue[c] = std::min(minValue[c], texels[i][c]);
+				maxValue[c] = std::max(maxValue[c], texels[i][c]);
+			}
+		}
+
+		for (uint32_t c = 0; c < N; c++)
+		{
+			outMean[c] /= static_cast<float>(BLOCK_TEXEL_COUNT);
+		}
+
+		float covariance[N][N] = {};
+		for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+		{
+			for (uint32_t a = 0; a < N; a++)
+			{
+				for (uint32_t b = 0; b < N; b++)
+				{
+					covariance[a][b] += (texels[i][a] - outMean[a]) * (texels[i][b] - outMean[b]);
+				}
+			}
+		}
+
+		// Start from the bounding box diagonal, which is usually close to the principal axis already
+		float length = 0.0f;
+		for (uint32_t c = 0; c < N; c++)
+		{
+			outAxis[c] = maxValue[c] - minValue[c];
+			length += outAxis[c] * outAxis[c];
+		}
+
+		if (length <= 0.0f)
+		{
+			return false;
+		}
+
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[N] = {};
+			for (uint32_t a = 0; a < N; a++)
+			{
+				for (uint32_t b = 0; b < N; b++)
+				{
+					next[a] += covariance[a][b] * outAxis[b];
+				}
+			}
+
+			length = 0.0f;
+			for (uint32_t c = 0; c < N; c++)
+			{
+				length += next[c] * next[c];
+			}
+
+			if (length <= 0.0f)
+			{
+				break;
+			}
+
+			float inverseLength = 1.0f / std::sqrt(length);
+			for (uint32_t c = 0; c < N; c++)
+			{
+				outAxis[c] = next[c] * inverseLength;
+			}
+		}
+
+		return true;
+	}
+
+	// Finds the endpoints at either end of the texels' projection onto the principal axis
+	template<uint32_t N>
+	static void FindEndpoints(const float (*texels)[N], float* outEndpoint0, float* outEndpoint1)
+	{
+		float mean[N], axis[N];
+		if (!FindPrincipalAxis<N>(texels, mean, axis))
+		{
+			memcpy(outEndpoint0, mean, sizeof(mean));
+			memcpy(outEndpoint1, mean, sizeof(mean));
+			return;
+		}
+
+		float minProjection = 0.0f;
+		float maxProjection = 0.0f;
+		for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+		{
+			float projection = 0.0f;
+			for (uint32_t c = 0; c < N; c++)
+			{
+				projection += (texels[i][c] - mean[c]) * axis[c];
+			}
+
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
+
+		for (uint32_t c = 0; c < N; c++)
+		{
+			outEndpoint0[c] = mean[c] + axis[c] * minProjection;
+			outEndpoint1[c] = mean[c] + axis[c] * maxProjection;
+		}
+	}
+
+	// Least-squares fit of the endpoints for the texels' current 4-bit indices. Returns false if the system is degenerate,
+	// which happens when every texel uses the same index
+	template<uint32_t N>
+	static bool RefineEndpoints(const float (*texels)[N], const uint32_t* indices, float* outEndpoint0, float* outEndpoint1)
+	{
+		float a = 0.0f, b = 0.0f, c = 0.0f;
+		float x0[N] = {}, x1[N] = {};
+		for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+		{
+			float w = static_cast<float>(WEIGHTS_4BIT[indices[i]]) / 64.0f;
+			float iw = 1.0f - w;
+
+			a += iw * iw;
+			b += iw * w;
+			c += w * w;
+			for (uint32_t ch = 0; ch < N; ch++)
+			{
+				x0[ch] += iw * texels[i][ch];
+				x1[ch] += w * texels[i][ch];
+			}
+		}
+
+		float determinant = a * c - b * b;
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		float inverseDeterminant = 1.0f / determinant;
+		for (uint32_t ch = 0; ch < N; ch++)
+		{
+			outEndpoint0[ch] = (c * x0[ch] - b * x1[ch]) * inverseDeterminant;
+			outEndpoint1[ch] = (a * x1[ch] - b * x0[ch]) * inverseDeterminant;
+		}
+
+		return true;
+	}
+
+	//////////////////////////////////////////////////
+	//
+	//	BC7
+	//
+	//////////////////////////////////////////////////
+
+	struct BC7Endpoints
+	{
+		uint32_t quantized[2][4];	// 7-bit values
+		uint32_t pBits[2];
+	};
+
+	// Quantizes an endpoint to 7 bits per channel plus the shared p-bit, picking whichever p-bit reproduces the endpoint best
+	static void QuantizeBC7Endpoint(const float* endpoint, uint32_t* outQuantized, uint32_t& outPBit)
+	{
+		float bestError = std::numeric_limits<float>::max();
+		for (uint32_t p = 0; p < 2; p++)
+		{
+			uint32_t quantized[4];
+			float error = 0.0f;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				float value = std::clamp(endpoint[c], 0.0f, 255.0f);
+				int32_t q = static_cast<int32_t>(std::lround((value - static_cast<float>(p)) * 0.5f));
+				quantized[c] = static_cast<uint32_t>(std::clamp(q, 0, 127));
+
+				float difference = static_cast<float>((quantized[c] << 1) | p) - value;
+				error += difference * difference;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				outPBit = p;
+				memcpy(outQuantized, quantized, sizeof(quantized));
+			}
+		}
+	}
+
+	// Picks the closest palette entry for every texel, and returns the total squared error
+	static uint32_t SelectBC7Indices(const float (*texels)[4], const BC7Endpoints& endpoints, uint32_t* outIndices)
+	{
+		uint32_t expanded[2][4];
+		for (uint32_t e = 0; e < 2; e++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				expanded[e][c] = (endpoints.quantized[e][c] << 1) | endpoints.pBits[e];
+			}
+		}
+
+		int32_t palette[16][4];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				palette[i][c] = static_cast<int32_t>(((64 - WEIGHTS_4BIT[i]) * expanded[0][c] + WEIGHTS_4BIT[i] * expanded[1][c] + 32) >> 6);
+			}
+		}
+
+		uint32_t totalError = 0;
+		for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+		{
+			uint32_t bestError = 0xFFFFFFFF;
+			for (uint32_t p = 0; p < 16; p++)
+			{
+				uint32_t error = 0;
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					int32_t difference = palette[p][c] - static_cast<int32_t>(texels[i][c]);
+					error += static_cast<uint32_t>(difference * difference);
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					outIndices[i] = p;
+				}
+			}
+
+			totalError += bestError;
+		}
+
+		return totalError;
+	}
+
+	static uint32_t FitBC7Endpoints(const float (*texels)[4], const float* endpoint0, const float* endpoint1, BC7Endpoints& outEndpoints, uint32_t* outIndices)
+	{
+		QuantizeBC7Endpoint(endpoint0, outEndpoints.quantized[0], outEndpoints.pBits[0]);
+		QuantizeBC7Endpoint(endpoint1, outEndpoints.quantized[1], outEndpoints.pBits[1]);
+		return SelectBC7Indices(texels, outEndpoints, outIndices);
+	}
+
+	//////////////////////////////////////////////////
+	//
+	//	BC6H
+	//
+	//////////////////////////////////////////////////
+
+	static constexpr uint32_t BC6H_ENDPOINT_BITS = 10;
+	static constexpr uint32_t BC6H_ENDPOINT_MAX = (1 << BC6H_ENDPOINT_BITS) - 1;
+
+	// Converts a quantized endpoint into the 16-bit space that the hardware interpolates in
+	static int32_t UnquantizeBC6H(uint32_t quantized)
+	{
+		if (quantized == 0) return 0;
+		if (quantized == BC6H_ENDPOINT_MAX) return 0xFFFF;
+		return static_cast<int32_t>(((quantized << 16) + 0x8000) >> BC6H_ENDPOINT_BITS);
+	}
+
+	// Inverse of the "finish unquantize" step, which maps the interpolated value onto the bits of an unsigned half float
+	static float HalfBitsToInterpolationSpace(uint32_t halfBits)
+	{
+		return static_cast<float>(halfBits) * (64.0f / 31.0f);
+	}
+
+	static uint32_t QuantizeBC6H(float value)
+	{
+		int32_t quantized = static_cast<int32_t>(std::lround((value - 32.0f) / 64.0f));
+		return static_cast<uint32_t>(std::clamp(quantized, 0, static_cast<int32_t>(BC6H_ENDPOINT_MAX)));
+	}
+
+	// The error is measured on the half float bits, which is roughly logarithmic and matches how the format is decoded
+	static uint64_t SelectBC6HIndices(const uint32_t (*halfTexels)[3], const uint32_t (*quantized)[3], uint32_t* outIndices)
+	{
+		int32_t palette[16][3];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				int32_t a = UnquantizeBC6H(quantized[0][c]);
+				int32_t b = UnquantizeBC6H(quantized[1][c]);
+				int32_t interpolated = ((64 - static_cast<int32_t>(WEIGHTS_4BIT[i])) * a + static_cast<int32_t>(WEIGHTS_4BIT[i]) * b + 32) >> 6;
+				palette[i][c] = (interpolated * 31) >> 6;
+			}
+		}
+
+		uint64_t totalError = 0;
+		for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+		{
+			uint64_t bestError = UINT64_MAX;
+			for (uint32_t p = 0; p < 16; p++)
+			{
+				uint64_t error = 0;
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					int64_t difference = palette[p][c] - static_cast<int64_t>(halfTexels[i][c]);
+					error += static_cast<uint64_t>(difference * difference);
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					outIndices[i] = p;
+				}
+			}
+
+			totalError += bestError;
+		}
+
+		return totalError;
+	}
+
+	//////////////////////////////////////////////////
+	//
+	//	MIP GENERATION
+	//
+	//////////////////////////////////////////////////
+
+	enum class FilterMode
+	{
+		LINEAR,
+		SRGB,
+		NORMAL_MAP
+	};
+
+	static float SRGBToLinear(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	static float LinearToSRGB(float value)
+	{
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	static uint8_t ToUnorm8(float value)
+	{
+		return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+	}
+
+	// 2x2 box filter, odd dimensions simply clamp the second texel to the edge
+	static void DownsampleRGBA8(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight, uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight, FilterMode mode)
+	{
+		static float srgbToLinear[256];
+		static bool isTableInitialized = [] {
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				srgbToLinear[i] = SRGBToLinear(static_cast<float>(i) / 255.0f);
+			}
+			return true;
+		}();
+		(void)isTableInitialized;
+
+		for (uint32_t y = 0; y < dstHeight; y++)
+		{
+			uint32_t y0 = std::min(y * 2, srcHeight - 1);
+			uint32_t y1 = std::min(y * 2 + 1, srcHeight - 1);
+
+			for (uint32_t x = 0; x < dstWidth; x++)
+			{
+				uint32_t x0 = std::min(x * 2, srcWidth - 1);
+				uint32_t x1 = std::min(x * 2 + 1, srcWidth - 1);
+
+				const uint8_t* samples[4] = {
+					src + (static_cast<size_t>(y0) * srcWidth + x0) * 4,
+					src + (static_cast<size_t>(y0) * srcWidth + x1) * 4,
+					src + (static_cast<size_t>(y1) * srcWidth + x0) * 4,
+					src + (static_cast<size_t>(y1) * srcWidth + x1) * 4
+				};
+
+				uint8_t* out = dst + (static_cast<size_t>(y) * dstWidth + x) * 4;
+
+				float sum[4] = {};
+				for (const uint8_t* sample : samples)
+				{
+					for (uint32_t c = 0; c < 4; c++)
+					{
+						if (mode == FilterMode::SRGB && c < 3)
+						{
+							sum[c] += srgbToLinear[sample[c]];
+						}
+						else if (mode == FilterMode::NORMAL_MAP && c < 3)
+						{
+							sum[c] += static_cast<float>(sample[c]) / 127.5f - 1.0f;
+						}
+						else
+						{
+							sum[c] += static_cast<float>(sample[c]) / 255.0f;
+						}
+					}
+				}
+
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					sum[c] *= 0.25f;
+				}
+
+				if (mode == FilterMode::SRGB)
+				{
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						sum[c] = LinearToSRGB(sum[c]);
+					}
+				}
+				else if (mode == FilterMode::NORMAL_MAP)
+				{
+					float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+					float inverseLength = length > 0.0f ? 1.0f / length : 0.0f;
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						sum[c] = sum[c] * inverseLength * 0.5f + 0.5f;
+					}
+				}
+
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					out[c] = ToUnorm8(sum[c]);
+				}
+			}
+		}
+	}
+
+	static void DownsampleRGBA32F(const float* src, uint32_t srcWidth, uint32_t srcHeight, float* dst, uint32_t dstWidth, uint32_t dstHeight)
+	{
+		for (uint32_t y = 0; y < dstHeight; y++)
+		{
+			uint32_t y0 = std::min(y * 2, srcHeight - 1);
+			uint32_t y1 = std::min(y * 2 + 1, srcHeight - 1);
+
+			for (uint32_t x = 0; x < dstWidth; x++)
+			{
+				uint32_t x0 = std::min(x * 2, srcWidth - 1);
+				uint32_t x1 = std::min(x * 2 + 1, srcWidth - 1);
+
+				float* out = dst + (static_cast<size_t>(y) * dstWidth + x) * 4;
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					out[c] = 0.25f * (src[(static_cast<size_t>(y0) * srcWidth + x0) * 4 + c] + src[(static_cast<size_t>(y0) * srcWidth + x1) * 4 + c] +
+						src[(static_cast<size_t>(y1) * srcWidth + x0) * 4 + c] + src[(static_cast<size_t>(y1) * srcWidth + x1) * 4 + c]);
+				}
+			}
+		}
+	}
+
+	// Encodes every block of a single mip level. Blocks that hang over the edge of the image replicate the edge texels
+	template<typename T>
+	static void EncodeMip(const T* pixels, uint32_t width, uint32_t height, uint8_t* outData, const std::function<void(const T*, uint8_t*)>& encodeBlock, ThreadPool* threadPool)
+	{
+		uint32_t blocksX = (width + 3) / 4;
+		uint32_t blocksY = (height + 3) / 4;
+
+		auto encodeRows = [=, &encodeBlock](uint32_t firstRow, uint32_t lastRow)
+		{
+			T texels[BLOCK_TEXEL_COUNT * 4];
+			for (uint32_t by = firstRow; by < lastRow; by++)
+			{
+				for (uint32_t bx = 0; bx < blocksX; bx++)
+				{
+					for (uint32_t ty = 0; ty < 4; ty++)
+					{
+						uint32_t y = std::min(by * 4 + ty, height - 1);
+						for (uint32_t tx = 0; tx < 4; tx++)
+						{
+							uint32_t x = std::min(bx * 4 + tx, width - 1);
+							memcpy(&texels[(ty * 4 + tx) * 4], &pixels[(static_cast<size_t>(y) * width + x) * 4], sizeof(T) * 4);
+						}
+					}
+
+					encodeBlock(texels, outData + (static_cast<size_t>(by) * blocksX + bx) * BLOCK_SIZE_BYTES);
+				}
+			}
+		};
+
+		if (threadPool == nullptr || blocksY <= BLOCK_ROWS_PER_JOB)
+		{
+			encodeRows(0, blocksY);
+			return;
+		}
+
+		ThreadPool::JobGroup jobGroup = threadPool->CreateJobGroup();
+
+		std::vector<std::future<void>> futures;
+		for (uint32_t row = 0; row < blocksY; row += BLOCK_ROWS_PER_JOB)
+		{
+			uint32_t lastRow = std::min(row + BLOCK_ROWS_PER_JOB, blocksY);
+			futures.push_back(threadPool->Submit([&encodeRows, row, lastRow]() { encodeRows(row, lastRow); }, jobGroup));
+		}
+
+		for (std::future<void>& future : futures)
+		{
+			threadPool->Wait(future, jobGroup);
+		}
+	}
+
+	// Allocates the compressed data for the whole mip chain, and fills out the mip offsets
+	static void AllocateMipChain(VkFormat format, uint32_t width, uint32_t height, uint32_t mipCount, CompressedImage& out)
+	{
+		out.format = format;
+		out.width = width;
+		out.height = height;
+		out.mipOffsets.resize(mipCount);
+
+		uint64_t totalSize = 0;
+		for (uint32_t i = 0; i < mipCount; i++)
+		{
+			out.mipOffsets[i] = totalSize;
+			totalSize += TextureCompression::CalculateMipSize(format, std::max(width >> i, 1u), std::max(height >> i, 1u));
+		}
+
+		out.data.assign(totalSize, 0);
+	}
+
+	namespace TextureCompression
+	{
+		bool IsBlockCompressed(VkFormat format)
+		{
+			switch (format)
+			{
+			case VK_FORMAT_BC5_UNORM_BLOCK:
+			case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+			case VK_FORMAT_BC7_UNORM_BLOCK:
+			case VK_FORMAT_BC7_SRGB_BLOCK:
+				return true;
+			default:
+				break;
+			}
+
+			return false;
+		}
+
+		uint64_t CalculateMipSize(VkFormat format, uint32_t width, uint32_t height)
+		{
+			if (IsBlockCompressed(format))
+			{
+				return static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4) * BLOCK_SIZE_BYTES;
+			}
+
+			return static_cast<uint64_t>(width) * height * GetChannelCount(format);
+		}
+
+		uint32_t GetChannelCount(VkFormat format)
+		{
+			switch (format)
+			{
+			case VK_FORMAT_R8_UNORM:
+				return 1;
+			case VK_FORMAT_R8G8_UNORM:
+				return 2;
+			default:
+				break;
+			}
+
+			return 4;
+		}
+
+		uint32_t CalculateMipCount(uint32_t width, uint32_t height)
+		{
+			return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+		}
+
+		void EncodeBC7Block(const uint8_t* texels, uint8_t* outBlock)
+		{
+			float values[BLOCK_TEXEL_COUNT][4];
+			for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+			{
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					values[i][c] = static_cast<float>(texels[i * 4 + c]);
+				}
+			}
+
+			float endpoint0[4], endpoint1[4];
+			FindEndpoints<4>(values, endpoint0, endpoint1);
+
+			BC7Endpoints endpoints;
+			uint32_t indices[BLOCK_TEXEL_COUNT];
+			uint32_t error = FitBC7Endpoints(values, endpoint0, endpoint1, endpoints, indices);
+
+			// A single least-squares pass on top of the principal axis fit recovers most of the quality of an exhaustive search
+			if (error > 0 && RefineEndpoints<4>(values, indices, endpoint0, endpoint1))
+			{
+				BC7Endpoints refinedEndpoints;
+				uint32_t refinedIndices[BLOCK_TEXEL_COUNT];
+				uint32_t refinedError = FitBC7Endpoints(values, endpoint0, endpoint1, refinedEndpoints, refinedIndices);
+				if (refinedError < error)
+				{
+					endpoints = refinedEndpoints;
+					memcpy(indices, refinedIndices, sizeof(indices));
+				}
+			}
+
+			// The most significant bit of the first index is implicitly zero, so we swap the endpoints if that's not the case
+			if (indices[0] >= 8)
+			{
+				std::swap(endpoints.quantized[0], endpoints.quantized[1]);
+				std::swap(endpoints.pBits[0], endpoints.pBits[1]);
+				for (uint32_t& index : indices)
+				{
+					index = 15 - index;
+				}
+			}
+
+			memset(outBlock, 0, BLOCK_SIZE_BYTES);
+			BlockWriter writer{ outBlock, 0 };
+			writer.Write(1 << 6, 7); // Mode 6
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				writer.Write(endpoints.quantized[0][c], 7);
+				writer.Write(endpoints.quantized[1][c], 7);
+			}
+			writer.Write(endpoints.pBits[0], 1);
+			writer.Write(endpoints.pBits[1], 1);
+			for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+			{
+				writer.Write(indices[i], i == 0 ? 3 : 4);
+			}
+
+			TNG_ASSERT_MSG(writer.bit == 128, "Wrote an invalid number of bits for BC7 block!");
+		}
+
+		void EncodeBC5Block(const uint8_t* texels, uint8_t* outBlock)
+		{
+			memset(outBlock, 0, BLOCK_SIZE_BYTES);
+
+			// Each channel is a separate BC4 block. Using the larger value as the first endpoint selects the 8-value mode
+			for (uint32_t channel = 0; channel < 2; channel++)
+			{
+				uint8_t* block = outBlock + channel * 8;
+
+				uint32_t minValue = 255;
+				uint32_t maxValue = 0;
+				for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+				{
+					minValue = std::min<uint32_t>(minValue, texels[i * 4 + channel]);
+					maxValue = std::max<uint32_t>(maxValue, texels[i * 4 + channel]);
+				}
+
+				block[0] = static_cast<uint8_t>(maxValue);
+				block[1] = static_cast<uint8_t>(minValue);
+				if (maxValue == minValue)
+				{
+					// Every index is zero, which is the first endpoint
+					continue;
+				}
+
+				float palette[8];
+				palette[0] = static_cast<float>(maxValue);
+				palette[1] = static_cast<float>(minValue);
+				for (uint32_t i = 2; i < 8; i++)
+				{
+					palette[i] = static_cast<float>((8 - i) * maxValue + (i - 1) * minValue) / 7.0f;
+				}
+
+				BlockWriter writer{ block, 16 };
+				for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+				{
+					float value = static_cast<float>(texels[i * 4 + channel]);
+
+					uint32_t bestIndex = 0;
+					float bestError = std::numeric_limits<float>::max();
+					for (uint32_t p = 0; p < 8; p++)
+					{
+						float error = std::abs(palette[p] - value);
+						if (error < bestError)
+						{
+							bestError = error;
+							bestIndex = p;
+						}
+					}
+
+					writer.Write(bestIndex, 3);
+				}
+			}
+		}
+
+		void EncodeBC6HBlock(const float* texels, uint8_t* outBlock)
+		{
+			// Unsigned half floats are monotonic in their bit patterns, so we work with the bits directly
+			uint32_t halfTexels[BLOCK_TEXEL_COUNT][3];
+			float values[BLOCK_TEXEL_COUNT][3];
+			for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					float value = texels[i * 4 + c];
+					value = (value > 0.0f) ? std::min(value, 65504.0f) : 0.0f; // Also flushes NaNs to zero
+
+					halfTexels[i][c] = glm::packHalf1x16(value);
+					values[i][c] = HalfBitsToInterpolationSpace(halfTexels[i][c]);
+				}
+			}
+
+			float endpoint0[3], endpoint1[3];
+			FindEndpoints<3>(values, endpoint0, endpoint1);
+
+			uint32_t quantized[2][3];
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				quantized[0][c] = QuantizeBC6H(endpoint0[c]);
+				quantized[1][c] = QuantizeBC6H(endpoint1[c]);
+			}
+
+			uint32_t indices[BLOCK_TEXEL_COUNT];
+			uint64_t error = SelectBC6HIndices(halfTexels, quantized, indices);
+
+			if (error > 0 && RefineEndpoints<3>(values, indices, endpoint0, endpoint1))
+			{
+				uint32_t refinedQuantized[2][3];
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					refinedQuantized[0][c] = QuantizeBC6H(endpoint0[c]);
+					refinedQuantized[1][c] = QuantizeBC6H(endpoint1[c]);
+				}
+
+				uint32_t refinedIndices[BLOCK_TEXEL_COUNT];
+				uint64_t refinedError = SelectBC6HIndices(halfTexels, refinedQuantized, refinedIndices);
+				if (refinedError < error)
+				{
+					memcpy(quantized, refinedQuantized, sizeof(quantized));
+					memcpy(indices, refinedIndices, sizeof(indices));
+				}
+			}
+
+			// Same as BC7, the most significant bit of the first index is implicitly zero
+			if (indices[0] >= 8)
+			{
+				std::swap(quantized[0], quantized[1]);
+				for (uint32_t& index : indices)
+				{
+					index = 15 - index;
+				}
+			}
+
+			memset(outBlock, 0, BLOCK_SIZE_BYTES);
+			BlockWriter writer{ outBlock, 0 };
+			writer.Write(0x03, 5); // Mode 11
+			for (uint32_t e = 0; e < 2; e++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					writer.Write(quantized[e][c], BC6H_ENDPOINT_BITS);
+				}
+			}
+			for (uint32_t i = 0; i < BLOCK_TEXEL_COUNT; i++)
+			{
+				writer.Write(indices[i], i == 0 ? 3 : 4);
+			}
+
+			TNG_ASSERT_MSG(writer.bit == 128, "Wrote an invalid number of bits for BC6H block!");
+		}
+
+		bool CompressImage(const uint8_t* pixels, uint32_t width, uint32_t height, VkFormat format, bool generateMips, CompressedImage& out, ThreadPool* threadPool)
+		{
+			if (pixels == nullptr || width == 0 || height == 0)
+			{
+				LogError("Failed to compress image, no image data was provided!");
+				return false;
+			}
+
+			std::function<void(const uint8_t*, uint8_t*)> encodeBlock;
+			FilterMode filterMode = FilterMode::LINEAR;
+			switch (format)
+			{
+			case VK_FORMAT_BC7_UNORM_BLOCK:
+				encodeBlock = EncodeBC7Block;
+				break;
+			case VK_FORMAT_BC7_SRGB_BLOCK:
+				encodeBlock = EncodeBC7Block;
+				filterMode = FilterMode::SRGB;
+				break;
+			case VK_FORMAT_BC5_UNORM_BLOCK:
+				encodeBlock = EncodeBC5Block;
+				filterMode = FilterMode::NORMAL_MAP;
+				break;
+			default:
+				LogError("Failed to compress image, unsupported format %u!", static_cast<uint32_t>(format));
+				return false;
+			}
+
+			uint32_t mipCount = generateMips ? CalculateMipCount(width, height) : 1;
+			AllocateMipChain(format, width, height, mipCount, out);
+
+			std::vector<uint8_t> currentMip;
+			std::vector<uint8_t> nextMip;
+			const uint8_t* mipPixels = pixels;
+			uint32_t mipWidth = width;
+			uint32_t mipHeight = height;
+
+			for (uint32_t i = 0; i < mipCount; i++)
+			{
+				EncodeMip<uint8_t>(mipPixels, mipWidth, mipHeight, out.data.data() + out.mipOffsets[i], encodeBlock, threadPool);
+
+				if (i + 1 < mipCount)
+				{
+					uint32_t nextWidth = std::max(mipWidth >> 1, 1u);
+					uint32_t nextHeight = std::max(mipHeight >> 1, 1u);
+
+					nextMip.resize(static_cast<size_t>(nextWidth) * nextHeight * 4);
+					DownsampleRGBA8(mipPixels, mipWidth, mipHeight, nextMip.data(), nextWidth, nextHeight, filterMode);
+
+					std::swap(currentMip, nextMip);
+					mipPixels = currentMip.data();
+					mipWidth = nextWidth;
+					mipHeight = nextHeight;
+				}
+			}
+
+			return true;
+		}
+
+		bool CompressHDRImage(const float* pixels, uint32_t width, uint32_t height, bool generateMips, CompressedImage& out, ThreadPool* threadPool)
+		{
+			if (pixels == nullptr || width == 0 || height == 0)
+			{
+				LogError("Failed to compress HDR image, no image data was provided!");
+				return false;
+			}
+
+			std::function<void(const float*, uint8_t*)> encodeBlock = EncodeBC6HBlock;
+
+			uint32_t mipCount = generateMips ? CalculateMipCount(width, height) : 1;
+			AllocateMipChain(VK_FORMAT_BC6H_UFLOAT_BLOCK, width, height, mipCount, out);
+
+			std::vector<float> currentMip;
+			std::vector<float> nextMip;
+			const float* mipPixels = pixels;
+			uint32_t mipWidth = width;
+			uint32_t mipHeight = height;
+
+			for (uint32_t i = 0; i < mipCount; i++)
+			{
+				EncodeMip<float>(mipPixels, mipWidth, mipHeight, out.data.data() + out.mipOffsets[i], encodeBlock, threadPool);
+
+				if (i + 1 < mipCount)
+				{
+					uint32_t nextWidth = std::max(mipWidth >> 1, 1u);
+					uint32_t nextHeight = std::max(mipHeight >> 1, 1u);
+
+					nextMip.resize(static_cast<size_t>(nextWidth) * nextHeight * 4);
+					DownsampleRGBA32F(mipPixels, mipWidth, mipHeight, nextMip.data(), nextWidth, nextHeight);
+
+					std::swap(currentMip, nextMip);
+					mipPixels = currentMip.data();
+					mipWidth = nextWidth;
+					mipHeight = nextHeight;
+				}
+			}
+
+			return true;
+		}
+	}
+}
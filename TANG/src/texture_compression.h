@@ -0,0 +1,61 @@
+#ifndef TEXTURE_COMPRESSION_H
+#define TEXTURE_COMPRESSION_H
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace TANG
+{
+	class ThreadPool;
+
+	// Block-compressed image with it's full mip chain stored back-to-back, starting with the largest mip
+	struct CompressedImage
+	{
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint64_t> mipOffsets;	// Offset of every mip level into data, the mip count is the size of this vector
+		std::vector<uint8_t> data;
+	};
+
+	// Import-time encoders for the BCn formats we upload material and skybox textures as. Every format works on 4x4 texel
+	// blocks that are encoded into 16 bytes. The encoders favour speed over quality, since they run when assets are imported
+	// for the first time, and are limited to a single partition:
+	//   BC7  - Mode 6 only (RGBA 7777 endpoints plus a p-bit, 4-bit indices). Used for albedo and the other material maps
+	//   BC5  - Two BC4 channels. Used for normal maps, which only store X and Y. Z is reconstructed in the shader
+	//   BC6H - Mode 11 only (unsigned, 10-bit endpoints, 4-bit indices). Used for the HDR skybox
+	namespace TextureCompression
+	{
+		bool IsBlockCompressed(VkFormat format);
+
+		// Returns the number of bytes a single mip level of the provided size takes up in the provided format. Non-compressed
+		// formats are assumed to be 8 bits per channel (see GetChannelCount())
+		uint64_t CalculateMipSize(VkFormat format, uint32_t width, uint32_t height);
+
+		// Returns the number of 8-bit channels of the non-compressed formats textures are loaded as. R8 and R8G8 are used
+		// for single and dual-channel textures, everything else is assumed to be RGBA8
+		uint32_t GetChannelCount(VkFormat format);
+
+		uint32_t CalculateMipCount(uint32_t width, uint32_t height);
+
+		// Encodes 16 RGBA8 texels (in row-major order) into a single BC7 block
+		void EncodeBC7Block(const uint8_t* texels, uint8_t* outBlock);
+
+		// Encodes the red and green channels of 16 RGBA8 texels (in row-major order) into a single BC5 block
+		void EncodeBC5Block(const uint8_t* texels, uint8_t* outBlock);
+
+		// Encodes the RGB channels of 16 RGBA32F texels (in row-major order) into a single BC6H unsigned block. Negative values are clamped to zero
+		void EncodeBC6HBlock(const float* texels, uint8_t* outBlock);
+
+		// Generates the mip chain of the RGBA8 image (if requested) and encodes every level into the provided format, which must be
+		// BC7 (UNORM or SRGB) or BC5. sRGB images are filtered in linear space, and BC5 images are treated as normal maps so the
+		// downsampled normals are renormalized. If a thread pool is provided, the blocks are encoded in parallel
+		bool CompressImage(const uint8_t* pixels, uint32_t width, uint32_t height, VkFormat format, bool generateMips, CompressedImage& out, ThreadPool* threadPool = nullptr);
+
+		// Same as above, but for RGBA32F images which are always encoded as BC6H
+		bool CompressHDRImage(const float* pixels, uint32_t width, uint32_t height, bool generateMips, CompressedImage& out, ThreadPool* threadPool = nullptr);
+	}
+}
+
+#endif
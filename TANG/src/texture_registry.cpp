@@ -0,0 +1,274 @@
+
+#include "asset_types.h"
+#include "config.h"
+#include "texture_registry.h"
+#include "texture_resource.h"
+#include "texture_streamer.h"
+#include "upload_context.h"
+#include "utils/logger.h"
+#include "utils/sanity_check.h"
+
+namespace TANG
+{
+	TextureRegistry::TextureRegistry()
+	{
+	}
+
+	TextureRegistry::~TextureRegistry()
+	{
+		if (!resources.empty())
+		{
+			LogWarning("Texture registry destroyed with %u texture resources still alive!", static_cast<uint32_t>(resources.size()));
+		}
+
+		// The decoded textures are plain CPU memory, so we can safely clean them up here
+		for (auto& iter : textures)
+		{
+			delete iter.second.texture;
+		}
+
+		textures.clear();
+	}
+
+	Texture* TextureRegistry::AcquireTexture(uint64_t contentHash, VkFormat format)
+	{
+		std::lock_guard<std::mutex> lock(texturesMutex);
+
+		auto iter = textures.find(GetKey(contentHash, format));
+		if (iter == textures.end())
+		{
+			return nullptr;
+		}
+
+		iter->second.refCount++;
+		return iter->second.texture;
+	}
+
+	Texture* TextureRegistry::InsertTexture(Texture* texture)
+	{
+		TNG_ASSERT_MSG(texture != nullptr, "Cannot insert null texture into the texture registry!");
+		TNG_ASSERT_MSG(texture->contentHash != 0, "Cannot insert texture without a content hash into the texture registry!");
+
+		uint64_t key = GetKey(texture->contentHash, texture->format);
+
+		std::lock_guard<std::mutex> lock(texturesMutex);
+
+		// Another thread might have decoded the same contents while we were decoding ours
+		auto iter = textures.find(key);
+		if (iter != textures.end())
+		{
+			delete texture;
+
+			iter->second.refCount++;
+			return iter->second.texture;
+		}
+
+		textures.insert({ key, { texture, 1 } });
+		return texture;
+	}
+
+	void TextureRegistry::ReleaseTexture(Texture* texture)
+	{
+		if (texture == nullptr)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(texturesMutex);
+
+		auto iter = textures.find(GetKey(texture->contentHash, texture->format));
+		if (iter == textures.end() || iter->second.texture != texture)
+		{
+			LogWarning("Attempting to release texture '%s' which is not owned by the texture registry!", texture->fileName.c_str());
+			return;
+		}
+
+		if (--iter->second.refCount == 0)
+		{
+			delete iter->second.texture;
+			textures.erase(iter);
+		}
+	}
+
+	TextureResource* TextureRegistry::AcquireResource(UploadContext& context, uint64_t contentHash, VkFormat format, const void* data, uint32_t width, uint32_t height, const SamplerCreateInfo* samplerInfo)
+	{
+		uint64_t key = GetKey(contentHash, format);
+
+		auto iter = resources.find(key);
+		if (iter != resources.end())
+		{
+			iter->second.refCount++;
+			return iter->second.resource;
+		}
+
+		if (data == nullptr)
+		{
+			LogError("Failed to create texture resource, no texture data was provided!");
+			return nullptr;
+		}
+
+		BaseImageCreateInfo baseImageInfo{};
+		baseImageInfo.width = width;
+		baseImageInfo.height = height;
+		baseImageInfo.format = format;
+		baseImageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		baseImageInfo.mipLevels = 1;
+		baseImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		baseImageInfo.arrayLayers = 1;
+		baseImageInfo.flags = 0;
+
+		ImageViewCreateInfo viewCreateInfo{};
+		viewCreateInfo.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewCreateInfo.viewScope = ImageViewScope::ENTIRE_IMAGE;
+
+		TextureResource* resource = new TextureResource();
+		resource->CreateFromData(context, data, &baseImageInfo, &viewCreateInfo, samplerInfo);
+		if (resource->IsInvalid())
+		{
+			LogError("Failed to create texture resource for texture with hash %llu!", contentHash);
+			delete resource;
+			return nullptr;
+		}
+
+		resources.insert({ key, { resource, 1 } });
+		resourceKeys.insert({ resource, key });
+
+		return resource;
+	}
+
+	TextureResource* TextureRegistry::AcquireResource(UploadContext& context, const Texture* texture, const SamplerCreateInfo* samplerInfo)
+	{
+		if (texture == nullptr || texture->data == nullptr || texture->mipOffsets.empty())
+		{
+			LogError("Failed to create texture resource, no texture data was provided!");
+			return nullptr;
+		}
+
+		uint64_t key = GetKey(texture->contentHash, texture->format);
+
+		auto iter = resources.find(key);
+		if (iter != resources.end())
+		{
+			iter->second.refCount++;
+			return iter->second.resource;
+		}
+
+		// Textures with a full mip chain are streamed in, so they can be drawn before all their mips are uploaded
+		if (CONFIG::EnableTextureStreaming && texture->GetMipLevels() > 1)
+		{
+			TextureResource* resource = TextureStreamer::GetInstance().CreateStreamedResource(context, texture, samplerInfo);
+			if (resource == nullptr)
+			{
+				return nullptr;
+			}
+
+			resources.insert({ key, { resource, 1 } });
+			resourceKeys.insert({ resource, key });
+
+			return resource;
+		}
+
+		BaseImageCreateInfo baseImageInfo{};
+		baseImageInfo.width = static_cast<uint32_t>(texture->size.x);
+		baseImageInfo.height = static_cast<uint32_t>(texture->size.y);
+		baseImageInfo.format = texture->format;
+		baseImageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		baseImageInfo.mipLevels = texture->GetMipLevels();
+		baseImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		baseImageInfo.arrayLayers = 1;
+		baseImageInfo.flags = 0;
+		baseImageInfo.generateMipMaps = false;
+
+		ImageViewCreateInfo viewCreateInfo{};
+		viewCreateInfo.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewCreateInfo.viewScope = ImageViewScope::ENTIRE_IMAGE;
+
+		TextureResource* resource = new TextureResource();
+		resource->CreateFromMipChain(context, texture->data, texture->mipOffsets.data(), &baseImageInfo, &viewCreateInfo, samplerInfo);
+		if (resource->IsInvalid())
+		{
+			LogError("Failed to create texture resource for texture '%s'!", texture->fileName.c_str());
+			delete resource;
+			return nullptr;
+		}
+
+		resources.insert({ key, { resource, 1 } });
+		resourceKeys.insert({ resource, key });
+
+		return resource;
+	}
+
+	void TextureRegistry::ReleaseResource(TextureResource* resource)
+	{
+		if (resource == nullptr)
+		{
+			return;
+		}
+
+		auto keyIter = resourceKeys.find(resource);
+		if (keyIter == resourceKeys.end())
+		{
+			LogWarning("Attempting to release texture resource which is not owned by the texture registry!");
+			return;
+		}
+
+		auto iter = resources.find(keyIter->second);
+		TNG_ASSERT_MSG(iter != resources.end(), "Texture registry resource maps are out of sync!");
+
+		if (--iter->second.refCount == 0)
+		{
+			TextureStreamer::GetInstance().Unregister(iter->second.resource);
+			iter->second.resource->Destroy();
+			delete iter->second.resource;
+
+			resources.erase(iter);
+			resourceKeys.erase(keyIter);
+		}
+	}
+
+	void TextureRegistry::DestroyAllResources()
+	{
+		TextureStreamer::GetInstance().Destroy();
+
+		for (auto& iter : resources)
+		{
+			iter.second.resource->Destroy();
+			delete iter.second.resource;
+		}
+
+		resources.clear();
+		resourceKeys.clear();
+	}
+
+	uint32_t TextureRegistry::GetTextureCount() const
+	{
+		std::lock_guard<std::mutex> lock(texturesMutex);
+		return static_cast<uint32_t>(textures.size());
+	}
+
+	uint32_t TextureRegistry::GetResourceCount() const
+	{
+		return static_cast<uint32_t>(resources.size());
+	}
+
+	uint64_t TextureRegistry::GetTextureBytes() const
+	{
+		std::lock_guard<std::mutex> lock(texturesMutex);
+
+		uint64_t bytes = 0;
+		for (const auto& iter : textures)
+		{
+			bytes += iter.second.texture->dataSize;
+		}
+
+		return bytes;
+	}
+
+	uint64_t TextureRegistry::GetKey(uint64_t contentHash, VkFormat format)
+	{
+		// Mix the format into the hash, so the same image used as both sRGB and UNORM gets two separate resources
+		return contentHash ^ (static_cast<uint64_t>(format) * 0x9E3779B97F4A7C15ull);
+	}
+}
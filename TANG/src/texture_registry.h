@@ -0,0 +1,107 @@
+#ifndef TEXTURE_REGISTRY_H
+#define TEXTURE_REGISTRY_H
+
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+namespace TANG
+{
+	struct Texture;
+	class TextureResource;
+	class UploadContext;
+	struct SamplerCreateInfo;
+
+	// Content-addressed registry of all the textures used by assets. Textures are identified by a hash of their file contents,
+	// so the same image is only ever decoded once and uploaded once, regardless of how many assets reference it or which
+	// directory the file was copied into. Both the decoded Texture and the GPU-side TextureResource are reference-counted
+	// separately, since the decoded data may be released long before the GPU resources are
+	class TextureRegistry
+	{
+	private:
+
+		TextureRegistry();
+		~TextureRegistry();
+
+	public:
+
+		// Singletons should not be assignable nor copyable
+		TextureRegistry(const TextureRegistry& other) = delete;
+		void operator=(const TextureRegistry& other) = delete;
+
+		static TextureRegistry& GetInstance()
+		{
+			static TextureRegistry instance;
+			return instance;
+		}
+
+		//////////////////////////////////////////////////
+		//
+		//	DECODED TEXTURES (thread-safe)
+		//
+		//////////////////////////////////////////////////
+
+		// Returns the texture with the provided content hash and format and increments it's reference count, or nullptr if it hasn't been
+		// decoded yet. The same image may be compressed into different formats depending on how it's used, which is why the format is part of the key
+		Texture* AcquireTexture(uint64_t contentHash, VkFormat format);
+
+		// Inserts a freshly-decoded texture into the registry with a reference count of one. If another thread inserted a texture
+		// with the same content hash and format in the meantime, the provided texture is deleted and the existing one is returned instead
+		Texture* InsertTexture(Texture* texture);
+
+		// Decrements the reference count of the texture, and deletes it once no more materials are referencing it
+		void ReleaseTexture(Texture* texture);
+
+		//////////////////////////////////////////////////
+		//
+		//	GPU RESOURCES (render thread only)
+		//
+		//////////////////////////////////////////////////
+
+		// Returns the texture resource for the provided content hash and format, creating it from the provided RGBA8 data if it doesn't
+		// exist yet. The upload is recorded into the context, so new resources must not be used until it's submitted. The same image may
+		// be used with different formats (sRGB vs UNORM), which is why the format is part of the key
+		TextureResource* AcquireResource(UploadContext& context, uint64_t contentHash, VkFormat format, const void* data, uint32_t width, uint32_t height, const SamplerCreateInfo* samplerInfo);
+
+		// Same as above, but creates the texture resource from the decoded texture's full mip chain, in the texture's format. If texture streaming
+		// is enabled, only the smallest mips are uploaded here and the TextureStreamer takes care of the rest
+		TextureResource* AcquireResource(UploadContext& context, const Texture* texture, const SamplerCreateInfo* samplerInfo);
+
+		// Decrements the reference count of the texture resource, and destroys it once no more assets are referencing it
+		void ReleaseResource(TextureResource* resource);
+
+		// Destroys all the texture resources, regardless of their reference count. Must be called before the logical device is destroyed
+		void DestroyAllResources();
+
+		uint32_t GetTextureCount() const;
+		uint32_t GetResourceCount() const;
+
+		// Returns the number of bytes of decoded texture data held by the registry
+		uint64_t GetTextureBytes() const;
+
+	private:
+
+		struct TextureEntry
+		{
+			Texture* texture;
+			uint32_t refCount;
+		};
+
+		struct ResourceEntry
+		{
+			TextureResource* resource;
+			uint32_t refCount;
+		};
+
+		static uint64_t GetKey(uint64_t contentHash, VkFormat format);
+
+		std::unordered_map<uint64_t, TextureEntry> textures;
+		mutable std::mutex texturesMutex;
+
+		std::unordered_map<uint64_t, ResourceEntry> resources;
+		std::unordered_map<const TextureResource*, uint64_t> resourceKeys;
+	};
+}
+
+#endif
@@ -1,13 +1,14 @@
 
 #include <cmath>
 #include <optional>
+#include <utility>
 
-#include "cmd_buffer/disposable_command.h"
 #include "cmd_buffer/command_buffer.h"
 #include "command_pool_registry.h"
-#include "data_buffer/staging_buffer.h"
 #include "device_cache.h"
+#include "texture_compression.h"
 #include "texture_resource.h"
+#include "upload_context.h"
 #include "utils/logger.h"
 #include "utils/sanity_check.h"
 
@@ -31,7 +32,7 @@ namespace TANG
 
 	TextureResource::~TextureResource()
 	{
-		if (imageMemory != VK_NULL_HANDLE)
+		if (imageAllocation.IsValid())
 		{
 			LogWarning("Texture '%s' has not been cleaned up, but destructor has been called!", name.c_str());
 		}
@@ -39,7 +40,7 @@ namespace TANG
 
 	TextureResource::TextureResource(const TextureResource& other) : name(other.name), isValid(other.isValid), bytesPerPixel(other.bytesPerPixel),
 		layout(other.layout), generatedMips(other.generatedMips), baseImageInfo(other.baseImageInfo), imageViewInfo(other.imageViewInfo), samplerInfo(other.samplerInfo), 
-		baseImage(other.baseImage), imageMemory(other.imageMemory), imageViews(other.imageViews), sampler(other.sampler)
+		baseImage(other.baseImage), imageAllocation(other.imageAllocation), imageViews(other.imageViews), sampler(other.sampler)
 	{
 		// TODO - Deep copy??
 		LogInfo("Texture resource shallow-copied (copy-constructor)");
@@ -47,7 +48,7 @@ namespace TANG
 
 	TextureResource::TextureResource(TextureResource&& other) noexcept : name(std::move(other.name)), isValid(std::move(other.isValid)), bytesPerPixel(std::move(other.bytesPerPixel)),
 		layout(std::move(other.layout)), generatedMips(std::move(other.generatedMips)), baseImageInfo(std::move(other.baseImageInfo)), imageViewInfo(std::move(other.imageViewInfo)), samplerInfo(std::move(other.samplerInfo)),
-		baseImage(std::move(other.baseImage)), imageMemory(std::move(other.imageMemory)), imageViews(std::move(other.imageViews)), sampler(std::move(other.sampler))
+		baseImage(std::move(other.baseImage)), imageAllocation(std::move(other.imageAllocation)), imageViews(std::move(other.imageViews)), sampler(std::move(other.sampler))
 	{
 		other.ResetMembers();
 	}
@@ -70,7 +71,7 @@ namespace TANG
 		samplerInfo = other.samplerInfo;
 
 		baseImage = other.baseImage;
-		imageMemory = other.imageMemory;
+		imageAllocation = other.imageAllocation;
 		imageViews = other.imageViews;
 		sampler = other.sampler;
 
@@ -82,16 +83,64 @@ namespace TANG
 
 	void TextureResource::Create(const BaseImageCreateInfo* _baseImageInfo, const ImageViewCreateInfo* _viewInfo, const SamplerCreateInfo* _samplerInfo)
 	{
-		if(_baseImageInfo != nullptr) CreateBaseImage_Helper(_baseImageInfo);
+		if(_baseImageInfo != nullptr) CreateBaseImage(_baseImageInfo);
 		if(_viewInfo != nullptr)      CreateImageViews(_viewInfo);
 		if(_samplerInfo != nullptr)   CreateSampler(_samplerInfo);
 	}
 
 	void TextureResource::CreateFromFile(std::string_view fileName, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo, const SamplerCreateInfo* _samplerInfo)
 	{
-		CreateBaseImageFromFile(fileName, createInfo);
+		UploadContext context(QueueType::GRAPHICS);
+		CreateBaseImageFromFile(context, fileName, createInfo);
 		if(viewInfo != nullptr) CreateImageViews(viewInfo);
 		if(_samplerInfo != nullptr) CreateSampler(_samplerInfo);
+		context.SubmitAndWait();
+	}
+
+	void TextureResource::CreateFromData(const void* data, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo, const SamplerCreateInfo* _samplerInfo)
+	{
+		UploadContext context(QueueType::GRAPHICS);
+		CreateFromData(context, data, createInfo, viewInfo, _samplerInfo);
+		context.SubmitAndWait();
+	}
+
+	void TextureResource::CreateFromData(UploadContext& context, const void* data, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo, const SamplerCreateInfo* _samplerInfo)
+	{
+		CreateBaseImageFromData(context, data, createInfo);
+		if(viewInfo != nullptr) CreateImageViews(viewInfo);
+		if(_samplerInfo != nullptr) CreateSampler(_samplerInfo);
+	}
+
+	void TextureResource::CreateFromMipChain(const void* data, const uint64_t* mipOffsets, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo, const SamplerCreateInfo* _samplerInfo)
+	{
+		UploadContext context(QueueType::GRAPHICS);
+		CreateFromMipChain(context, data, mipOffsets, createInfo, viewInfo, _samplerInfo);
+		context.SubmitAndWait();
+	}
+
+	void TextureResource::CreateFromMipChain(UploadContext& context, const void* data, const uint64_t* mipOffsets, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo, const SamplerCreateInfo* _samplerInfo)
+	{
+		CreateBaseImageFromMipChain(context, data, mipOffsets, createInfo);
+		if(viewInfo != nullptr) CreateImageViews(viewInfo);
+		if(_samplerInfo != nullptr) CreateSampler(_samplerInfo);
+	}
+
+	void TextureResource::Swap(TextureResource& other)
+	{
+		std::swap(name, other.name);
+		std::swap(isValid, other.isValid);
+		std::swap(bytesPerPixel, other.bytesPerPixel);
+		std::swap(layout, other.layout);
+		std::swap(generatedMips, other.generatedMips);
+
+		std::swap(baseImageInfo, other.baseImageInfo);
+		std::swap(imageViewInfo, other.imageViewInfo);
+		std::swap(samplerInfo, other.samplerInfo);
+
+		std::swap(baseImage, other.baseImage);
+		std::swap(imageAllocation, other.imageAllocation);
+		std::swap(imageViews, other.imageViews);
+		std::swap(sampler, other.sampler);
 	}
 
 	void TextureResource::Destroy()
@@ -116,11 +165,7 @@ namespace TANG
 			baseImage = VK_NULL_HANDLE;
 		}
 
-		if (imageMemory != VK_NULL_HANDLE)
-		{
-			vkFreeMemory(logicalDevice, imageMemory, nullptr);
-			imageMemory = VK_NULL_HANDLE;
-		}
+		DeviceAllocator::GetInstance().Free(imageAllocation);
 	}
 
 	void TextureResource::DestroyImageViews()
@@ -146,10 +191,39 @@ namespace TANG
 		}
 	}
 
+	void TextureResource::TransitionLayout(UploadContext& context, VkImageLayout sourceLayout, VkImageLayout destinationLayout)
+	{
+		VkPipelineStageFlags sourceStage = 0;
+		VkPipelineStageFlags destinationStage = 0;
+		QueueType queueType = QueueType::GRAPHICS;
+
+		auto barrier = TransitionLayout_Helper(this, sourceLayout, destinationLayout, sourceStage, destinationStage, queueType);
+		if (!barrier.has_value())
+		{
+			return;
+		}
+
+		if (queueType == QueueType::TRANSFER)
+		{
+			InsertPipelineBarrier_Internal(context.GetBuffer(), sourceStage, destinationStage, barrier.value());
+		}
+		else if (sourceLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && context.IsOwnershipTransferRequired())
+		{
+			context.ReleaseImage(baseImage, barrier.value().subresourceRange, destinationLayout, destinationStage, barrier.value().dstAccessMask);
+		}
+		else
+		{
+			InsertPipelineBarrier_Internal(context.GetGraphicsBuffer(), sourceStage, destinationStage, barrier.value());
+		}
+
+		layout = destinationLayout;
+	}
+
 	void TextureResource::TransitionLayout_Immediate(VkImageLayout sourceLayout, VkImageLayout destinationLayout)
 	{
-		DisposableCommand command(QueueType::GRAPHICS, true);
-		TransitionLayout_Internal(command.GetBuffer(), this, sourceLayout, destinationLayout);
+		UploadContext context(QueueType::GRAPHICS);
+		TransitionLayout(context, sourceLayout, destinationLayout);
+		context.SubmitAndWait();
 	}
 
 	void TextureResource::TransitionLayout_Force(VkImageLayout destinationLayout)
@@ -184,10 +258,35 @@ namespace TANG
 		GenerateMipmaps_Helper(cmdBuffer->GetBuffer(), mipCount);
 	}
 
+	void TextureResource::GenerateMipmaps(UploadContext& context, uint32_t mipCount)
+	{
+		if (mipCount > baseImageInfo.mipLevels || generatedMips >= mipCount)
+		{
+			return;
+		}
+
+		// Blits are only supported by the graphics queue, so if the first mip was written on a dedicated transfer queue we must hand the
+		// image over first. It stays in TRANSFER_DST_OPTIMAL, which is what GenerateMipmaps_Helper() expects
+		if (context.IsOwnershipTransferRequired() && layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+		{
+			VkImageSubresourceRange range{};
+			range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			range.baseMipLevel = 0;
+			range.levelCount = baseImageInfo.mipLevels;
+			range.baseArrayLayer = 0;
+			range.layerCount = baseImageInfo.arrayLayers;
+
+			context.ReleaseImage(baseImage, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+		}
+
+		GenerateMipmaps_Helper(context.GetGraphicsBuffer(), mipCount);
+	}
+
 	void TextureResource::GenerateMipmaps_Immediate(uint32_t mipCount)
 	{
-		DisposableCommand cmdBuffer(QueueType::GRAPHICS, true);
-		GenerateMipmaps_Helper(cmdBuffer.GetBuffer(), mipCount);
+		UploadContext context(QueueType::GRAPHICS);
+		GenerateMipmaps(context, mipCount);
+		context.SubmitAndWait();
 	}
 
 	VkImageView TextureResource::GetImageView(uint32_t viewIndex) const 
@@ -286,9 +385,23 @@ namespace TANG
 	void TextureResource::CreateBaseImage(const BaseImageCreateInfo* _baseImageInfo)
 	{
 		CreateBaseImage_Helper(_baseImageInfo);
+		if (IsInvalid())
+		{
+			return;
+		}
+
+		// Calculate mip levels
+		if (baseImageInfo.generateMipMaps && baseImageInfo.mipLevels > 1)
+		{
+			// Source layout should always be UNDEFINED here
+			UploadContext context(QueueType::GRAPHICS);
+			TransitionLayout(context, layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+			GenerateMipmaps(context, baseImageInfo.mipLevels);
+			context.SubmitAndWait();
+		}
 	}
 
-	void TextureResource::CreateBaseImageFromFile(std::string_view filePath, const BaseImageCreateInfo* createInfo)
+	void TextureResource::CreateBaseImageFromFile(UploadContext& context, std::string_view filePath, const BaseImageCreateInfo* createInfo)
 	{
 		int _width, _height, _channels;
 		void* data;
@@ -313,15 +426,73 @@ namespace TANG
 		BaseImageCreateInfo _baseImageInfo = *createInfo;
 		_baseImageInfo.width = _width;
 		_baseImageInfo.height = _height;
+		CreateBaseImageFromData(context, data, &_baseImageInfo);
+
+		// The data was copied into the staging ring when the upload was recorded, so we don't need the original pixels array anymore
+		stbi_image_free(data);
+	}
+
+	void TextureResource::CreateBaseImageFromData(UploadContext& context, const void* data, const BaseImageCreateInfo* createInfo)
+	{
+		CreateBaseImage_Helper(createInfo);
+		if (IsInvalid())
+		{
+			return;
+		}
+
+		VkDeviceSize imageSize = createInfo->width * createInfo->height * bytesPerPixel;
+		CopyFromData(context, data, imageSize);
+
+		// The copy leaves every mip in TRANSFER_DST_OPTIMAL, so the rest of the chain can be generated from the first mip right away
+		if (baseImageInfo.generateMipMaps && baseImageInfo.mipLevels > 1)
+		{
+			GenerateMipmaps(context, baseImageInfo.mipLevels);
+		}
+
+		if (layout != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+		{
+			TransitionLayout(context, layout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		}
+	}
+
+	void TextureResource::CreateBaseImageFromMipChain(UploadContext& context, const void* data, const uint64_t* mipOffsets, const BaseImageCreateInfo* createInfo)
+	{
+		if (createInfo->mipLevels == 0)
+		{
+			LogError("Failed to create texture from mip chain, at least one mip level must be provided!");
+			return;
+		}
+
+		// The mips are already in the data, so we must not overwrite them by generating our own
+		BaseImageCreateInfo _baseImageInfo = *createInfo;
+		_baseImageInfo.generateMipMaps = false;
+
 		CreateBaseImage_Helper(&_baseImageInfo);
+		if (IsInvalid())
+		{
+			return;
+		}
 
-		VkDeviceSize imageSize = _width * _height * bytesPerPixel;
-		CopyFromData(data, imageSize);
+		// Every mip is tightly packed in the provided data, so each one is staged straight from it's offset
+		uint32_t mipCount = _baseImageInfo.mipLevels;
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
 
-		// Now that we've copied over the data to the texture image, we don't need the original pixels array anymore
-		stbi_image_free(data);
+		TransitionLayout(context, layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+		bool staged = true;
+		for (uint32_t i = 0; i < mipCount && staged; i++)
+		{
+			staged = StageMipLevel(context, bytes + mipOffsets[i], i, std::max(_baseImageInfo.width >> i, 1u), std::max(_baseImageInfo.height >> i, 1u), _baseImageInfo.arrayLayers);
+		}
+
+		TransitionLayout(context, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+		if (!staged)
+		{
+			LogError("Failed to upload mip chain to texture '%s'!", name.c_str());
+		}
 
-		TransitionLayout_Immediate(layout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		generatedMips = mipCount;
 	}
 
 	void TextureResource::GenerateMipmaps_Helper(VkCommandBuffer cmdBuffer, uint32_t mipCount)
@@ -532,36 +703,20 @@ namespace TANG
 			return;
 		}
 
-		VkMemoryRequirements memRequirements;
-		vkGetImageMemoryRequirements(logicalDevice, baseImage, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-		if (vkAllocateMemory(logicalDevice, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
+		if (!DeviceAllocator::GetInstance().AllocateImageMemory(baseImage, MemoryPool::DEVICE_LOCAL, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, imageAllocation))
 		{
 			LogError("Failed to allocate image memory!");
-			return; // No need to clean-up image since we couldn't allocate the memory anyway
+			vkDestroyImage(logicalDevice, baseImage, nullptr);
+			baseImage = VK_NULL_HANDLE;
+			return;
 		}
 
-		vkBindImageMemory(logicalDevice, baseImage, imageMemory, 0);
-
 		// Cache some of the image data
 		bytesPerPixel = GetBytesPerPixelFromFormat(_baseImageInfo->format);
 		baseImageInfo = *_baseImageInfo;
 		baseImageInfo.mipLevels = mipsToUse;
 		isValid = true;
 		generatedMips = 1;
-
-		// Calculate mip levels
-		if (baseImageInfo.generateMipMaps && mipsToUse > 1)
-		{
-			// Source layout should always be UNDEFINED here
-			TransitionLayout_Immediate(layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-			GenerateMipmaps_Immediate(_baseImageInfo->mipLevels);
-		}
 	}
 
 	void TextureResource::CreateImageViewFromBase(VkImage _baseImage, VkFormat _format, uint32_t _mipLevels, VkImageAspectFlags _aspect)
@@ -590,6 +745,13 @@ namespace TANG
 	}
 
 	void TextureResource::CopyFromData(void* data, VkDeviceSize bytes)
+	{
+		UploadContext context(QueueType::GRAPHICS);
+		CopyFromData(context, data, bytes);
+		context.SubmitAndWait();
+	}
+
+	void TextureResource::CopyFromData(UploadContext& context, const void* data, VkDeviceSize bytes)
 	{
 		if (IsInvalid())
 		{
@@ -612,22 +774,35 @@ namespace TANG
 		
 		VkDeviceSize actualSize = std::min(bytes, imageSize);
 
-		StagingBuffer stagingBuffer;
-		stagingBuffer.Create(actualSize);
-		stagingBuffer.CopyIntoBuffer(data, actualSize);
+		// Only whole rows can be copied into the image
+		VkDeviceSize rowPitch = static_cast<VkDeviceSize>(baseImageInfo.width) * bytesPerPixel;
+		uint32_t rowCount = static_cast<uint32_t>(actualSize / rowPitch);
+		if (rowCount == 0)
+		{
+			LogWarning("Attempting to copy %llu bytes into texture image, which is less than a single row of %llu bytes!", actualSize, rowPitch);
+			return;
+		}
 
 		VkImageLayout oldLayout = layout;
 
-		TransitionLayout_Immediate(oldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+		// The graphics queue owns the image once it has been written to, and we don't hand images back to the transfer queue
+		if (context.IsOwnershipTransferRequired() && oldLayout != VK_IMAGE_LAYOUT_UNDEFINED)
+		{
+			LogError("Attempting to copy data into texture '%s' on the transfer queue, but the texture is owned by the graphics queue!", name.c_str());
+			return;
+		}
 
-		CopyFromBuffer(stagingBuffer.GetBuffer(), 0);
+		TransitionLayout(context, oldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-		if (oldLayout != VK_IMAGE_LAYOUT_UNDEFINED)
+		if (!StageMipLevel(context, data, 0, baseImageInfo.width, rowCount, baseImageInfo.arrayLayers))
 		{
-			TransitionLayout_Immediate(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, oldLayout);
+			LogError("Failed to copy data into texture '%s'!", name.c_str());
 		}
 
-		stagingBuffer.Destroy();
+		if (oldLayout != VK_IMAGE_LAYOUT_UNDEFINED)
+		{
+			TransitionLayout(context, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, oldLayout);
+		}
 	}
 
 	void TextureResource::CopyFromTexture(CommandBuffer* cmdBuffer, TextureResource* sourceTexture, uint32_t baseMip, uint32_t mipCount)
@@ -780,32 +955,42 @@ namespace TANG
 		imageViewInfo = *_viewInfo;
 	}
 
-	void TextureResource::CopyFromBuffer(VkBuffer buffer, uint32_t destinationMipLevel)
+	bool TextureResource::StageMipLevel(UploadContext& context, const void* data, uint32_t mipLevel, uint32_t width, uint32_t height, uint32_t layerCount)
 	{
 		if (IsInvalid())
 		{
-			LogError("Attempting to copy from buffer, but base image has not yet been created!");
-			return;
+			LogError("Attempting to stage mip level, but base image has not yet been created!");
+			return false;
 		}
 
-		{
-			DisposableCommand command(QueueType::TRANSFER, true);
+		// Block-compressed rows are one block (4 texels) tall. Mips that don't fit in the staging ring are copied in bands of 16 texel
+		// rows, so the image offsets stay aligned to the transfer granularity of dedicated transfer queues
+		bool isCompressed = TextureCompression::IsBlockCompressed(baseImageInfo.format);
+		uint32_t texelsPerRow = isCompressed ? 4 : 1;
+		uint32_t rowCount = (height + texelsPerRow - 1) / texelsPerRow;
+		VkDeviceSize rowPitch = isCompressed ? TextureCompression::CalculateMipSize(baseImageInfo.format, width, 1) : static_cast<VkDeviceSize>(width) * bytesPerPixel;
+		VkDeviceSize bandSize = rowPitch * (16 / texelsPerRow);
 
-			VkBufferImageCopy region{};
-			region.bufferOffset = 0;
-			region.bufferRowLength = 0;
-			region.bufferImageHeight = 0;
+		return context.StageChunked(data, rowPitch * rowCount, bandSize, 16, [&](VkCommandBuffer commandBuffer, const StagingRegion& stagingRegion, VkDeviceSize dataOffset)
+			{
+				uint32_t firstTexelRow = static_cast<uint32_t>(dataOffset / rowPitch) * texelsPerRow;
+				uint32_t texelRowCount = static_cast<uint32_t>(stagingRegion.size / rowPitch) * texelsPerRow;
 
-			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			region.imageSubresource.mipLevel = destinationMipLevel;
-			region.imageSubresource.baseArrayLayer = 0;
-			region.imageSubresource.layerCount = baseImageInfo.arrayLayers;
+				VkBufferImageCopy region{};
+				region.bufferOffset = stagingRegion.offset;
+				region.bufferRowLength = 0;
+				region.bufferImageHeight = 0;
 
-			region.imageOffset = { 0, 0, 0 };
-			region.imageExtent = { baseImageInfo.width, baseImageInfo.height, 1 };
+				region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+				region.imageSubresource.mipLevel = mipLevel;
+				region.imageSubresource.baseArrayLayer = 0;
+				region.imageSubresource.layerCount = layerCount;
 
-			vkCmdCopyBufferToImage(command.GetBuffer(), buffer, baseImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-		}
+				region.imageOffset = { 0, static_cast<int32_t>(firstTexelRow), 0 };
+				region.imageExtent = { width, std::min(texelRowCount, height - firstTexelRow), 1 };
+
+				vkCmdCopyBufferToImage(commandBuffer, stagingRegion.buffer, baseImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+			});
 	}
 
 	void TextureResource::TransitionLayout_Internal(VkCommandBuffer commandBuffer, TextureResource* baseTexture, VkImageLayout sourceLayout, VkImageLayout destinationLayout)
@@ -1132,31 +1317,23 @@ namespace TANG
 		samplerInfo = SamplerCreateInfo();
 
 		baseImage = VK_NULL_HANDLE;
-		imageMemory = VK_NULL_HANDLE;
+		imageAllocation = DeviceAllocation();
 		imageViews.clear();
 		sampler = VK_NULL_HANDLE;
 	}
 
-	uint32_t TextureResource::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
-	{
-		VkPhysicalDeviceMemoryProperties memProperties = DeviceCache::Get().GetPhysicalDeviceMemoryProperties();
-
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
-		{
-			if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-			{
-				return i;
-			}
-		}
-
-		LogError("Failed to find suitable memory type!");
-		return std::numeric_limits<uint32_t>::max();
-	}
-
 	uint32_t TextureResource::GetBytesPerPixelFromFormat(VkFormat texFormat)
 	{
 		switch (texFormat)
 		{
+		case VK_FORMAT_R8_UNORM:
+		{
+			return 1;
+		}
+		case VK_FORMAT_R8G8_UNORM:
+		{
+			return 2;
+		}
 		case VK_FORMAT_R16G16_SFLOAT:
 		case VK_FORMAT_R8G8B8A8_UNORM:
 		case VK_FORMAT_B8G8R8A8_UNORM:
@@ -1176,6 +1353,14 @@ namespace TANG
 			// HDR
 			return 16;
 		}
+		case VK_FORMAT_BC5_UNORM_BLOCK:
+		case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+		case VK_FORMAT_BC7_SRGB_BLOCK:
+		{
+			// Block-compressed formats don't have a per-pixel size, use TextureCompression::CalculateMipSize() instead
+			return 0;
+		}
 		}
 
 		TNG_ASSERT_MSG(false, "Attempting to get bytes per pixel from format, but texture format is not yet supported!");
@@ -6,6 +6,7 @@
 #include <vector>
 #include <vulkan/vulkan.h>
 
+#include "device_allocator.h"
 #include "queue_types.h"
 
 namespace TANG
@@ -55,7 +56,7 @@ namespace TANG
 
 	// Forward declarations
 	class CommandBuffer;
-	class DisposableCommand;
+	class UploadContext;
 
 	class TextureResource
 	{
@@ -72,6 +73,21 @@ namespace TANG
 		// NOTE - The width, height and mipmaps field from BaseImageCreateInfo in unused in this function. Those get pulled from the loaded image directly
 		void CreateFromFile(std::string_view fileName, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo = nullptr, const SamplerCreateInfo* samplerInfo = nullptr);
 
+		// Creates the texture and uploads the provided data into the first mip level. The data must match the width, height and format specified in createInfo
+		void CreateFromData(const void* data, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo = nullptr, const SamplerCreateInfo* samplerInfo = nullptr);
+
+		// Same as above, but the upload is recorded into the provided context instead of being submitted and waited on right away. The
+		// texture must not be used until the context has been submitted
+		void CreateFromData(UploadContext& context, const void* data, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo = nullptr, const SamplerCreateInfo* samplerInfo = nullptr);
+
+		// Creates the texture and uploads a pre-built mip chain into it, which is how block-compressed textures are uploaded since their
+		// mips can't be generated on the GPU. The mip count is taken from createInfo, and mipOffsets must contain that many offsets into data
+		// NOTE - The generateMipMaps field from BaseImageCreateInfo is ignored
+		void CreateFromMipChain(const void* data, const uint64_t* mipOffsets, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo = nullptr, const SamplerCreateInfo* samplerInfo = nullptr);
+
+		// Same as above, but the upload is recorded into the provided context
+		void CreateFromMipChain(UploadContext& context, const void* data, const uint64_t* mipOffsets, const BaseImageCreateInfo* createInfo, const ImageViewCreateInfo* viewInfo = nullptr, const SamplerCreateInfo* samplerInfo = nullptr);
+
 		// Create image view from a provided base image. This is used to create an image into the swapchain's provided base images, since
 		// we don't want to create our own base images in this case
 		void CreateImageViewFromBase(VkImage baseImage, VkFormat format, uint32_t mipLevels, VkImageAspectFlags aspect);
@@ -81,17 +97,28 @@ namespace TANG
 		//        TRANSFER_DST_OPTIMAL
 		void CopyFromData(void* data, VkDeviceSize bytes);
 
+		// Same as above, but the copy is recorded into the provided context. If the context records on a dedicated transfer queue, the
+		// texture must not have been written to before (it's layout must be UNDEFINED), since the transfer queue doesn't own it otherwise
+		void CopyFromData(UploadContext& context, const void* data, VkDeviceSize bytes);
+
 		// Copies the image data from the provided source texture, including all the specified mips
 		void CopyFromTexture(CommandBuffer* cmdBuffer, TextureResource* sourceTexture, uint32_t baseMip, uint32_t mipCount);
 
 		// Deletes the existing image views (if any) and creates them depending on the data contained within the viewInfo parameter
 		void RecreateImageViews(const ImageViewCreateInfo* viewInfo);
 
+		// Exchanges the image, views, sampler and all the metadata with the other texture. This is used to replace the image of a texture
+		// that other objects are holding a pointer to, the previous image ends up in the other texture so it can be destroyed later
+		void Swap(TextureResource& other);
+
 		void Destroy();
 		void DestroyBaseImage();
 		void DestroyImageViews();
 
 		void TransitionLayout(CommandBuffer* commandBuffer, VkImageLayout sourceLayout, VkImageLayout destinationLayout);
+		// Transfer-only transitions are recorded into the context's transfer command buffer, and every other transition into it's graphics
+		// command buffer. A transition out of TRANSFER_DST_OPTIMAL into a layout used by the graphics queue also hands the image over to it
+		void TransitionLayout(UploadContext& context, VkImageLayout sourceLayout, VkImageLayout destinationLayout);
 		void TransitionLayout_Immediate(VkImageLayout sourceLayout, VkImageLayout destinationLayout);
 		void TransitionLayout_Force(VkImageLayout destinationLayout); // This function must only be used to reflect implicit layout transitions which happen after the render pass ends. It does not introduce a pipeline barrier like the other TransitionLayout() functions
 
@@ -104,6 +131,7 @@ namespace TANG
 			uint32_t mipCount);
 
 		void GenerateMipmaps(CommandBuffer* cmdBuffer, uint32_t mipCount);
+		void GenerateMipmaps(UploadContext& context, uint32_t mipCount);
 
 		VkImageView GetImageView(uint32_t viewIndex) const;
 		VkSampler GetSampler() const;
@@ -126,9 +154,11 @@ namespace TANG
 	private:
 
 		void CreateBaseImage(const BaseImageCreateInfo* baseImageInfo);
-		void CreateBaseImageFromFile(std::string_view filePath, const BaseImageCreateInfo* createInfo);
+		void CreateBaseImageFromFile(UploadContext& context, std::string_view filePath, const BaseImageCreateInfo* createInfo);
+		void CreateBaseImageFromData(UploadContext& context, const void* data, const BaseImageCreateInfo* createInfo);
+		void CreateBaseImageFromMipChain(UploadContext& context, const void* data, const uint64_t* mipOffsets, const BaseImageCreateInfo* createInfo);
 
-		// NOTE - This function stalls the graphics queue twice!
+		// NOTE - This function waits for the GPU to finish generating the mips!
 		void GenerateMipmaps_Immediate(uint32_t mipCount);
 		void GenerateMipmaps_Helper(VkCommandBuffer cmdBuffer, uint32_t mipCount);
 
@@ -139,7 +169,8 @@ namespace TANG
 
 		void CreateBaseImage_Helper(const BaseImageCreateInfo* baseImageInfo);
 
-		void CopyFromBuffer(VkBuffer buffer, uint32_t destinationMipLevel);
+		// Stages a tightly-packed mip level and records the copies into the image, which must be in TRANSFER_DST_OPTIMAL layout
+		bool StageMipLevel(UploadContext& context, const void* data, uint32_t mipLevel, uint32_t width, uint32_t height, uint32_t layerCount);
 
 		void TransitionLayout_Internal(VkCommandBuffer commandBuffer, 
 			TextureResource* baseTexture, 
@@ -169,8 +200,6 @@ namespace TANG
 		// NOTE - This function does NOT clean up the allocated memory!!
 		void ResetMembers();
 
-		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-
 		uint32_t GetBytesPerPixelFromFormat(VkFormat format);
 
 		uint32_t CalculateMipLevelsFromSize(uint32_t width, uint32_t height) const;
@@ -188,7 +217,7 @@ namespace TANG
 		SamplerCreateInfo samplerInfo;
 
 		VkImage baseImage;
-		VkDeviceMemory imageMemory;
+		DeviceAllocation imageAllocation;
 		std::vector<VkImageView> imageViews;
 		VkSampler sampler;
 
@@ -0,0 +1,589 @@
+
+#include <algorithm>
+#include <cmath>
+
+#include "asset_serializer.h"
+#include "asset_types.h"
+#include "async_asset_loader.h"
+#include "config.h"
+#include "texture_compression.h"
+#include "texture_registry.h"
+#include "texture_streamer.h"
+#include "upload_context.h"
+#include "utils/logger.h"
+#include "utils/sanity_check.h"
+
+namespace TANG
+{
+	TextureStreamer::TextureStreamer() : frameCounter(0), residencyVersion(0), residentBytes(0), uploadedBytes(0), evictedMips(0)
+	{
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		if (!streamedTextures.empty() || !retiredTextures.empty() || !pendingUploads.empty() || !pendingReads.empty())
+		{
+			LogWarning("Texture streamer destroyed with %u streamed textures, %u retired textures, %u pending uploads and %u pending reads still alive!",
+				static_cast<uint32_t>(streamedTextures.size()), static_cast<uint32_t>(retiredTextures.size()), static_cast<uint32_t>(pendingUploads.size()),
+				static_cast<uint32_t>(pendingReads.size()));
+		}
+	}
+
+	TextureResource* TextureStreamer::CreateStreamedResource(UploadContext& context, const Texture* texture, const SamplerCreateInfo* samplerInfo)
+	{
+		if (texture == nullptr || texture->data == nullptr || texture->GetMipLevels() < 2)
+		{
+			LogError("Failed to create streamed texture resource, the texture must have a full mip chain!");
+			return nullptr;
+		}
+
+		// Hold on to the decoded texture for as long as we're streaming it, since every residency change re-uploads from it
+		Texture* streamedTexture = TextureRegistry::GetInstance().AcquireTexture(texture->contentHash, texture->format);
+		if (streamedTexture == nullptr)
+		{
+			LogError("Failed to create streamed texture resource for texture '%s', it's not owned by the texture registry!", texture->fileName.c_str());
+			return nullptr;
+		}
+
+		StreamedTexture streamed{};
+		streamed.texture = streamedTexture;
+		streamed.cacheName = texture->fileName;
+		streamed.contentHash = texture->contentHash;
+		streamed.format = texture->format;
+		streamed.width = static_cast<uint32_t>(texture->size.x);
+		streamed.height = static_cast<uint32_t>(texture->size.y);
+		streamed.mipOffsets = texture->mipOffsets;
+		streamed.dataSize = texture->dataSize;
+		streamed.samplerInfo = samplerInfo != nullptr ? *samplerInfo : SamplerCreateInfo();
+		streamed.mipCount = texture->GetMipLevels();
+		streamed.residentMip = streamed.mipCount; // Nothing is resident yet
+		streamed.screenSize = 0.0f;
+		streamed.requestedScreenSize = 0.0f;
+		streamed.residencyVersion = 0;
+
+		// The tail starts at the first mip that fits in the always-resident size
+		uint32_t largestDimension = std::max(streamed.width, streamed.height);
+		streamed.tailMip = 0;
+		while (streamed.tailMip < streamed.mipCount - 1 && (largestDimension >> streamed.tailMip) > CONFIG::TextureStreamingResidentMipSize)
+		{
+			streamed.tailMip++;
+		}
+		streamed.desiredMip = streamed.tailMip;
+
+		TextureResource* resource = new TextureResource();
+		if (!SetResidentMip(context, resource, streamed, streamed.tailMip))
+		{
+			LogError("Failed to create streamed texture resource for texture '%s'!", texture->fileName.c_str());
+			TextureRegistry::GetInstance().ReleaseTexture(streamedTexture);
+			delete resource;
+			return nullptr;
+		}
+
+		// If the CPU-side data is released after upload, only keep the decoded texture around when there's no cache to read it back from.
+		// Reading the smallest mip is enough to validate the cache
+		if (CONFIG::ReleaseCPUAssetDataAfterUpload && TextureCompression::IsBlockCompressed(streamed.format))
+		{
+			Texture cachedTail;
+			if (SerializerUtils::DeserializeTexture(streamed.cacheName, streamed.format, streamed.contentHash, &cachedTail, streamed.mipCount - 1))
+			{
+				TextureRegistry::GetInstance().ReleaseTexture(streamedTexture);
+				streamed.texture = nullptr;
+			}
+		}
+
+		streamedTextures.insert({ resource, streamed });
+		return resource;
+	}
+
+	void TextureStreamer::Unregister(TextureResource* resource)
+	{
+		auto iter = streamedTextures.find(resource);
+		if (iter == streamedTextures.end())
+		{
+			return;
+		}
+
+		CancelPendingRead(resource);
+		CancelPendingUpload(resource);
+
+		StreamedTexture& streamed = iter->second;
+		residentBytes -= CalculateResidentBytes(streamed, streamed.residentMip);
+		TextureRegistry::GetInstance().ReleaseTexture(streamed.texture);
+
+		streamedTextures.erase(iter);
+	}
+
+	void TextureStreamer::Destroy()
+	{
+		while (!pendingReads.empty())
+		{
+			CancelPendingRead(pendingReads.begin()->first);
+		}
+
+		while (!pendingUploads.empty())
+		{
+			CancelPendingUpload(pendingUploads.begin()->first);
+		}
+
+		for (auto& retired : retiredTextures)
+		{
+			retired.resource->Destroy();
+			delete retired.resource;
+		}
+		retiredTextures.clear();
+
+		// The resources themselves belong to whoever created them through CreateStreamedResource(), we only let go of the decoded textures
+		for (auto& iter : streamedTextures)
+		{
+			TextureRegistry::GetInstance().ReleaseTexture(iter.second.texture);
+		}
+		streamedTextures.clear();
+
+		residentBytes = 0;
+	}
+
+	void TextureStreamer::RequestScreenSize(TextureResource* resource, float screenSize)
+	{
+		auto iter = streamedTextures.find(resource);
+		if (iter == streamedTextures.end())
+		{
+			return;
+		}
+
+		iter->second.requestedScreenSize = std::max(iter->second.requestedScreenSize, screenSize);
+	}
+
+	void TextureStreamer::Update()
+	{
+		frameCounter++;
+		uploadedBytes = 0;
+		evictedMips = 0;
+
+		SwapCompletedUploads();
+
+		// Evicting a mip re-uploads the mips that stay resident as well, so those uploads go through the same context as the completed reads
+		// and the mips that are streamed in
+		UploadContext context(QueueType::TRANSFER);
+		ProcessCompletedReads(context);
+
+		// Once every frame in flight has waited on it's fence since an image was retired, nothing can be using it anymore
+		for (auto iter = retiredTextures.begin(); iter != retiredTextures.end();)
+		{
+			if (frameCounter - iter->retiredFrame > CONFIG::MaxFramesInFlight)
+			{
+				iter->resource->Destroy();
+				delete iter->resource;
+				iter = retiredTextures.erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
+		}
+
+		std::vector<std::pair<TextureResource*, StreamedTexture*>> streamInCandidates;
+		for (auto& iter : streamedTextures)
+		{
+			StreamedTexture& streamed = iter.second;
+			streamed.screenSize = streamed.requestedScreenSize;
+			streamed.requestedScreenSize = 0.0f;
+			streamed.desiredMip = CalculateDesiredMip(streamed);
+
+			// The residency of textures with a read or upload in flight is only changed again once it has been swapped in
+			if (streamed.desiredMip < streamed.residentMip && !IsResidencyChanging(iter.first))
+			{
+				streamInCandidates.push_back({ iter.first, &streamed });
+			}
+		}
+
+		// Get back under budget first, in case textures were created while we were close to the limit
+		EvictForBytes(context, 0, nullptr);
+
+		// The textures that are largest on screen are streamed in first
+		std::sort(streamInCandidates.begin(), streamInCandidates.end(), [](const auto& a, const auto& b)
+			{
+				return a.second->screenSize > b.second->screenSize;
+			});
+
+		for (auto& candidate : streamInCandidates)
+		{
+			TextureResource* resource = candidate.first;
+			StreamedTexture& streamed = *candidate.second;
+
+			// The texture might have been evicted to make room for another one
+			if (streamed.desiredMip >= streamed.residentMip || IsResidencyChanging(resource))
+			{
+				continue;
+			}
+
+			// Every residency change re-uploads the whole resident mip range, so that's what counts against the upload budget. We stream in as
+			// many mips as fit, but always at least one per frame so the largest mips don't get starved
+			VkDeviceSize remainingUploadBytes = uploadedBytes < CONFIG::TextureStreamingUploadBytesPerFrame ? CONFIG::TextureStreamingUploadBytesPerFrame - uploadedBytes : 0;
+			uint32_t targetMip = streamed.desiredMip;
+			while (targetMip < streamed.residentMip - 1 && CalculateResidentBytes(streamed, targetMip) > remainingUploadBytes)
+			{
+				targetMip++;
+			}
+
+			VkDeviceSize uploadBytes = CalculateResidentBytes(streamed, targetMip);
+			if (uploadedBytes > 0 && uploadBytes > remainingUploadBytes)
+			{
+				break;
+			}
+
+			VkDeviceSize additionalBytes = uploadBytes - CalculateResidentBytes(streamed, streamed.residentMip);
+			if (!EvictForBytes(context, additionalBytes, &streamed))
+			{
+				continue;
+			}
+
+			if (SetResidentMip(context, resource, streamed, targetMip))
+			{
+				uploadedBytes += uploadBytes;
+			}
+		}
+
+		uint64_t uploadValue = context.Submit();
+		for (auto& iter : pendingUploads)
+		{
+			if (iter.second.uploadValue == 0)
+			{
+				iter.second.uploadValue = uploadValue;
+			}
+		}
+	}
+
+	uint64_t TextureStreamer::GetResidencyVersion() const
+	{
+		return residencyVersion;
+	}
+
+	uint64_t TextureStreamer::GetResidencyVersion(const TextureResource* resource) const
+	{
+		auto iter = streamedTextures.find(const_cast<TextureResource*>(resource));
+		if (iter == streamedTextures.end())
+		{
+			return 0;
+		}
+
+		return iter->second.residencyVersion;
+	}
+
+	TextureStreamingStatistics TextureStreamer::GetStatistics() const
+	{
+		TextureStreamingStatistics stats;
+		stats.streamedTextureCount = static_cast<uint32_t>(streamedTextures.size());
+		for (const auto& iter : streamedTextures)
+		{
+			if (iter.second.texture != nullptr)
+			{
+				stats.heldTextureCount++;
+			}
+		}
+		stats.pendingReadCount = static_cast<uint32_t>(pendingReads.size());
+		stats.residentBytes = residentBytes;
+		stats.budgetBytes = CONFIG::TextureStreamingBudget;
+		stats.uploadedBytes = uploadedBytes;
+		stats.evictedMips = evictedMips;
+
+		return stats;
+	}
+
+	bool TextureStreamer::SetResidentMip(UploadContext& context, TextureResource* resource, StreamedTexture& streamed, uint32_t firstMip)
+	{
+		TNG_ASSERT_MSG(firstMip < streamed.mipCount, "Attempting to make a mip resident which the texture doesn't have!");
+
+		uint32_t mipLevels = streamed.mipCount - firstMip;
+		if (streamed.texture != nullptr)
+		{
+			// The mips are stored back-to-back starting with the largest one, so the resident range is a contiguous tail of the data
+			std::vector<uint64_t> mipOffsets(mipLevels);
+			uint64_t baseOffset = streamed.texture->mipOffsets[firstMip];
+			for (uint32_t i = 0; i < mipLevels; i++)
+			{
+				mipOffsets[i] = streamed.texture->mipOffsets[firstMip + i] - baseOffset;
+			}
+
+			const char* data = static_cast<const char*>(streamed.texture->data) + baseOffset;
+			if (!CreateReplacement(context, resource, streamed, firstMip, data, mipOffsets.data()))
+			{
+				return false;
+			}
+		}
+		else if (resource->IsInvalid())
+		{
+			// Without an image there's nothing to draw with in the meantime, so the read can't be deferred
+			Texture cachedMips;
+			if (!SerializerUtils::DeserializeTexture(streamed.cacheName, streamed.format, streamed.contentHash, &cachedMips, firstMip) || cachedMips.GetMipLevels() != mipLevels)
+			{
+				LogWarning("Failed to read mips %u-%u of texture '%s' from it's cache!", firstMip, streamed.mipCount - 1, streamed.cacheName.c_str());
+				return false;
+			}
+
+			if (!CreateReplacement(context, resource, streamed, firstMip, static_cast<const char*>(cachedMips.data), cachedMips.mipOffsets.data()))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			// Copying a large mip chain out of the cache takes a while, so it's done on the thread pool and uploaded once it completes
+			PendingRead read;
+			read.mips = new Texture();
+			read.firstMip = firstMip;
+			read.previousResidentMip = streamed.residentMip;
+
+			Texture* mips = read.mips;
+			std::string cacheName = streamed.cacheName;
+			VkFormat format = streamed.format;
+			uint64_t contentHash = streamed.contentHash;
+			read.future = AsyncAssetLoader::GetInstance().GetThreadPool().Submit([mips, cacheName, format, contentHash, firstMip]()
+			{
+				if (!SerializerUtils::DeserializeTexture(cacheName, format, contentHash, mips, firstMip))
+				{
+					mips->mipOffsets.clear();
+				}
+			});
+
+			pendingReads.insert({ resource, std::move(read) });
+		}
+
+		residentBytes -= CalculateResidentBytes(streamed, streamed.residentMip);
+		residentBytes += CalculateResidentBytes(streamed, firstMip);
+		streamed.residentMip = firstMip;
+
+		return true;
+	}
+
+	bool TextureStreamer::CreateReplacement(UploadContext& context, TextureResource* resource, StreamedTexture& streamed, uint32_t firstMip, const char* data, const uint64_t* mipOffsets)
+	{
+		BaseImageCreateInfo baseImageInfo{};
+		baseImageInfo.width = std::max(streamed.width >> firstMip, 1u);
+		baseImageInfo.height = std::max(streamed.height >> firstMip, 1u);
+		baseImageInfo.format = streamed.format;
+		baseImageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		baseImageInfo.mipLevels = streamed.mipCount - firstMip;
+		baseImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		baseImageInfo.arrayLayers = 1;
+		baseImageInfo.flags = 0;
+		baseImageInfo.generateMipMaps = false;
+
+		ImageViewCreateInfo viewCreateInfo{};
+		viewCreateInfo.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewCreateInfo.viewScope = ImageViewScope::ENTIRE_IMAGE;
+
+		TextureResource* replacement = new TextureResource();
+		replacement->CreateFromMipChain(context, data, mipOffsets, &baseImageInfo, &viewCreateInfo, &streamed.samplerInfo);
+		if (replacement->IsInvalid())
+		{
+			LogWarning("Failed to change the resident mips of texture '%s' to %u-%u!", streamed.cacheName.c_str(), firstMip, streamed.mipCount - 1);
+			delete replacement;
+			return false;
+		}
+
+		if (resource->IsInvalid())
+		{
+			// Nothing is drawing with the resource yet, so the image can be used as is. The asset it belongs to isn't drawn until the
+			// upload completes either
+			resource->Swap(*replacement);
+			delete replacement;
+			streamed.residencyVersion = ++residencyVersion;
+		}
+		else
+		{
+			// The frames keep drawing with the current image until the upload completes
+			pendingUploads.insert({ resource, { replacement, 0 } });
+		}
+
+		return true;
+	}
+
+	void TextureStreamer::ProcessCompletedReads(UploadContext& context)
+	{
+		for (auto iter = pendingReads.begin(); iter != pendingReads.end();)
+		{
+			PendingRead& read = iter->second;
+			if (read.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				++iter;
+				continue;
+			}
+
+			TextureResource* resource = iter->first;
+			StreamedTexture& streamed = streamedTextures.at(resource);
+
+			bool success = read.mips->GetMipLevels() == streamed.mipCount - read.firstMip;
+			if (!success)
+			{
+				LogWarning("Failed to read mips %u-%u of texture '%s' from it's cache!", read.firstMip, streamed.mipCount - 1, streamed.cacheName.c_str());
+			}
+			else
+			{
+				success = CreateReplacement(context, resource, streamed, read.firstMip, static_cast<const char*>(read.mips->data), read.mips->mipOffsets.data());
+			}
+
+			// The current image is kept, so the residency goes back to what it holds
+			if (!success)
+			{
+				residentBytes -= CalculateResidentBytes(streamed, streamed.residentMip);
+				residentBytes += CalculateResidentBytes(streamed, read.previousResidentMip);
+				streamed.residentMip = read.previousResidentMip;
+			}
+
+			delete read.mips;
+			iter = pendingReads.erase(iter);
+		}
+	}
+
+	void TextureStreamer::CancelPendingRead(TextureResource* resource)
+	{
+		auto iter = pendingReads.find(resource);
+		if (iter == pendingReads.end())
+		{
+			return;
+		}
+
+		// The job writes into the texture, so it must have finished before the texture is deleted. If the pool was already destroyed the
+		// future reports a broken promise, which also counts as ready
+		iter->second.future.wait();
+
+		delete iter->second.mips;
+		pendingReads.erase(iter);
+	}
+
+	bool TextureStreamer::IsResidencyChanging(TextureResource* resource) const
+	{
+		return pendingReads.find(resource) != pendingReads.end() || pendingUploads.find(resource) != pendingUploads.end();
+	}
+
+	void TextureStreamer::SwapCompletedUploads()
+	{
+		for (auto iter = pendingUploads.begin(); iter != pendingUploads.end();)
+		{
+			PendingUpload& pending = iter->second;
+			if (pending.uploadValue == 0 || !UploadContext::IsComplete(pending.uploadValue))
+			{
+				++iter;
+				continue;
+			}
+
+			// The replacement now holds the previous image, which the frames in flight might still be using
+			iter->first->Swap(*pending.replacement);
+			if (pending.replacement->IsInvalid())
+			{
+				delete pending.replacement;
+			}
+			else
+			{
+				retiredTextures.push_back({ pending.replacement, frameCounter });
+			}
+
+			residencyVersion++;
+			auto streamedIter = streamedTextures.find(iter->first);
+			if (streamedIter != streamedTextures.end())
+			{
+				streamedIter->second.residencyVersion = residencyVersion;
+			}
+
+			iter = pendingUploads.erase(iter);
+		}
+	}
+
+	void TextureStreamer::CancelPendingUpload(TextureResource* resource)
+	{
+		auto iter = pendingUploads.find(resource);
+		if (iter == pendingUploads.end())
+		{
+			return;
+		}
+
+		UploadContext::Wait(iter->second.uploadValue);
+
+		iter->second.replacement->Destroy();
+		delete iter->second.replacement;
+		pendingUploads.erase(iter);
+	}
+
+	bool TextureStreamer::EvictForBytes(UploadContext& context, VkDeviceSize additionalBytes, const StreamedTexture* requester)
+	{
+		while (residentBytes + additionalBytes > CONFIG::TextureStreamingBudget)
+		{
+			TextureResource* victimResource = nullptr;
+			StreamedTexture* victim = nullptr;
+
+			for (auto& iter : streamedTextures)
+			{
+				StreamedTexture& candidate = iter.second;
+				if (&candidate == requester || candidate.residentMip >= candidate.tailMip || IsResidencyChanging(iter.first))
+				{
+					continue;
+				}
+
+				// Textures that still need their mips may only be evicted in favor of textures that are larger on screen, otherwise two
+				// textures of the same size would keep evicting each other
+				bool isNeeded = candidate.residentMip >= candidate.desiredMip;
+				if (isNeeded && requester != nullptr && candidate.screenSize >= requester->screenSize)
+				{
+					continue;
+				}
+
+				if (victim == nullptr)
+				{
+					victimResource = iter.first;
+					victim = &candidate;
+					continue;
+				}
+
+				// Prefer mips that aren't needed, then the textures that are smallest on screen
+				bool isVictimNeeded = victim->residentMip >= victim->desiredMip;
+				if (isNeeded != isVictimNeeded)
+				{
+					if (!isNeeded)
+					{
+						victimResource = iter.first;
+						victim = &candidate;
+					}
+				}
+				else if (candidate.screenSize < victim->screenSize)
+				{
+					victimResource = iter.first;
+					victim = &candidate;
+				}
+			}
+
+			if (victim == nullptr || !SetResidentMip(context, victimResource, *victim, victim->residentMip + 1))
+			{
+				return false;
+			}
+
+			evictedMips++;
+		}
+
+		return true;
+	}
+
+	uint32_t TextureStreamer::CalculateDesiredMip(const StreamedTexture& streamed) const
+	{
+		if (streamed.screenSize <= 0.0f)
+		{
+			return streamed.tailMip;
+		}
+
+		// One texel per pixel is enough, so every halving of the screen size lets us drop a mip
+		float largestDimension = static_cast<float>(std::max(streamed.width, streamed.height));
+		int32_t mip = static_cast<int32_t>(std::floor(std::log2(largestDimension / streamed.screenSize))) + CONFIG::TextureStreamingMipBias;
+
+		return static_cast<uint32_t>(std::clamp(mip, 0, static_cast<int32_t>(streamed.tailMip)));
+	}
+
+	VkDeviceSize TextureStreamer::CalculateResidentBytes(const StreamedTexture& streamed, uint32_t firstMip)
+	{
+		if (firstMip >= streamed.mipCount)
+		{
+			return 0;
+		}
+
+		return streamed.dataSize - streamed.mipOffsets[firstMip];
+	}
+}
@@ -0,0 +1,179 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "texture_resource.h"
+
+namespace TANG
+{
+	struct Texture;
+
+	struct TextureStreamingStatistics
+	{
+		uint32_t streamedTextureCount = 0;
+		uint32_t heldTextureCount = 0;			// Streamed textures whose decoded data is kept in memory, instead of being read back from the TTEX cache
+		VkDeviceSize residentBytes = 0;			// Bytes taken up by the resident mips of all streamed textures, including the ones that are always resident
+		VkDeviceSize budgetBytes = 0;
+		uint32_t pendingReadCount = 0;			// Residency changes waiting on their mips to be read back from the TTEX cache
+		VkDeviceSize uploadedBytes = 0;			// Bytes uploaded during the last Update()
+		uint32_t evictedMips = 0;				// Mips evicted during the last Update()
+	};
+
+	// Manages the mip residency of material textures. Streamed textures are created with only their smallest mips (see
+	// CONFIG::TextureStreamingResidentMipSize) so assets can be drawn as soon as they're loaded, and the larger mips are uploaded over the
+	// following frames depending on how large the textures are on screen. Once the VRAM budget is exceeded, mips are evicted from
+	// the textures that need them the least.
+	// Changing the residency of a texture recreates it's image with the new mip range. If CONFIG::ReleaseCPUAssetDataAfterUpload is enabled
+	// and the texture has a TTEX cache, the mips are read back from the cache on the asset loader's thread pool, otherwise the streamer holds
+	// a reference to the decoded texture and uploads from it. The new images are uploaded on the transfer queue once their mips are
+	// available, and frames keep drawing with the current image until the upload has completed, so streaming never stalls a frame. The new
+	// image is then swapped into the existing TextureResource so pointers to it stay valid, but the descriptor sets that reference it must be
+	// rewritten, which is what the GetResidencyVersion() functions are for. The old image is destroyed once no frame in flight can be using it anymore.
+	// Must only be used from the render thread
+	class TextureStreamer
+	{
+	private:
+
+		TextureStreamer();
+		~TextureStreamer();
+
+	public:
+
+		// Singletons should not be assignable nor copyable
+		TextureStreamer(const TextureStreamer& other) = delete;
+		void operator=(const TextureStreamer& other) = delete;
+
+		static TextureStreamer& GetInstance()
+		{
+			static TextureStreamer instance;
+			return instance;
+		}
+
+		// Creates a texture resource with only the smallest mips of the texture resident, recording their upload into the context. The texture
+		// must have a full mip chain. The caller owns the returned resource (usually the texture registry), and must call Unregister() before
+		// destroying it
+		TextureResource* CreateStreamedResource(UploadContext& context, const Texture* texture, const SamplerCreateInfo* samplerInfo);
+
+		// Stops streaming the texture resource and releases the streamer's reference to it's decoded texture, if it holds one. Resources
+		// that are not being streamed are ignored
+		void Unregister(TextureResource* resource);
+
+		// Destroys all the retired images and releases every decoded texture the streamer holds on to. The streamed resources themselves are
+		// left to their owners. Must be called after the device is idle, and before the logical device is destroyed
+		void Destroy();
+
+		// Records the size (in pixels) the texture covers on screen this frame. If the texture is drawn several times, the largest size is used.
+		// Resources that are not being streamed are ignored
+		void RequestScreenSize(TextureResource* resource, float screenSize);
+
+		// Swaps in the images whose upload has completed, streams mips in and out based on the screen sizes requested since the last call, and
+		// destroys the images that were retired long enough ago. Every residency change made during the call is uploaded with a single submission
+		// on the transfer queue, and swapped in by a later call once it has completed. Must be called once per frame, after waiting on the frame's
+		// fence and before recording any commands that use the streamed textures
+		void Update();
+
+		// Incremented whenever the image of a streamed texture is replaced. Descriptor sets written with an older version must be rewritten
+		uint64_t GetResidencyVersion() const;
+
+		// Returns the residency version at which the image of the texture was last replaced, so only the descriptor sets that reference
+		// textures newer than the version they were written with need to be rewritten. Zero for resources that are not being streamed
+		uint64_t GetResidencyVersion(const TextureResource* resource) const;
+
+		TextureStreamingStatistics GetStatistics() const;
+
+	private:
+
+		struct StreamedTexture
+		{
+			Texture* texture;					// Null if the mips are read back from the TTEX cache instead
+			std::string cacheName;
+			uint64_t contentHash;
+			VkFormat format;
+			uint32_t width;
+			uint32_t height;
+			std::vector<uint64_t> mipOffsets;	// Offsets of the full mip chain, used to calculate the size of the resident mips
+			uint64_t dataSize;
+			SamplerCreateInfo samplerInfo;
+			uint32_t mipCount;
+			uint32_t tailMip;					// First mip that is always resident
+			uint32_t residentMip;				// First mip that is currently resident
+			uint32_t desiredMip;				// First mip we'd like to be resident, based on the screen size
+			float screenSize;					// Screen size used to calculate the desired mip
+			float requestedScreenSize;			// Largest screen size requested since the last update
+			uint64_t residencyVersion;			// Residency version at which the image was last replaced
+		};
+
+		struct RetiredTexture
+		{
+			TextureResource* resource;
+			uint64_t retiredFrame;
+		};
+
+		struct PendingUpload
+		{
+			TextureResource* replacement;		// Holds the new image until the upload completes and it's swapped into the resource
+			uint64_t uploadValue;				// Zero until the upload has been submitted
+		};
+
+		struct PendingRead
+		{
+			std::future<void> future;
+			Texture* mips;						// Written by the read job, left without data if the read failed
+			uint32_t firstMip;
+			uint32_t previousResidentMip;		// Restored if the read fails
+		};
+
+		// Recreates the resource with the mips from firstMip onwards. If the streamer holds the decoded texture the upload is recorded into the
+		// context right away, otherwise the mips are read back from the TTEX cache on the thread pool first (see ProcessCompletedReads()). The
+		// new image is only swapped in once the upload completes (see SwapCompletedUploads()), unless the resource has no image yet. The
+		// residency is tracked as if the swap already happened. Returns false if the image could not be created, in which case the existing
+		// image is left untouched
+		bool SetResidentMip(UploadContext& context, TextureResource* resource, StreamedTexture& streamed, uint32_t firstMip);
+
+		// Creates the new image from the provided mips and records it's upload into the context. Returns false if the image could not be created
+		bool CreateReplacement(UploadContext& context, TextureResource* resource, StreamedTexture& streamed, uint32_t firstMip, const char* data, const uint64_t* mipOffsets);
+
+		// Records the uploads of the cache reads that have completed. Failed reads roll the residency back to what it was
+		void ProcessCompletedReads(UploadContext& context);
+
+		// Waits for the pending cache read of the resource (if any) and discards it
+		void CancelPendingRead(TextureResource* resource);
+
+		// Whether the residency of the resource is still being changed, either by a cache read or an upload
+		bool IsResidencyChanging(TextureResource* resource) const;
+
+		// Evicts mips from other textures until the additional bytes fit in the budget. Textures that are more resident than they need to be are
+		// evicted first, after that only textures that are smaller on screen than the requester. Returns false if not enough memory could be freed
+		bool EvictForBytes(UploadContext& context, VkDeviceSize additionalBytes, const StreamedTexture* requester);
+
+		// Swaps the replacements whose upload has completed into their resources, and retires the previous images
+		void SwapCompletedUploads();
+
+		// Waits for the pending upload of the resource (if any) and destroys it's replacement without swapping it in
+		void CancelPendingUpload(TextureResource* resource);
+
+		uint32_t CalculateDesiredMip(const StreamedTexture& streamed) const;
+
+		static VkDeviceSize CalculateResidentBytes(const StreamedTexture& streamed, uint32_t firstMip);
+
+		std::unordered_map<TextureResource*, StreamedTexture> streamedTextures;
+		std::vector<RetiredTexture> retiredTextures;
+		std::unordered_map<TextureResource*, PendingUpload> pendingUploads;
+		std::unordered_map<TextureResource*, PendingRead> pendingReads;
+
+		uint64_t frameCounter;
+		uint64_t residencyVersion;
+		VkDeviceSize residentBytes;
+
+		VkDeviceSize uploadedBytes;
+		uint32_t evictedMips;
+	};
+}
+
+#endif
@@ -17,7 +17,7 @@
 
 namespace TANG
 {
-	// This UBO is updated every frame for every different asset, to properly reflect their location. Matches
+	// Written every frame for every drawn asset into the frame's instance buffer, to properly reflect their location. Matches
 	// up with the Transform struct inside asset_types.h
 	struct TransformUBO
 	{
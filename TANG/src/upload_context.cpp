@@ -0,0 +1,277 @@
+
+#include <algorithm>
+#include <cstring> // memcpy
+
+#include "command_pool_registry.h"
+#include "device_cache.h"
+#include "upload_context.h"
+#include "utils/logger.h"
+#include "utils/sanity_check.h"
+
+namespace TANG
+{
+	UploadContext::UploadContext(QueueType _type) : type(_type), ownershipTransferRequired(false), commandBuffer(VK_NULL_HANDLE),
+		graphicsCommandBuffer(VK_NULL_HANDLE), submittedValue(0)
+	{
+		ownershipTransferRequired = (type == QueueType::TRANSFER) && DeviceCache::Get().HasDedicatedTransferQueue();
+	}
+
+	UploadContext::~UploadContext()
+	{
+		Submit();
+	}
+
+	QueueType UploadContext::GetQueueType() const
+	{
+		return type;
+	}
+
+	VkCommandBuffer UploadContext::GetBuffer()
+	{
+		if (commandBuffer == VK_NULL_HANDLE)
+		{
+			commandBuffer = Begin(type);
+		}
+
+		return commandBuffer;
+	}
+
+	VkCommandBuffer UploadContext::GetGraphicsBuffer()
+	{
+		// The graphics commands depend on the transfer, so there's always a transfer command buffer for them to follow
+		VkCommandBuffer transferBuffer = GetBuffer();
+		if (!ownershipTransferRequired)
+		{
+			return transferBuffer;
+		}
+
+		if (graphicsCommandBuffer == VK_NULL_HANDLE)
+		{
+			graphicsCommandBuffer = Begin(QueueType::GRAPHICS);
+		}
+
+		return graphicsCommandBuffer;
+	}
+
+	bool UploadContext::IsOwnershipTransferRequired() const
+	{
+		return ownershipTransferRequired;
+	}
+
+	void UploadContext::ReleaseImage(VkImage image, const VkImageSubresourceRange& range, VkImageLayout newLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = range;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = dstAccess;
+
+		if (!ownershipTransferRequired)
+		{
+			vkCmdPipelineBarrier(GetBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+			return;
+		}
+
+		// The release and acquire must describe the same transfer and layout transition. The release makes the writes available, while
+		// the acquire makes them visible to the destination stages, so each half only gets it's own side of the access masks
+		barrier.srcQueueFamilyIndex = DeviceCache::Get().GetQueueFamilyIndex(QueueType::TRANSFER);
+		barrier.dstQueueFamilyIndex = DeviceCache::Get().GetQueueFamilyIndex(QueueType::GRAPHICS);
+
+		VkImageMemoryBarrier release = barrier;
+		release.dstAccessMask = 0;
+		vkCmdPipelineBarrier(GetBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &release);
+
+		VkImageMemoryBarrier acquire = barrier;
+		acquire.srcAccessMask = 0;
+		vkCmdPipelineBarrier(GetGraphicsBuffer(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStage, 0, 0, nullptr, 0, nullptr, 1, &acquire);
+	}
+
+	void UploadContext::ReleaseBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+	{
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = buffer;
+		barrier.offset = offset;
+		barrier.size = size;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = dstAccess;
+
+		if (!ownershipTransferRequired)
+		{
+			vkCmdPipelineBarrier(GetBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+			return;
+		}
+
+		barrier.srcQueueFamilyIndex = DeviceCache::Get().GetQueueFamilyIndex(QueueType::TRANSFER);
+		barrier.dstQueueFamilyIndex = DeviceCache::Get().GetQueueFamilyIndex(QueueType::GRAPHICS);
+
+		VkBufferMemoryBarrier release = barrier;
+		release.dstAccessMask = 0;
+		vkCmdPipelineBarrier(GetBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &release, 0, nullptr);
+
+		VkBufferMemoryBarrier acquire = barrier;
+		acquire.srcAccessMask = 0;
+		vkCmdPipelineBarrier(GetGraphicsBuffer(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStage, 0, 0, nullptr, 1, &acquire, 0, nullptr);
+	}
+
+	bool UploadContext::Stage(const void* data, VkDeviceSize size, VkDeviceSize alignment, StagingRegion& outRegion)
+	{
+		StagingRing& ring = StagingRing::GetInstance();
+
+		if (GetBuffer() == VK_NULL_HANDLE)
+		{
+			LogError("Attempting to stage data without a command buffer!");
+			return false;
+		}
+
+		if (size > ring.GetCapacity())
+		{
+			LogError("Failed to stage %llu bytes, which is larger than the staging ring! Use StageChunked() instead", size);
+			return false;
+		}
+
+		if (!ring.Allocate(size, alignment, outRegion))
+		{
+			// The rest of the ring is held by the regions we staged so far, so we submit them to make room
+			Submit();
+
+			if (GetBuffer() == VK_NULL_HANDLE || !ring.Allocate(size, alignment, outRegion))
+			{
+				LogError("Failed to allocate %llu bytes from the staging ring!", size);
+				return false;
+			}
+		}
+
+		memcpy(outRegion.mappedData, data, size);
+		return true;
+	}
+
+	bool UploadContext::StageChunked(const void* data, VkDeviceSize size, VkDeviceSize granularity, VkDeviceSize alignment,
+		const std::function<void(VkCommandBuffer commandBuffer, const StagingRegion& region, VkDeviceSize dataOffset)>& recordCopy)
+	{
+		TNG_ASSERT_MSG(granularity > 0, "Staging granularity must be greater than zero!");
+
+		VkDeviceSize maxChunkSize = (StagingRing::GetInstance().GetCapacity() / granularity) * granularity;
+		if (maxChunkSize == 0)
+		{
+			LogError("Failed to stage data, a single chunk of %llu bytes is larger than the staging ring!", granularity);
+			return false;
+		}
+
+		const char* bytes = static_cast<const char*>(data);
+
+		VkDeviceSize dataOffset = 0;
+		while (dataOffset < size)
+		{
+			VkDeviceSize chunkSize = std::min(size - dataOffset, maxChunkSize);
+
+			StagingRegion region;
+			if (!Stage(bytes + dataOffset, chunkSize, alignment, region))
+			{
+				return false;
+			}
+
+			recordCopy(commandBuffer, region, dataOffset);
+			dataOffset += chunkSize;
+		}
+
+		return true;
+	}
+
+	uint64_t UploadContext::Submit()
+	{
+		if (commandBuffer == VK_NULL_HANDLE)
+		{
+			return submittedValue;
+		}
+
+		// The uploads are consumed by later submissions on the graphics queue, which are only ordered after them by an execution and
+		// memory dependency if we insert one. A dedicated transfer queue can't wait on these stages, so it relies on the acquire barriers
+		// recorded by ReleaseImage() / ReleaseBuffer() instead
+		if (!ownershipTransferRequired)
+		{
+			VkMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+				0,
+				1, &barrier,
+				0, nullptr,
+				0, nullptr);
+		}
+
+		// The ring takes ownership of the command buffers, even if the submission fails
+		uint64_t value = StagingRing::GetInstance().Submit(type, commandBuffer, graphicsCommandBuffer);
+		commandBuffer = VK_NULL_HANDLE;
+		graphicsCommandBuffer = VK_NULL_HANDLE;
+
+		if (value != 0)
+		{
+			submittedValue = value;
+		}
+
+		return submittedValue;
+	}
+
+	void UploadContext::SubmitAndWait()
+	{
+		Wait(Submit());
+	}
+
+	uint64_t UploadContext::GetSubmittedValue() const
+	{
+		return submittedValue;
+	}
+
+	bool UploadContext::IsComplete(uint64_t value)
+	{
+		return StagingRing::GetInstance().IsComplete(value);
+	}
+
+	void UploadContext::Wait(uint64_t value)
+	{
+		StagingRing::GetInstance().Wait(value);
+	}
+
+	VkCommandBuffer UploadContext::Begin(QueueType queueType)
+	{
+		VkDevice logicalDevice = GetLogicalDevice();
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = GetCommandPool(queueType);
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer buffer = VK_NULL_HANDLE;
+		if (vkAllocateCommandBuffers(logicalDevice, &allocInfo, &buffer) != VK_SUCCESS)
+		{
+			LogError("Failed to allocate upload context command buffer!");
+			return VK_NULL_HANDLE;
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (vkBeginCommandBuffer(buffer, &beginInfo) != VK_SUCCESS)
+		{
+			LogError("Failed to begin upload context command buffer!");
+			vkFreeCommandBuffers(logicalDevice, GetCommandPool(queueType), 1, &buffer);
+			return VK_NULL_HANDLE;
+		}
+
+		return buffer;
+	}
+}
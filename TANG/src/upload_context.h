@@ -0,0 +1,96 @@
+#ifndef UPLOAD_CONTEXT_H
+#define UPLOAD_CONTEXT_H
+
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+#include "queue_types.h"
+#include "staging_ring.h"
+
+namespace TANG
+{
+	// Records every copy, layout transition and mip generation of one or more uploads into a single command buffer, which is submitted
+	// once through the StagingRing instead of submitting (and waiting for the queue to go idle) per operation like DisposableCommand does.
+	// Host data is copied into the ring as soon as it's staged, so it can be freed right after. If the ring fills up, the commands recorded
+	// so far are submitted so their regions can be reclaimed, and recording continues in a new command buffer. This means GetBuffer() must
+	// be called again after every Stage() call. Every submission gets a timeline value, which callers can check with IsComplete() instead
+	// of waiting. Resources written by a GRAPHICS context are made visible to every later submission on the graphics queue, so they can be
+	// drawn with as soon as the context is submitted.
+	//
+	// A TRANSFER context records on the dedicated transfer queue if the device has one (see DeviceCache::HasDedicatedTransferQueue()), so the
+	// uploads overlap with rendering. Every resource it writes must then be handed over to the graphics queue with ReleaseImage() or
+	// ReleaseBuffer(), and anything that needs the graphics queue (like mip generation) must be recorded into GetGraphicsBuffer(). Those
+	// commands are submitted on the graphics queue once the transfer has completed, so a TRANSFER context's resources can only be used
+	// once IsComplete() returns true for it's submission. Without a dedicated transfer queue both buffers are the same, and the context
+	// behaves like a GRAPHICS context. Must only be used from the render thread
+	class UploadContext
+	{
+	public:
+
+		// The command buffer is only allocated once something is recorded, so creating a context that ends up unused is free
+		explicit UploadContext(QueueType type);
+
+		// Submits anything recorded since the last Submit(), without waiting for it to complete
+		~UploadContext();
+
+		UploadContext(const UploadContext& other) = delete;
+		UploadContext(UploadContext&& other) noexcept = delete;
+		UploadContext& operator=(const UploadContext& other) = delete;
+
+		QueueType GetQueueType() const;
+
+		// Returns the command buffer to record into, beginning a new one if needed
+		VkCommandBuffer GetBuffer();
+
+		// Returns the command buffer to record graphics-only commands into, which runs after everything recorded into GetBuffer() has
+		// completed. This is the same as GetBuffer() unless this is a TRANSFER context recording on a dedicated transfer queue
+		VkCommandBuffer GetGraphicsBuffer();
+
+		// Returns whether resources written by this context must be released to the graphics queue before they're used
+		bool IsOwnershipTransferRequired() const;
+
+		// Makes the transfer writes to the image (which must be in TRANSFER_DST_OPTIMAL layout) available to the provided stages of the graphics
+		// queue, transitioning it to the new layout. If ownership must be transferred, this records the release into GetBuffer() and the
+		// matching acquire into GetGraphicsBuffer(), otherwise it's a regular barrier
+		void ReleaseImage(VkImage image, const VkImageSubresourceRange& range, VkImageLayout newLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+		// Same as above, for a range of a buffer
+		void ReleaseBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+		// Copies the data into a region of the ring, which the caller must then record a copy from. The data must fit in the ring
+		bool Stage(const void* data, VkDeviceSize size, VkDeviceSize alignment, StagingRegion& outRegion);
+
+		// Same as above, but splits the data into chunks if it doesn't fit in the ring. Every chunk is a multiple of the granularity
+		// (for example one row of texels, so images can be copied a few rows at a time), and recordCopy is called once per chunk
+		// with the offset of the chunk into the data
+		bool StageChunked(const void* data, VkDeviceSize size, VkDeviceSize granularity, VkDeviceSize alignment,
+			const std::function<void(VkCommandBuffer commandBuffer, const StagingRegion& region, VkDeviceSize dataOffset)>& recordCopy);
+
+		// Submits everything recorded so far, and returns the timeline value that signals it has completed. The context can keep
+		// recording afterwards. If nothing was recorded since the last submission, the value of that submission is returned instead
+		uint64_t Submit();
+
+		// Submits everything recorded so far, and waits for it to complete
+		void SubmitAndWait();
+
+		// Returns the timeline value of the most recent submission of this context, or zero if nothing was submitted yet
+		uint64_t GetSubmittedValue() const;
+
+		static bool IsComplete(uint64_t value);
+		static void Wait(uint64_t value);
+
+	private:
+
+		// Allocates and begins a command buffer from the queue's command pool
+		static VkCommandBuffer Begin(QueueType queueType);
+
+		QueueType type;
+		bool ownershipTransferRequired;
+		VkCommandBuffer commandBuffer;
+		VkCommandBuffer graphicsCommandBuffer;	// Only used if ownership must be transferred
+		uint64_t submittedValue;
+	};
+}
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "sanity_check.h"
 #include "logger.h"
+#include "mapped_file.h"
 
 namespace TANG
 {
@@ -119,4 +120,34 @@ namespace TANG
 
 		return checksum;
 	}
+
+	uint64_t ContentHash(const void* data, uint64_t size, uint64_t seed)
+	{
+		static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+		static constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+		uint64_t hash = (seed == 0) ? FNV_OFFSET_BASIS : seed;
+		for (uint64_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= FNV_PRIME;
+		}
+
+		// Zero is reserved for failures
+		return hash == 0 ? 1 : hash;
+	}
+
+	uint64_t FileContentHash(const std::string_view& fileName)
+	{
+		MappedFile file;
+		if (!file.Open(fileName))
+		{
+			LogError("Failed to hash contents of file '%s'!", fileName.data());
+			return 0;
+		}
+
+		return ContentHash(file.GetData(), file.GetSize(), 0);
+	}
 }
\ No newline at end of file
@@ -23,4 +23,12 @@ namespace TANG
 	void AppendToFile(const std::string_view& fileName, const std::string_view& msg);
 
 	uint32_t FileChecksum(const std::string_view& fileName);
+
+	// Returns a 64-bit FNV-1a hash of the file contents, which is suitable for identifying files by content. The file
+	// is memory-mapped rather than read into a temporary buffer. Returns 0 if the file could not be read
+	uint64_t FileContentHash(const std::string_view& fileName);
+
+	// Returns a 64-bit FNV-1a hash of the data. Several buffers can be hashed as one by passing the previous hash as the seed,
+	// while a seed of zero starts a new hash. Never returns 0
+	uint64_t ContentHash(const void* data, uint64_t size, uint64_t seed = 0);
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+
+#include <string>
+
+#if defined(TNG_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "logger.h"
+#include "mapped_file.h"
+
+namespace TANG
+{
+#if defined(TNG_WINDOWS)
+	MappedFile::MappedFile() : fileHandle(nullptr), mappingHandle(nullptr), data(nullptr), size(0)
+	{
+	}
+#else
+	MappedFile::MappedFile() : fileDescriptor(-1), data(nullptr), size(0)
+	{
+	}
+#endif
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(std::string_view fileName)
+	{
+		if (IsOpen())
+		{
+			LogWarning("Attempting to open mapped file '%s' while another file is still mapped! Closing previous mapping", fileName.data());
+			Close();
+		}
+
+		std::string fileNameStr(fileName);
+
+#if defined(TNG_WINDOWS)
+		HANDLE file = CreateFileA(fileNameStr.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			LogError("Failed to create file mapping for '%s'!", fileNameStr.c_str());
+			CloseHandle(file);
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr)
+		{
+			LogError("Failed to map view of file '%s'!", fileNameStr.c_str());
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		fileHandle = file;
+		mappingHandle = mapping;
+		data = static_cast<const char*>(view);
+		size = static_cast<uint64_t>(fileSize.QuadPart);
+#else
+		int fd = open(fileNameStr.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			close(fd);
+			return false;
+		}
+
+		void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view == MAP_FAILED)
+		{
+			LogError("Failed to map file '%s'!", fileNameStr.c_str());
+			close(fd);
+			return false;
+		}
+
+		fileDescriptor = fd;
+		data = static_cast<const char*>(view);
+		size = static_cast<uint64_t>(fileStat.st_size);
+#endif
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (!IsOpen())
+		{
+			return;
+		}
+
+#if defined(TNG_WINDOWS)
+		UnmapViewOfFile(data);
+		CloseHandle(static_cast<HANDLE>(mappingHandle));
+		CloseHandle(static_cast<HANDLE>(fileHandle));
+
+		mappingHandle = nullptr;
+		fileHandle = nullptr;
+#else
+		munmap(const_cast<char*>(data), static_cast<size_t>(size));
+		close(fileDescriptor);
+
+		fileDescriptor = -1;
+#endif
+
+		data = nullptr;
+		size = 0;
+	}
+
+	bool MappedFile::IsOpen() const
+	{
+		return data != nullptr;
+	}
+
+	const char* MappedFile::GetData() const
+	{
+		return data;
+	}
+
+	uint64_t MappedFile::GetSize() const
+	{
+		return size;
+	}
+}
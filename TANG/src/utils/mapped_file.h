@@ -0,0 +1,43 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string_view>
+
+namespace TANG
+{
+	// Read-only memory mapping of a file on disk. The file contents are paged in by the OS on demand, so
+	// reading from the mapped view is bound by the size of the data we actually touch rather than by
+	// any parsing we'd otherwise have to do. The mapping is released on Close() or on destruction
+	class MappedFile
+	{
+	public:
+
+		MappedFile();
+		~MappedFile();
+
+		// The mapping owns OS handles, so we disallow copies
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+
+		// Maps the entire file into memory. Returns false if the file does not exist, is empty or could not be mapped
+		bool Open(std::string_view fileName);
+		void Close();
+
+		bool IsOpen() const;
+		const char* GetData() const;
+		uint64_t GetSize() const;
+
+	private:
+
+#if defined(TNG_WINDOWS)
+		void* fileHandle;
+		void* mappingHandle;
+#else
+		int fileDescriptor;
+#endif
+		const char* data;
+		uint64_t size;
+	};
+}
+
+#endif
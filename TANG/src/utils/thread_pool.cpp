@@ -0,0 +1,145 @@
+
+#include <algorithm>
+
+#include "logger.h"
+#include "thread_pool.h"
+
+namespace TANG
+{
+	ThreadPool::ThreadPool() : nextJobGroup(NO_JOB_GROUP + 1), isShuttingDown(false)
+	{
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		Destroy();
+	}
+
+	void ThreadPool::Create(uint32_t threadCount)
+	{
+		if (!workers.empty())
+		{
+			LogWarning("Attempting to create thread pool more than once!");
+			return;
+		}
+
+		if (threadCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			threadCount = std::max(hardwareThreads, 2u) - 1;
+		}
+
+		isShuttingDown = false;
+
+		workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			workers.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+
+	void ThreadPool::Destroy()
+	{
+		{
+			std::lock_guard<std::mutex> lock(jobsMutex);
+			isShuttingDown = true;
+			jobs.clear();
+		}
+
+		jobsCondition.notify_all();
+
+		for (std::thread& worker : workers)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+
+		workers.clear();
+	}
+
+	ThreadPool::JobGroup ThreadPool::CreateJobGroup()
+	{
+		return nextJobGroup++;
+	}
+
+	std::future<void> ThreadPool::Submit(Job job, JobGroup group)
+	{
+		std::packaged_task<void()> task(std::move(job));
+		std::future<void> future = task.get_future();
+
+		// Without any workers the job would never run, so we run it immediately on the calling thread instead
+		if (workers.empty())
+		{
+			task();
+			return future;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(jobsMutex);
+			jobs.push_back({ std::move(task), group });
+		}
+
+		jobsCondition.notify_one();
+		return future;
+	}
+
+	void ThreadPool::Wait(std::future<void>& future, JobGroup group)
+	{
+		// Once the group has no pending jobs left, the remaining ones are already running on other threads, so blocking can't deadlock
+		while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			if (group == NO_JOB_GROUP || !RunPendingJob(group))
+			{
+				future.wait();
+			}
+		}
+	}
+
+	bool ThreadPool::RunPendingJob(JobGroup group)
+	{
+		std::packaged_task<void()> task;
+		{
+			std::lock_guard<std::mutex> lock(jobsMutex);
+			auto iter = std::find_if(jobs.begin(), jobs.end(), [group](const PendingJob& job) { return job.group == group; });
+			if (iter == jobs.end())
+			{
+				return false;
+			}
+
+			task = std::move(iter->task);
+			jobs.erase(iter);
+		}
+
+		task();
+		return true;
+	}
+
+	uint32_t ThreadPool::GetThreadCount() const
+	{
+		return static_cast<uint32_t>(workers.size());
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			std::packaged_task<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(jobsMutex);
+				jobsCondition.wait(lock, [this]() { return isShuttingDown || !jobs.empty(); });
+
+				if (isShuttingDown)
+				{
+					return;
+				}
+
+				task = std::move(jobs.front().task);
+				jobs.pop_front();
+			}
+
+			task();
+		}
+	}
+}
@@ -0,0 +1,77 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TANG
+{
+	// Simple fixed-size pool of worker threads that execute jobs in FIFO order. Submitting a job returns a future
+	// which can be waited on through Wait(). Jobs can be tagged with a group from CreateJobGroup(), and a thread
+	// waiting on a group will execute that group's pending jobs itself rather than blocking, so it's safe for a job
+	// to submit more jobs to the same pool and wait on them. Jobs from other groups are never picked up while
+	// waiting, so a wait can't end up stuck behind some unrelated long-running job
+	class ThreadPool
+	{
+	public:
+
+		using Job = std::function<void()>;
+		using JobGroup = uint64_t;
+
+		static constexpr JobGroup NO_JOB_GROUP = 0;
+
+		ThreadPool();
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool& other) = delete;
+		ThreadPool& operator=(const ThreadPool& other) = delete;
+
+		// Spawns the worker threads. A thread count of zero will use one thread per hardware thread,
+		// minus one to leave room for the main thread
+		void Create(uint32_t threadCount = 0);
+
+		// Discards any jobs that have not started yet and joins all the worker threads. Futures of discarded
+		// jobs will report a broken promise
+		void Destroy();
+
+		// Returns a new group that jobs which are waited on together can be submitted under
+		JobGroup CreateJobGroup();
+
+		std::future<void> Submit(Job job, JobGroup group = NO_JOB_GROUP);
+
+		// Waits for the provided future to become ready, executing pending jobs of the provided group in the meantime.
+		// Without a group, the calling thread simply blocks
+		void Wait(std::future<void>& future, JobGroup group = NO_JOB_GROUP);
+
+		// Pops the oldest job of the provided group from the queue and executes it on the calling thread. Returns false
+		// if the group has no pending jobs
+		bool RunPendingJob(JobGroup group);
+
+		uint32_t GetThreadCount() const;
+
+	private:
+
+		void WorkerLoop();
+
+		std::vector<std::thread> workers;
+		struct PendingJob
+		{
+			std::packaged_task<void()> task;
+			JobGroup group;
+		};
+
+		std::deque<PendingJob> jobs;
+		std::atomic<JobGroup> nextJobGroup;
+		std::mutex jobsMutex;
+		std::condition_variable jobsCondition;
+		bool isShuttingDown;
+	};
+}
+
+#endif
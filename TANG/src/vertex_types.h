@@ -294,6 +294,113 @@ namespace TANG
 		glm::vec2 uv;
 	};
 
+	// Compact version of PBRVertex, used by the PBR pipeline to reduce vertex fetch bandwidth (24 bytes instead of 56).
+	// The normal and tangent are octahedral-encoded into two SNORM16 components each, and the bitangent is reconstructed
+	// in the vertex shader as cross(normal, tangent) * sign. The sign is folded into the tangent's Y component: the
+	// encoded Y is remapped from [-1, 1] to (0, 1] and then multiplied by the sign, so a negative value means a flipped
+	// bitangent. The UVs are stored as half-floats since they are allowed to go outside [0, 1] for tiling textures.
+	// All the packed attributes are stored as uint32_t to keep the struct trivially comparable, see asset_loader.cpp for the encoding
+	struct PackedPBRVertex : public VertexType
+	{
+		static const VkVertexInputBindingDescription& GetBindingDescription()
+		{
+			static VkVertexInputBindingDescription bindingDesc{};
+			bindingDesc.binding = 0;
+			bindingDesc.stride = sizeof(TANG::PackedPBRVertex);
+			bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+			return bindingDesc;
+		}
+
+		static const std::vector<VkVertexInputAttributeDescription>& GetAttributeDescriptions()
+		{
+			TNG_ASSERT_COMPILE(sizeof(PackedPBRVertex) == 24);
+
+			static std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+			if (attributeDescriptions.size() != 0)
+			{
+				return attributeDescriptions;
+			}
+
+			attributeDescriptions.reserve(4);
+
+			// POSITION
+			VkVertexInputAttributeDescription position;
+			position.binding = 0;
+			position.location = 0;
+			position.format = VK_FORMAT_R32G32B32_SFLOAT; // vec3 (12 bytes)
+			position.offset = offsetof(PackedPBRVertex, pos);
+			attributeDescriptions.push_back(position);
+
+			// NORMAL (octahedral)
+			VkVertexInputAttributeDescription normal;
+			normal.binding = 0;
+			normal.location = 1;
+			normal.format = VK_FORMAT_R16G16_SNORM; // vec2 (4 bytes)
+			normal.offset = offsetof(PackedPBRVertex, normal);
+			attributeDescriptions.push_back(normal);
+
+			// TANGENT (octahedral + bitangent sign)
+			VkVertexInputAttributeDescription tangent;
+			tangent.binding = 0;
+			tangent.location = 2;
+			tangent.format = VK_FORMAT_R16G16_SNORM; // vec2 (4 bytes)
+			tangent.offset = offsetof(PackedPBRVertex, tangent);
+			attributeDescriptions.push_back(tangent);
+
+			// UV
+			VkVertexInputAttributeDescription uv;
+			uv.binding = 0;
+			uv.location = 3;
+			uv.format = VK_FORMAT_R16G16_SFLOAT; // vec2 (4 bytes)
+			uv.offset = offsetof(PackedPBRVertex, uv);
+			attributeDescriptions.push_back(uv);
+
+			return attributeDescriptions;
+		}
+
+		PackedPBRVertex() : pos(0.0f, 0.0f, 0.0f), normal(0), tangent(0), uv(0)
+		{ }
+
+		~PackedPBRVertex()
+		{ }
+
+		PackedPBRVertex(const PackedPBRVertex& other) : pos(other.pos), normal(other.normal), tangent(other.tangent), uv(other.uv)
+		{ }
+
+		PackedPBRVertex(PackedPBRVertex&& other) noexcept : pos(std::move(other.pos)), normal(other.normal), tangent(other.tangent), uv(other.uv)
+		{ }
+
+		PackedPBRVertex& operator=(const PackedPBRVertex& other)
+		{
+			if (this == &other)
+			{
+				return *this;
+			}
+
+			pos = other.pos;
+			normal = other.normal;
+			tangent = other.tangent;
+			uv = other.uv;
+
+			return *this;
+		}
+
+		// Utility functions / operator overloads
+		bool operator==(const PackedPBRVertex& other) const
+		{
+			return pos == other.pos &&
+				normal == other.normal &&
+				tangent == other.tangent &&
+				uv == other.uv;
+		}
+
+		glm::vec3 pos;
+		uint32_t normal;
+		uint32_t tangent;
+		uint32_t uv;
+	};
+
 }
 
 #endif
\ No newline at end of file